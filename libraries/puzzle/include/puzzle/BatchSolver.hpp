@@ -0,0 +1,68 @@
+#ifndef PUZZLE_BATCH_SOLVER_HPP
+#define PUZZLE_BATCH_SOLVER_HPP
+
+#include <functional>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "puzzle/Corpus.hpp"
+#include "puzzle/Solver.hpp"
+
+// Solves a stream of boards on a pool of worker threads.
+class BatchSolver {
+public:
+    using Solution = decltype(Solver::solve(std::declval<const Board&>()));
+
+    enum class Order {
+        input,       // results are reported in the order the boards were read
+        completion,  // results are reported as soon as they are ready
+    };
+
+    // What becomes of a board `Solver::estimate` predicts to expand more boards than the node
+    // budget of `Options::solve` allows.
+    enum class OverBudget {
+        attempt,      // it is searched all the same
+        refuse,       // it is reported as out of budget without a search
+        approximate,  // it is solved by `Solver::approximate`, not always optimally
+    };
+
+    struct Options {
+        // Worker threads, zero meaning one per hardware thread.
+        unsigned threads = 0;
+        Order order      = Order::input;
+        // Maximum number of boards read ahead of the oldest unreported one. In input order this
+        // bounds the results held back behind a slow board.
+        std::size_t window = 4096;
+        // Records a worker takes from a corpus at a time; the window may be exceeded by up to this.
+        std::size_t chunk = 256;
+        SolveOptions solve;
+        OverBudget over_budget = OverBudget::attempt;
+        // `solve()` of a span starts the boards `Solver::estimate` predicts to take longest first,
+        // so that no long search starts last while the other workers run out of boards.
+        bool longest_first = false;
+    };
+
+    // Next board of the input, or nothing at its end. Never called concurrently.
+    using Source = std::function<std::optional<Board>()>;
+    // Receives every board with its position in the input. Never called concurrently.
+    using Sink = std::function<void(std::size_t index, const Board& board, const Solution& solution)>;
+
+    static void run(const Source& source, const Sink& sink, const Options& options) noexcept;
+    // Streams the remaining records of a corpus in chunks that the workers decode themselves.
+    static void run(CorpusReader& input, const Sink& sink, const Options& options) noexcept;
+
+    static std::vector<Solution> solve(std::span<const Board> boards, const Options& options) noexcept;
+
+    // Solves every board of `input` and writes the boards with their solutions to `output`, which
+    // must have solutions and the same side. Boards that fail validation are skipped. Returns the
+    // number of records written, or nothing on a layout mismatch or write error.
+    static std::optional<std::size_t> solve(CorpusReader& input, CorpusWriter& output,
+                                            const Options& options) noexcept;
+
+    // The record for a board and its solution; invalid boards are reported as unsolvable.
+    static CorpusRecord record(const Board& board, const Solution& solution) noexcept;
+};
+
+#endif  // PUZZLE_BATCH_SOLVER_HPP
@@ -1,16 +1,32 @@
 #ifndef PUZZLE_BOARD_HPP
 #define PUZZLE_BOARD_HPP
 
+#include <cstdint>
+#include <optional>
 #include <random>
 #include <string>
 #include <vector>
 #include <span>
 
+// Direction in which the blank moves.
+enum class Move : uint8_t { up, down, left, right };
+
+constexpr Move opposite(Move move) noexcept {
+    return static_cast<Move>(static_cast<uint8_t>(move) ^ 1);
+}
+
+// The same move seen on the transposed board: up <-> left, down <-> right.
+constexpr Move transposed(Move move) noexcept {
+    return static_cast<Move>(static_cast<uint8_t>(move) ^ 2);
+}
+
 class Board {
 public:
     Board() noexcept;
     explicit Board(const std::vector<std::vector<uint16_t>>& input) noexcept;
     explicit Board(const std::vector<std::vector<unsigned>>& input) noexcept;
+    // Builds a `side` x `side` board from its tiles in row-major order.
+    Board(std::size_t side, std::span<const uint16_t> tiles) noexcept;
 
     static Board create_goal(unsigned size) noexcept;
     static Board create_random(unsigned size) noexcept;
@@ -18,14 +34,48 @@ public:
     [[nodiscard]] std::size_t size() const noexcept;
     [[nodiscard]] bool is_goal() const noexcept;
     [[nodiscard]] bool is_solvable() const noexcept;
+    // Checks that the tiles are exactly 0..N^2-1, each appearing once.
+    [[nodiscard]] bool validate() const noexcept;
+
+    static std::vector<bool> is_solvable(std::span<const Board> boards) noexcept;
+    static std::vector<bool> validate(std::span<const Board> boards) noexcept;
 
     [[nodiscard]] unsigned hamming() const noexcept;
     [[nodiscard]] unsigned manhattan() const noexcept;
     [[nodiscard]] std::string to_string() const noexcept;
     [[nodiscard]] std::size_t hash() const noexcept;
 
+    // Scores many boards of the same size at once, `out[i] = boards[i].manhattan()`.
+    // Small boards are evaluated several at a time by the vector kernels.
+    static void manhattan(std::span<const Board> boards, std::span<unsigned> out) noexcept;
+
+    // Board after moving the blank, or nothing if the move leaves the board.
+    [[nodiscard]] std::optional<Board> moved(Move move) const noexcept;
+    // Move that turns this board into `next`, if they are one move apart.
+    [[nodiscard]] std::optional<Move> move_to(const Board& next) const noexcept;
+    [[nodiscard]] std::size_t blank() const noexcept;
+
+    // Reflection across the main diagonal with the tiles relabeled so that the goal maps onto
+    // itself. A board and its transpose have the same optimal distance; a solution of one becomes
+    // a solution of the other by transposing every move.
+    [[nodiscard]] Board transposed() const noexcept;
+    // Same for the row-major tiles of a `side` x `side` board, written to `out`.
+    static void transposed(std::size_t side, std::span<const uint16_t> tiles, std::span<uint16_t> out) noexcept;
+
+    // Lexicographic rank of the tile permutation among all N^2! permutations. Only boards of
+    // side <= 4 have a rank that fits into 64 bits.
+    static constexpr std::size_t max_ranked_size = 4;
+    [[nodiscard]] uint64_t rank() const noexcept;
+    // Same for row-major tiles of a square board.
+    static uint64_t rank(std::span<const uint16_t> tiles) noexcept;
+    static Board unrank(unsigned size, uint64_t rank) noexcept;
+    // Writes the tiles of the board with the given rank to `tiles`, which holds size^2 cells.
+    static void unrank(unsigned size, uint64_t rank, std::span<uint16_t> tiles) noexcept;
+
     std::span<const uint16_t> operator[](unsigned index) const noexcept;
     [[nodiscard]] std::vector<std::vector<uint16_t>> get_board() const noexcept;
+    // Row-major view of all tiles.
+    [[nodiscard]] std::span<const uint16_t> tiles() const noexcept;
 
     friend bool operator==(const Board& left, const Board& right) noexcept;
     friend bool operator!=(const Board& left, const Board& right) noexcept;
@@ -33,9 +83,14 @@ public:
     friend std::ostream& operator<<(std::ostream& out, const Board& board) noexcept;
 
 private:
-    [[nodiscard]] unsigned distance(unsigned i, unsigned j, unsigned value) const noexcept;
+    friend class Generator;
+    friend class CorpusChunk;
+
+    // Parity of the tile permutation, or nothing if the tiles are not a permutation.
+    [[nodiscard]] std::optional<bool> odd_permutation() const noexcept;
 
-    std::vector<std::vector<uint16_t>> data;
+    std::size_t side = 0;
+    std::vector<uint16_t> data;
 };
 
 #endif  // PUZZLE_BOARD_HPP
@@ -0,0 +1,135 @@
+#ifndef PUZZLE_CORPUS_HPP
+#define PUZZLE_CORPUS_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "puzzle/Board.hpp"
+
+// Binary files of boards of one size, optionally with their solutions.
+//
+// A 32-byte header (magic "PZLC", version, side, board encoding, flags, bytes per board) is followed
+// by the records. Boards up to 4x4 are stored as their permutation rank (6 bytes for 4x4), larger
+// ones as bit-packed tiles. A solution follows its board as a 32-bit move count, or a status code
+// for boards without one, and the moves at 2 bits each. All integers are little-endian.
+//
+// Files without solutions have fixed-size records and support random access.
+struct CorpusRecord {
+    enum class Status : uint8_t { solved, unsolvable, budget };
+
+    Board board;
+    Status status = Status::solved;
+    std::vector<Move> moves;
+};
+
+// A run of whole records of a corpus file. Chunks decode straight from the mapped file and
+// independently of the reader and of each other, so every worker thread can take its own.
+class CorpusChunk {
+public:
+    // Position of the first record in the file and number of records.
+    [[nodiscard]] std::size_t first() const noexcept;
+    [[nodiscard]] std::size_t size() const noexcept;
+
+    // Decodes the next record into `record`, reusing its storage. False after the last one.
+    bool next(CorpusRecord& record) noexcept;
+
+private:
+    friend class CorpusReader;
+
+    struct Layout {
+        unsigned side           = 0;
+        uint8_t encoding        = 0;
+        uint8_t flags           = 0;
+        std::size_t board_bytes = 0;
+    };
+
+    static void decode(const uint8_t* bytes, const Layout& layout, Board& board) noexcept;
+
+    const uint8_t* data     = nullptr;
+    std::size_t position    = 0;
+    std::size_t first_index = 0;
+    std::size_t records     = 0;
+    std::size_t remaining   = 0;
+    Layout layout;
+};
+
+class CorpusReader {
+public:
+    // Maps `path` into memory; nothing if it cannot be opened or is not a corpus file.
+    static std::optional<CorpusReader> open(const std::string& path) noexcept;
+    // Checks for the magic number without opening the file as a corpus.
+    static bool is_corpus(const std::string& path) noexcept;
+
+    CorpusReader(CorpusReader&& other) noexcept;
+    CorpusReader& operator=(CorpusReader&& other) noexcept;
+    CorpusReader(const CorpusReader&)            = delete;
+    CorpusReader& operator=(const CorpusReader&) = delete;
+    ~CorpusReader();
+
+    [[nodiscard]] unsigned side() const noexcept;
+    [[nodiscard]] bool has_solutions() const noexcept;
+
+    // Number of boards and random access, for files without solutions.
+    [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] Board board(std::size_t index) const noexcept;
+
+    // Splits off up to `records` records following the previous chunk or record. Only the record
+    // headers are read here; the pages ahead are prefetched for the threads decoding the chunks.
+    // Nothing at the end of the file or on a truncated record. The chunk is valid as long as the
+    // reader is.
+    std::optional<CorpusChunk> next_chunk(std::size_t records) noexcept;
+
+    // Reads the next record into `record`, reusing its storage. False at the end of the file or
+    // on a truncated record.
+    bool next(CorpusRecord& record) noexcept;
+    void rewind() noexcept;
+
+private:
+    CorpusReader() noexcept = default;
+
+    const uint8_t* mapping = nullptr;
+    std::size_t length     = 0;
+    std::size_t position   = 0;
+    std::size_t index      = 0;
+    // End of the range already handed to madvise(MADV_WILLNEED).
+    std::size_t advised = 0;
+    CorpusChunk::Layout layout;
+};
+
+class CorpusWriter {
+public:
+    // Creates `path` for boards of the given side, at least 2. With `append`, an existing file
+    // with the same layout is extended instead of truncated.
+    static std::optional<CorpusWriter> open(const std::string& path, unsigned side, bool with_solutions,
+                                            bool append = false) noexcept;
+
+    CorpusWriter(CorpusWriter&& other) noexcept;
+    CorpusWriter& operator=(CorpusWriter&& other) noexcept;
+    CorpusWriter(const CorpusWriter&)            = delete;
+    CorpusWriter& operator=(const CorpusWriter&) = delete;
+    ~CorpusWriter();
+
+    [[nodiscard]] unsigned side() const noexcept;
+    [[nodiscard]] bool has_solutions() const noexcept;
+
+    // False if the board does not match the file (wrong size, not a valid board) or on I/O errors.
+    // A bare board can only be written to a file without solutions.
+    bool write(const Board& board) noexcept;
+    bool write(const CorpusRecord& record) noexcept;
+    bool flush() noexcept;
+
+private:
+    CorpusWriter() noexcept = default;
+
+    std::FILE* file         = nullptr;
+    unsigned board_side     = 0;
+    uint8_t encoding        = 0;
+    uint8_t flags           = 0;
+    std::size_t board_bytes = 0;
+    std::vector<uint8_t> buffer;
+};
+
+#endif  // PUZZLE_CORPUS_HPP
@@ -0,0 +1,49 @@
+#ifndef PUZZLE_DISTANCE_TABLE_HPP
+#define PUZZLE_DISTANCE_TABLE_HPP
+
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "puzzle/Board.hpp"
+#include "puzzle/TableFile.hpp"
+
+// Exact distance to the goal of every board of one size, a byte per permutation rank. With it a
+// board is solved by stepping to a neighbour one move closer until the goal, without search.
+// Sizes up to 3 only: the 3x3 table holds 9! bytes, a 4x4 one would need 16!.
+class DistanceTable {
+public:
+    static constexpr uint32_t kind        = TableFile::tag('D', 'I', 'S', 'T');
+    static constexpr std::size_t max_size = 3;
+    static constexpr uint8_t unsolvable   = 0xFF;
+
+    // Breadth-first search backwards from the goal; nothing for sizes outside 2..max_size.
+    static std::optional<DistanceTable> build(unsigned size) noexcept;
+
+    // Maps a table saved by `save()`; nothing if the file is missing or damaged.
+    static std::optional<DistanceTable> load(const std::string& path, const TableFile::MapOptions& options) noexcept;
+    static std::optional<DistanceTable> load(const std::string& path) noexcept;
+    // Loads `path`, or builds the table and saves it there when it cannot be loaded.
+    static std::optional<DistanceTable> load_or_build(const std::string& path, unsigned size) noexcept;
+    bool save(const std::string& path) const noexcept;
+
+    [[nodiscard]] unsigned size() const noexcept;
+    [[nodiscard]] bool supports(const Board& board) const noexcept;
+
+    // Nothing for unsolvable boards and boards of another size.
+    [[nodiscard]] std::optional<unsigned> distance(const Board& board) const noexcept;
+    // An optimal solution from `board` to the goal, empty when there is none.
+    [[nodiscard]] std::vector<Board> path(const Board& board) const noexcept;
+
+private:
+    DistanceTable() noexcept = default;
+
+    unsigned side = 0;
+    // The distances live in `owned` for a built table and in `file` for a loaded one.
+    std::vector<uint8_t> owned;
+    std::optional<TableFile> file;
+    std::span<const uint8_t> distances;
+};
+
+#endif  // PUZZLE_DISTANCE_TABLE_HPP
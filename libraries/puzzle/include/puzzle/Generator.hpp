@@ -0,0 +1,57 @@
+#ifndef PUZZLE_GENERATOR_HPP
+#define PUZZLE_GENERATOR_HPP
+
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "puzzle/Board.hpp"
+
+// Seeded board generator. The same seed produces the same sequence of boards on every platform,
+// since only the fully specified `std::mt19937_64` output is used.
+class Generator {
+public:
+    explicit Generator(uint64_t seed) noexcept;
+
+    // Generator of the calling thread, seeded from `std::random_device` on first use.
+    static Generator& local() noexcept;
+
+    void seed(uint64_t seed) noexcept;
+
+    // Uniformly random solvable board. An unsolvable shuffle is fixed by swapping two tiles
+    // instead of being rejected, which keeps the distribution uniform.
+    [[nodiscard]] Board solvable(unsigned size) noexcept;
+
+    // Board reached from the goal by `moves` random moves that never undo the previous one.
+    [[nodiscard]] Board walk(unsigned size, unsigned moves) noexcept;
+
+    // Random walk board whose optimal solution takes at least `depth` moves (its Manhattan
+    // distance is at least `depth`). Nothing if such a board is not found in a bounded walk.
+    [[nodiscard]] std::optional<Board> at_least(unsigned size, unsigned depth) noexcept;
+
+    // Random walk board whose optimal solution takes exactly `depth` moves, checked with the solver.
+    // Intended for boards the solver handles quickly; gives up after `attempts` candidates.
+    [[nodiscard]] std::optional<Board> exact(unsigned size, unsigned depth, unsigned attempts = 64) noexcept;
+
+    // Fills `out` with uniformly random solvable boards, reusing their storage when possible.
+    void fill(unsigned size, std::span<Board> out) noexcept;
+    // Same, as consecutive row-major tile arrays: `tiles.size() / (size * size)` boards.
+    void fill(unsigned size, std::span<uint16_t> tiles) noexcept;
+
+private:
+    [[nodiscard]] uint64_t below(uint64_t bound) noexcept;
+    void shuffle_solvable(unsigned size, std::span<uint16_t> tiles) noexcept;
+    // `reset` puts the goal into the walk buffer; `step` makes one random move in it and returns
+    // the change of the Manhattan distance.
+    void reset(unsigned size) noexcept;
+    int step(unsigned size) noexcept;
+
+    std::mt19937_64 engine;
+    std::vector<uint16_t> buffer;
+    std::size_t blank  = 0;
+    unsigned last_move = 4;
+};
+
+#endif  // PUZZLE_GENERATOR_HPP
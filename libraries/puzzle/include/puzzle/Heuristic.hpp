@@ -0,0 +1,113 @@
+#ifndef PUZZLE_HEURISTIC_HPP
+#define PUZZLE_HEURISTIC_HPP
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <tuple>
+#include <variant>
+
+#include "puzzle/Board.hpp"
+#include "puzzle/PatternDatabase.hpp"
+
+// A heuristic estimates the number of moves left to the goal and follows one board through a
+// search: `init` evaluates a board from scratch, `update` catches up after the blank of the
+// previous board moved by `move` and gave `board`, and `value` is the current estimate. Search
+// engines take the heuristic as a template parameter and copy it along with every node.
+//
+// All heuristics here are admissible, and so is the maximum of any of them.
+template <typename H>
+concept Heuristic = std::copyable<H> && requires(H heuristic, const H& constant, const Board& board, Move move) {
+    heuristic.init(board);
+    heuristic.update(board, move);
+    { constant.value() } -> std::convertible_to<unsigned>;
+};
+
+// Sum of the distances of the tiles from their goal cells.
+class ManhattanHeuristic {
+public:
+    void init(const Board& board) noexcept;
+    void update(const Board& board, Move move) noexcept;
+    [[nodiscard]] unsigned value() const noexcept;
+
+private:
+    unsigned distance = 0;
+};
+
+// Manhattan distance plus two moves for every tile that has to leave its goal row or column to
+// let other tiles of that line pass it.
+class LinearConflictHeuristic {
+public:
+    // Lines of larger boards are taken to have no conflicts.
+    static constexpr std::size_t max_size = 16;
+
+    void init(const Board& board) noexcept;
+    void update(const Board& board, Move move) noexcept;
+    [[nodiscard]] unsigned value() const noexcept;
+
+private:
+    ManhattanHeuristic manhattan;
+    unsigned conflicts = 0;
+    // Tiles to take out of each row, then of each column.
+    std::array<uint8_t, 2 * max_size> lines{};
+};
+
+// The estimate of a `PatternDatabase`, which has to outlive the heuristic. A move only changes
+// the term of the pattern holding the moved tile.
+//
+// With `reflected`, the database is also looked up on the transposed board, which is as far from
+// the goal, and the larger of the two sums is taken. It costs a second lookup per move and wins
+// most where the patterns are not symmetric about the diagonal.
+class PatternHeuristic {
+public:
+    explicit PatternHeuristic(const PatternDatabase& database, bool reflected = false) noexcept;
+
+    void init(const Board& board) noexcept;
+    void update(const Board& board, Move move) noexcept;
+    [[nodiscard]] unsigned value() const noexcept;
+
+private:
+    struct Sum {
+        unsigned total = 0;
+        std::array<uint8_t, PatternDatabase::max_patterns> terms{};
+    };
+
+    void init(Sum& sum, std::span<const uint16_t> tiles) const noexcept;
+    // After the tile now in cell `moved` of `tiles` took a step.
+    void update(Sum& sum, std::span<const uint16_t> tiles, std::size_t moved) const noexcept;
+
+    const PatternDatabase* database;
+    bool reflected;
+    Sum direct;
+    Sum transposed;
+};
+
+// The largest estimate of several heuristics.
+template <Heuristic... Parts>
+class MaxHeuristic {
+public:
+    explicit MaxHeuristic(Parts... parts) noexcept : parts(std::move(parts)...) {}
+
+    void init(const Board& board) noexcept {
+        std::apply([&](auto&... part) { (part.init(board), ...); }, parts);
+    }
+
+    void update(const Board& board, Move move) noexcept {
+        std::apply([&](auto&... part) { (part.update(board, move), ...); }, parts);
+    }
+
+    [[nodiscard]] unsigned value() const noexcept {
+        return std::apply([](const auto&... part) { return std::max({static_cast<unsigned>(part.value())...}); },
+                          parts);
+    }
+
+private:
+    std::tuple<Parts...> parts;
+};
+
+// The heuristics a search can be given at run time, see `SolveOptions`.
+using AnyHeuristic = std::variant<ManhattanHeuristic, LinearConflictHeuristic,
+                                  MaxHeuristic<LinearConflictHeuristic, PatternHeuristic>,
+                                  MaxHeuristic<LinearConflictHeuristic, PatternHeuristic, PatternHeuristic>>;
+
+#endif  // PUZZLE_HEURISTIC_HPP
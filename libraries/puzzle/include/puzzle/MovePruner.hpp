@@ -0,0 +1,68 @@
+#ifndef PUZZLE_MOVE_PRUNER_HPP
+#define PUZZLE_MOVE_PRUNER_HPP
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "puzzle/Board.hpp"
+#include "puzzle/TableFile.hpp"
+
+// Finite-state machine over the moves of a path that rejects move sequences with a cheaper twin:
+// another sequence from the same blank cell, no longer and earlier in move order, that leaves every
+// tile where this one does and keeps the blank within the rows and columns this one visits. Such a
+// twin fits on the board wherever the sequence does, so a depth-first search that never completes
+// a rejected sequence still finds the first of the shortest solutions, without a duplicate check.
+//
+// The sequences are learned by a breadth-first search of blank paths on a board too large for
+// them to reach its edges, where what a sequence does depends on nothing else, so one machine
+// serves every board size. It is the Aho-Corasick automaton of the sequences: one table lookup
+// per move. Learned to depth 2 it only forbids undoing the last move; depth 12 takes a second or
+// two, which is why the table is meant to be learned once and saved.
+class MovePruner {
+public:
+    using State = uint32_t;
+
+    static constexpr uint32_t kind = TableFile::tag('M', 'O', 'V', 'E');
+
+    // State of an empty path, and the one a rejected move leads to.
+    static constexpr State start  = 0;
+    static constexpr State pruned = std::numeric_limits<State>::max();
+    // Sequences of up to this many moves are looked for.
+    static constexpr unsigned max_depth = 16;
+
+    // Nothing for depths outside 1..max_depth.
+    static std::optional<MovePruner> learn(unsigned depth) noexcept;
+
+    // The transitions `save()` wrote, used in place from the mapped file; see `TableFile::open`.
+    static std::optional<MovePruner> load(const std::string& path, const TableFile::MapOptions& options) noexcept;
+    static std::optional<MovePruner> load(const std::string& path) noexcept;
+    // See `TableFile::load_or_make`: a file of another depth is learned over.
+    static std::optional<MovePruner> load_or_learn(const std::string& path, unsigned depth) noexcept;
+    bool save(const std::string& path) const noexcept;
+
+    [[nodiscard]] State next(State state, Move move) const noexcept {
+        return transitions[state][static_cast<uint8_t>(move)];
+    }
+
+    [[nodiscard]] unsigned depth() const noexcept;
+    [[nodiscard]] std::size_t states() const noexcept;
+    // Number of rejected sequences, none containing another.
+    [[nodiscard]] std::size_t sequences() const noexcept;
+
+private:
+    MovePruner() noexcept = default;
+
+    unsigned horizon      = 0;
+    std::size_t forbidden = 0;
+    // `transitions` views `owned` after `learn()` and the mapped `file` after `load()`.
+    std::vector<std::array<State, 4>> owned;
+    std::optional<TableFile> file;
+    std::span<const std::array<State, 4>> transitions;
+};
+
+#endif  // PUZZLE_MOVE_PRUNER_HPP
@@ -0,0 +1,106 @@
+#ifndef PUZZLE_PATTERN_DATABASE_HPP
+#define PUZZLE_PATTERN_DATABASE_HPP
+
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "puzzle/Board.hpp"
+#include "puzzle/TableFile.hpp"
+
+// Additive pattern database. The tiles are split into disjoint patterns; for every placement of
+// a pattern's tiles a table holds the fewest moves of those tiles that bring them home, moves of
+// the other tiles being free. Since every move moves one tile, the sum over the patterns never
+// overestimates the distance to the goal.
+//
+// A pattern of k tiles on a board of n cells has n!/(n-k)! placements and a byte for each, e.g.
+// 5.8 MB for 6 tiles of the 4x4 board. Building it visits n times as many states. A built
+// database can be compressed to a fraction of that, see `Storage`.
+class PatternDatabase {
+public:
+    using Pattern = std::vector<uint16_t>;
+
+    // How the distances are stored. `bytes` are exact. `nibbles` take half the memory and cap the
+    // distances at 15. `mod3` packs the distances modulo 3 five to a byte, 1.6 bits each, and a
+    // search still reads whole distances: one move changes a distance by at most one, so the
+    // previous distance and the residue tell the new one. A board met without one is walked to
+    // the goal one step closer at a time.
+    enum class Encoding : uint8_t { bytes, nibbles, mod3 };
+
+    struct Storage {
+        Encoding encoding = Encoding::bytes;
+        // Every `fold` consecutive placements, a power of two, share one entry holding the least
+        // of their distances; they differ only in the cell of the pattern's last tile. Only with
+        // bytes and nibbles.
+        unsigned fold = 1;
+    };
+
+    static constexpr uint32_t kind            = TableFile::tag('P', 'D', 'B', 'A');
+    static constexpr std::size_t max_patterns = 8;
+    // Boards up to 8x8, so that a placement fits into a 64-bit mask.
+    static constexpr std::size_t max_cells = 64;
+    // Building a table takes a byte per placement and cell of the blank; larger builds are refused.
+    static constexpr std::size_t max_build_states = std::size_t{1} << 32;
+
+    // Nothing if the patterns overlap, are empty, hold the blank or tiles outside the board, or
+    // are too large to build. Tiles in no pattern do not contribute to the estimate.
+    static std::optional<PatternDatabase> build(unsigned size, const std::vector<Pattern>& patterns) noexcept;
+
+    // The same database stored as `storage` says. Nothing for an invalid storage or a database
+    // that is itself compressed. Mod 3 needs distances of placements one step apart to differ by
+    // at most one, which pattern tiles walling the blank in can break; such distances are lowered
+    // until it holds, which keeps them admissible but costs a move or two on average.
+    [[nodiscard]] std::optional<PatternDatabase> compress(const Storage& storage) const noexcept;
+
+    static std::optional<PatternDatabase> load(const std::string& path, const TableFile::MapOptions& options) noexcept;
+    static std::optional<PatternDatabase> load(const std::string& path) noexcept;
+    bool save(const std::string& path) const noexcept;
+
+    [[nodiscard]] unsigned size() const noexcept;
+    [[nodiscard]] std::size_t patterns() const noexcept;
+    // Index of the pattern holding `tile`, or `patterns()` for tiles in none.
+    [[nodiscard]] std::size_t pattern_of(uint16_t tile) const noexcept;
+    [[nodiscard]] const Storage& storage() const noexcept;
+    // Bytes of the tables.
+    [[nodiscard]] std::size_t memory() const noexcept;
+
+    // Moves the tiles of pattern `index` need on `board`, which must have the database's size.
+    [[nodiscard]] unsigned lookup(std::size_t index, const Board& board) const noexcept;
+    // Same for a board one move after one where they needed `previous`; this is how a search
+    // reads mod-3 tables without walking.
+    [[nodiscard]] unsigned lookup(std::size_t index, const Board& board, unsigned previous) const noexcept;
+    // Sum over all patterns.
+    [[nodiscard]] unsigned estimate(const Board& board) const noexcept;
+
+    // The same for the row-major tiles of a board, which searches keep in scratch space for boards
+    // they derive, such as transposes.
+    [[nodiscard]] unsigned lookup(std::size_t index, std::span<const uint16_t> tiles) const noexcept;
+    [[nodiscard]] unsigned lookup(std::size_t index, std::span<const uint16_t> tiles, unsigned previous) const noexcept;
+    [[nodiscard]] unsigned estimate(std::span<const uint16_t> tiles) const noexcept;
+
+private:
+    PatternDatabase() noexcept = default;
+
+    // Checks the patterns and the storage and sets up `owner` and `offsets`.
+    bool layout(unsigned size, std::vector<Pattern> patterns, const Storage& storage) noexcept;
+    // Rank of the placement of pattern `index` given the cell of every tile.
+    [[nodiscard]] std::size_t placement(std::size_t index, const uint8_t* cells) const noexcept;
+    // Stored entry of placement `rank` of pattern `index`.
+    [[nodiscard]] unsigned entry(std::size_t index, std::size_t rank) const noexcept;
+    // Distance of pattern `index` in a mod-3 table, counted by walking to the goal.
+    [[nodiscard]] unsigned walk(std::size_t index, const uint8_t* cells) const noexcept;
+
+    unsigned side = 0;
+    std::vector<Pattern> tile_sets;
+    Storage packing;
+    std::vector<uint8_t> owner;
+    // Byte offset of every pattern's table, and the end of the last.
+    std::vector<std::size_t> offsets;
+    // The tables live in `owned` for a built database and in `file` for a loaded one.
+    std::vector<uint8_t> owned;
+    std::optional<TableFile> file;
+    std::span<const uint8_t> distances;
+};
+
+#endif  // PUZZLE_PATTERN_DATABASE_HPP
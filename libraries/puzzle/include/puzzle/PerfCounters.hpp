@@ -0,0 +1,110 @@
+#ifndef PUZZLE_PERF_COUNTERS_HPP
+#define PUZZLE_PERF_COUNTERS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+// Set to 0 to compile the counters out: scopes are then empty and no counter is ever opened.
+#ifndef PUZZLE_PERF_COUNTERS
+#define PUZZLE_PERF_COUNTERS 1
+#endif
+
+// Parts of a search the hardware counters are kept apart for.
+enum class Phase : uint8_t { successors, heuristic, open_list, closed_set, path };
+constexpr std::size_t phase_count = 5;
+
+// Hardware events counted in user space over every scope of one phase.
+struct PhaseCounters {
+    uint64_t cycles        = 0;
+    uint64_t instructions  = 0;
+    uint64_t cache_misses  = 0;
+    uint64_t branch_misses = 0;
+    // Times the phase was entered.
+    uint64_t scopes = 0;
+
+    PhaseCounters& operator+=(const PhaseCounters& other) noexcept;
+};
+
+struct PerfReport {
+    // False when counting was not asked for, was compiled out or the kernel refused it, which it
+    // does under a strict perf_event_paranoid and in virtual machines without a PMU.
+    bool available = false;
+    std::array<PhaseCounters, phase_count> phases{};
+
+    [[nodiscard]] PhaseCounters& operator[](Phase phase) noexcept {
+        return phases[static_cast<std::size_t>(phase)];
+    }
+    [[nodiscard]] const PhaseCounters& operator[](Phase phase) const noexcept {
+        return phases[static_cast<std::size_t>(phase)];
+    }
+
+    PerfReport& operator+=(const PerfReport& other) noexcept;
+};
+
+// Cycles, instructions, cache misses and branch misses of the calling thread, opened through
+// perf_event_open(2) as one group so that a single read(2) gives all four. That system call is
+// what a scope costs, so counting slows a search down several times: the counts tell where the
+// time goes, not how much of it there is.
+class PerfCounters {
+public:
+    static constexpr bool compiled = PUZZLE_PERF_COUNTERS != 0;
+
+    // Nothing where the counters are compiled out, the platform is not Linux or the kernel refuses.
+    static std::optional<PerfCounters> open() noexcept;
+
+    PerfCounters(PerfCounters&& other) noexcept;
+    PerfCounters& operator=(PerfCounters&& other) noexcept;
+    PerfCounters(const PerfCounters&)            = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+    ~PerfCounters();
+
+    // Totals since the counters were opened, with `scopes` left zero.
+    [[nodiscard]] PhaseCounters read() const noexcept;
+
+private:
+    PerfCounters() noexcept = default;
+    void close() noexcept;
+
+    // The group leader first; -1 for none.
+    std::array<int, 4> descriptors{-1, -1, -1, -1};
+};
+
+// Adds what the counters count while it lives to one phase of a report. Without counters it does
+// nothing but a test of the pointer, and with PUZZLE_PERF_COUNTERS set to 0 not even that.
+class PerfScope {
+public:
+    PerfScope(const PerfCounters* counters, PerfReport& report, Phase phase) noexcept {
+        if constexpr (PerfCounters::compiled) {
+            if (counters != nullptr) {
+                this->counters = counters;
+                target         = &report[phase];
+                start          = counters->read();
+            }
+        }
+    }
+
+    ~PerfScope() {
+        if constexpr (PerfCounters::compiled) {
+            if (counters != nullptr) {
+                const auto end = counters->read();
+                target->cycles += end.cycles - start.cycles;
+                target->instructions += end.instructions - start.instructions;
+                target->cache_misses += end.cache_misses - start.cache_misses;
+                target->branch_misses += end.branch_misses - start.branch_misses;
+                target->scopes++;
+            }
+        }
+    }
+
+    PerfScope(const PerfScope&)            = delete;
+    PerfScope& operator=(const PerfScope&) = delete;
+
+private:
+    const PerfCounters* counters = nullptr;
+    PhaseCounters* target        = nullptr;
+    PhaseCounters start;
+};
+
+#endif  // PUZZLE_PERF_COUNTERS_HPP
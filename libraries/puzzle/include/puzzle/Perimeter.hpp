@@ -0,0 +1,53 @@
+#ifndef PUZZLE_PERIMETER_HPP
+#define PUZZLE_PERIMETER_HPP
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "puzzle/Board.hpp"
+
+// Every board within `depth` moves of the goal, with its exact distance. A search that reaches
+// one is done, and every board outside is known to be at least `depth + 1` moves away, which
+// sharpens the heuristic near the goal. Built once and shared read-only between solves.
+//
+// Boards are kept by permutation rank in an open-addressing hash set of one word each, so only
+// sizes up to `Board::max_ranked_size` are supported. The 4x4 perimeter grows about twofold per
+// level: some 10^5 boards at depth 14, 10^7 at depth 20.
+class Perimeter {
+public:
+    // No 4x4 board is farther from the goal.
+    static constexpr unsigned max_depth = 80;
+
+    // Breadth-first search from the goal; nothing for sizes outside 2..Board::max_ranked_size.
+    static std::optional<Perimeter> build(unsigned size, unsigned depth) noexcept;
+
+    [[nodiscard]] unsigned size() const noexcept;
+    [[nodiscard]] unsigned depth() const noexcept;
+    // Number of boards inside.
+    [[nodiscard]] std::size_t boards() const noexcept;
+    [[nodiscard]] bool supports(const Board& board) const noexcept;
+
+    // Nothing for boards outside the perimeter or of another size.
+    [[nodiscard]] std::optional<unsigned> distance(const Board& board) const noexcept;
+    // Same by the permutation rank of a board of the perimeter's size.
+    [[nodiscard]] std::optional<unsigned> distance(uint64_t rank) const noexcept;
+    // An optimal solution from `board` to the goal, empty when it lies outside.
+    [[nodiscard]] std::vector<Board> path(const Board& board) const noexcept;
+
+private:
+    Perimeter() noexcept = default;
+
+    // Slot of `rank`: either the one holding it or the empty one where it belongs.
+    [[nodiscard]] std::size_t slot(uint64_t rank) const noexcept;
+    // Adds `rank` unless it is already inside; tells whether it was added.
+    bool insert(uint64_t rank, unsigned distance) noexcept;
+
+    unsigned side     = 0;
+    unsigned radius   = 0;
+    std::size_t count = 0;
+    // The rank shifted over the distance byte, or `empty`.
+    std::vector<uint64_t> slots;
+};
+
+#endif  // PUZZLE_PERIMETER_HPP
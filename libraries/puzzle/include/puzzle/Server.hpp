@@ -0,0 +1,95 @@
+#ifndef PUZZLE_SERVER_HPP
+#define PUZZLE_SERVER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "puzzle/Solver.hpp"
+
+// A long-running solver that answers requests over a Unix domain socket or a localhost TCP port,
+// so that worker threads, their lookup tables and the solution cache stay warm between clients.
+//
+// The protocol is line-delimited text. A request is an id, optional budgets and the tiles:
+//
+//     <id> [nodes=N] [ms=N] <tiles in row-major order>
+//
+// and is answered by a `TextFormat` result line labelled with its id. A client may pipeline any
+// number of requests; answers come in completion order. Malformed budgets make the request
+// invalid, and a request can only lower the server's budgets: `nodes=0` or a larger budget than
+// the server's gets the server's. When `Options::queue` requests are waiting for a worker, the
+// server stops reading from clients until one is taken. Answers are written by each client's own
+// thread; a client with `Options::output_limit` bytes of them unread is not read from until it
+// takes them, while the workers go on with everyone else's requests.
+class Server {
+public:
+    struct Options {
+        // Unix domain socket to listen on; a localhost TCP port when empty.
+        std::string socket_path;
+        // Zero picks a free port, see `port()`.
+        uint16_t port = 0;
+        // Worker threads, zero meaning one per hardware thread.
+        unsigned threads  = 0;
+        std::size_t queue = 1024;
+        // Bytes of answers a client may leave unread before it is throttled.
+        std::size_t output_limit = 1 << 20;
+        // How long clients get to take their last answers once the server stops; whatever they
+        // leave unread after that is dropped.
+        std::chrono::milliseconds drain_timeout{1000};
+        // Size of the shared solution cache, zero for none.
+        std::size_t cache_bytes = 0;
+        // Budgets of requests that do not set their own, and the most any request gets; `cache` is
+        // ignored.
+        SolveOptions solve;
+    };
+
+    explicit Server(Options options) noexcept;
+    Server(const Server&)            = delete;
+    Server& operator=(const Server&) = delete;
+    ~Server();
+
+    // Binds the socket. False if it cannot be created, bound or listened on.
+    bool listen() noexcept;
+    // The bound TCP port, zero for a Unix domain socket.
+    [[nodiscard]] uint16_t port() const noexcept;
+
+    // Accepts clients until `stop()` is called, then waits for the requests in flight and, for no
+    // longer than `Options::drain_timeout`, for their answers to be taken.
+    void serve() noexcept;
+    // Safe to call from any thread.
+    void stop() noexcept;
+
+private:
+    struct Connection;
+
+    struct Job {
+        std::shared_ptr<Connection> connection;
+        std::string id;
+        Board board;
+        SolveOptions solve;
+    };
+
+    void read(const std::shared_ptr<Connection>& connection) noexcept;
+    void work() noexcept;
+
+    Options options;
+    std::unique_ptr<SolutionCache> cache;
+    int listener        = -1;
+    uint16_t bound_port = 0;
+    std::atomic<bool> stopping{false};
+
+    std::mutex mutex;
+    std::condition_variable queue_changed;
+    std::deque<Job> jobs;
+    std::vector<std::weak_ptr<Connection>> connections;
+    std::size_t readers = 0;
+};
+
+#endif  // PUZZLE_SERVER_HPP
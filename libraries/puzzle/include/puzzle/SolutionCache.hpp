@@ -0,0 +1,62 @@
+#ifndef PUZZLE_SOLUTION_CACHE_HPP
+#define PUZZLE_SOLUTION_CACHE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "puzzle/Board.hpp"
+
+// Bounded table of optimal distances shared between solves. Each state on a solved path is stored
+// with its distance to the goal and the next move of an optimal solution, so any of them can later
+// be answered by walking the stored moves.
+//
+// Every entry is a single 64-bit word (permutation rank, board size, distance, move and a CLOCK
+// reference bit), so lookups and inserts from any number of threads are lock-free and never see a
+// torn entry. Slots are grouped into 64-byte buckets; a full bucket evicts with CLOCK (second chance).
+// A board and its transpose are stored once, under the canonical (smaller) rank of the two.
+// Only boards of side 2..4 are cached.
+class SolutionCache {
+public:
+    struct Entry {
+        unsigned distance;
+        Move next;  // meaningless when `distance == 0`
+    };
+
+    // The table takes at most `memory_bytes` (and at least one bucket).
+    explicit SolutionCache(std::size_t memory_bytes) noexcept;
+
+    SolutionCache(const SolutionCache&)            = delete;
+    SolutionCache& operator=(const SolutionCache&) = delete;
+
+    [[nodiscard]] static bool supports(const Board& board) noexcept;
+
+    [[nodiscard]] std::optional<Entry> find(const Board& board) const noexcept;
+    void insert(const Board& board, Entry entry) noexcept;
+
+    // Records every state of an optimal solution, `path.back()` being the goal.
+    void insert(const std::vector<Board>& path) noexcept;
+
+    // Optimal solution of `board` rebuilt from stored moves, or nothing if the chain of entries
+    // is incomplete.
+    [[nodiscard]] std::optional<std::vector<Board>> solution(const Board& board) const noexcept;
+
+    [[nodiscard]] std::size_t capacity() const noexcept;
+    [[nodiscard]] std::size_t memory() const noexcept;
+
+private:
+    static constexpr std::size_t bucket_slots = 8;
+
+    struct alignas(64) Bucket {
+        std::atomic<uint64_t> slots[bucket_slots];
+    };
+
+    [[nodiscard]] Bucket& bucket(uint64_t key) const noexcept;
+
+    std::size_t bucket_mask = 0;
+    std::unique_ptr<Bucket[]> buckets;
+};
+
+#endif  // PUZZLE_SOLUTION_CACHE_HPP
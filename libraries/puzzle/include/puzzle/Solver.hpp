@@ -1,17 +1,128 @@
 #ifndef PUZZLE_SOLVER_HPP
 #define PUZZLE_SOLVER_HPP
 
+#include <array>
+#include <chrono>
+#include <limits>
 #include <optional>
+#include <string>
 
 #include "puzzle/Board.hpp"
+#include "puzzle/DistanceTable.hpp"
+#include "puzzle/Heuristic.hpp"
+#include "puzzle/MovePruner.hpp"
+#include "puzzle/PerfCounters.hpp"
+#include "puzzle/Perimeter.hpp"
+#include "puzzle/SolutionCache.hpp"
+
+struct SolveStats {
+    std::size_t expanded  = 0;
+    std::size_t generated = 0;
+    // The search ran out of budget before it found a solution.
+    bool budget_exhausted = false;
+    // Iterative deepening: boards whose estimate the extra lookups raised, and boards cut because
+    // pathmax lifted their f over the bound.
+    std::size_t lookups_raised  = 0;
+    std::size_t pathmax_cutoffs = 0;
+    // A*: bytes taken by the closed set, a word per board reached for sides up to 4.
+    std::size_t closed_memory = 0;
+    // Breadth-first heuristic search: the most boards it held at once.
+    std::size_t frontier_peak = 0;
+    // Hardware counters by phase, when `SolveOptions::perf_counters` asked for them.
+    PerfReport perf;
+    // `Solver::repair` joined the board onto the previous solution without searching it, and the
+    // fewest moves a solution can have by what it met on the way, if the previous one was optimal.
+    bool repaired           = false;
+    std::size_t lower_bound = 0;
+};
+
+struct SolveOptions {
+    // Limits on expanded nodes and on wall time, zero meaning no limit. A search that runs out
+    // of budget gives an empty solution with `stats().budget_exhausted` set.
+    std::size_t node_budget = 0;
+    std::chrono::milliseconds time_budget{0};
+    // Shared cache to answer from and to fill, see `SolutionCache`.
+    SolutionCache* cache = nullptr;
+    // Boards of its size are solved from the table without search.
+    const DistanceTable* distances = nullptr;
+    // Searches of boards of its size stop on reaching it, see `Perimeter`.
+    const Perimeter* perimeter = nullptr;
+    // Heuristic of the search: Manhattan distance, with linear conflicts if set. Pattern
+    // databases of the board's size raise it to the maximum of their estimates, looked up on the
+    // board and on its transpose, and linear conflicts; see `Heuristic.hpp`.
+    bool linear_conflict = false;
+    std::array<const PatternDatabase*, 2> patterns{};
+    // Enhanced partial expansion (EPEA*): an expanded board generates only the children whose f
+    // equals its own and waits in the open list for the next larger f. The open list holds far
+    // fewer boards, at the price of expanding some several times.
+    bool partial_expansion = false;
+    // Breadth-first heuristic search in place of A* when not deepening: layer by layer under a
+    // bound on f that rises as in iterative deepening, keeping no closed set but the last two
+    // layers and the middle one, from which the path is recovered by divide and conquer. Memory
+    // follows the widest layer instead of every board reached, at the price of searching again.
+    // The cache is answered from and filled as with A*; the perimeter only applies to A*.
+    bool breadth_first = false;
+    // Iterative deepening (IDA*) on this many threads in place of A*, zero meaning A*. It keeps
+    // only the current path in memory. The threads search every bound with the moves tried in
+    // different orders and share a `TranspositionTable` of `transposition_bytes`, so that each
+    // skips the boards another has searched. The cache is answered from and filled as with A*;
+    // the perimeter and partial expansion only apply to A*.
+    unsigned deepening_threads      = 0;
+    std::size_t transposition_bytes = std::size_t{1} << 24;
+    // Iterative deepening by transposition-driven scheduling over this many worker processes, for
+    // boards beyond the memory or time of one: every board belongs to the worker its hash picks,
+    // which alone keeps track of it and expands it. Boards travel between workers in batches of up
+    // to `distributed_batch` over Unix domain sockets in `distributed_socket_dir`, or localhost TCP
+    // when it is empty. The workers are forked from the calling process for the search, which is
+    // only safe while it runs no other thread: called from one that does, as within `BatchSolver`
+    // or `Server`, the search is iterative deepening on as many threads instead. Zero, or
+    // deepening threads, leave this engine out. The cache is answered from and filled as with A*;
+    // nothing else of A* applies.
+    unsigned distributed_workers  = 0;
+    std::size_t distributed_batch = 256;
+    std::string distributed_socket_dir;
+    // Further estimates iterative deepening takes from the pattern databases, looked up on boards
+    // as far from the goal as the searched one: its transpose, its dual (where tiles and cells
+    // trade places), both, or one of the two picked by the board's hash. They are inconsistent,
+    // a board's estimate can drop by more than a move, which is what `pathmax` makes use of. The
+    // heuristic `solve` picks looks the transpose up already, so only the dual adds to it.
+    enum class Lookups : uint8_t { regular, reflected, dual, both, random };
+    Lookups lookups = Lookups::regular;
+    // Bidirectional pathmax (BPMX) in iterative deepening: a board's estimate is raised to its
+    // children's less one, and a board whose f is raised over the bound is left with the children
+    // it has not searched yet.
+    bool pathmax = false;
+    // Iterative deepening never completes a move sequence the machine rejects, which spares it
+    // most boards it would reach again by an equally long path. Without one it only never undoes
+    // the last move. See `MovePruner`.
+    const MovePruner* move_pruner = nullptr;
+    // Count cycles, instructions, cache misses and branch misses of every phase of the search into
+    // `stats().perf`, on every thread of it. Counting is slow; see `PerfCounters`.
+    bool perf_counters = false;
+};
+
+// How `Solver::repair` reuses a previous solution.
+struct RepairOptions {
+    // Moves from the new board within which the previous path is looked for.
+    unsigned window = 12;
+    // Moves a repaired solution may be longer than the lower bound the repair finds; zero asks for
+    // optimal solutions. By default the nearest board of the previous path is taken.
+    std::size_t slack = std::numeric_limits<std::size_t>::max();
+    // The search of a board the repair cannot answer within the slack.
+    SolveOptions solve;
+};
 
 class Solver {
     class Solution {
     public:
         Solution() noexcept;
         Solution(const std::vector<Board>& elements) noexcept;
+        Solution(const std::vector<Board>& elements, const SolveStats& stats) noexcept;
 
         [[nodiscard]] std::size_t moves() const noexcept;
+        // Moves of the blank from the initial board to the goal.
+        [[nodiscard]] std::vector<Move> path() const noexcept;
+        [[nodiscard]] const SolveStats& stats() const noexcept;
 
         using const_iterator = std::vector<Board>::const_iterator;
         [[nodiscard]] const_iterator begin() const noexcept;
@@ -19,10 +130,47 @@ class Solver {
 
     private:
         std::vector<Board> m_moves;
+        SolveStats m_stats;
     };
 
 public:
     static Solution solve(const Board& board) noexcept;
+    // Answers from `cache` when the board lies on a cached solution, and stores every newly found
+    // optimal solution in it. The cache may be shared by concurrent calls.
+    static Solution solve(const Board& board, SolutionCache& cache) noexcept;
+    static Solution solve(const Board& board, const SolveOptions& options) noexcept;
+    // Searches with the given heuristic instead of the one `options` pick. Instantiated for the
+    // heuristics of `AnyHeuristic` and `PatternHeuristic`.
+    template <Heuristic H>
+    static Solution solve(const Board& board, const SolveOptions& options, const H& heuristic) noexcept;
+
+    // A solution of `board` that reuses `previous`, an optimal solution of a board a few moves or
+    // tile swaps away. A breadth-first search of up to `options.window` moves from `board` joins it
+    // to the old path, whose rest is known. The boards it meets also bound the optimal solution
+    // from below: one i moves into a path of n, found d moves away, leaves at least n - i - d, as
+    // does the heuristic. Within the slack of that bound the join is the answer, with
+    // `stats().repaired` set. Otherwise `board` is searched after all, with the old path as exact
+    // costs where a `SolutionCache` can hold it; so is a board of another size than `previous`.
+    // The bound and those costs are only as good as `previous`: a repaired solution longer than
+    // its bound is taken for a path, bounded by the heuristic alone, and the old path never enters
+    // `options.solve.cache`, nor does a solution found with it unless the heuristic proves it.
+    static Solution repair(const Solution& previous, const Board& board, const RepairOptions& options) noexcept;
+    static Solution repair(const Solution& previous, const Board& board) noexcept;
+
+    // Moves of a solution found in polynomial time, for boards far too large to solve optimally:
+    // rows and columns are put in place from the top left until a 3x3 block is left, which is
+    // solved optimally, and the moves are then shortened. Boards up to 3x3 are solved optimally.
+    // Nothing for invalid and unsolvable boards.
+    static std::optional<std::vector<Move>> approximate(const Board& board) noexcept;
+
+    // Boards iterative deepening with the Manhattan distance is predicted to expand, by the formula
+    // of Korf, Reid and Edelkamp: under a bound t, of the N(i) paths of i moves that never undo a
+    // move, the share P(t - i) of random boards with an estimate of at most t - i. P is sampled
+    // once per size. The bounds run from the board's estimate to halfway between it and where the
+    // optimal solutions of random boards lie, if that is more. Zero for boards with nothing to
+    // search, and for boards so near the goal that no random board leaves any path to count; at
+    // most the largest node budget, for boards any budget is far too small for.
+    static double estimate(const Board& board) noexcept;
 };
 
 std::optional<std::vector<std::vector<uint16_t>>> adjacent_state(int ic, int jc, int i, int j,
@@ -33,4 +181,4 @@ std::vector<std::vector<std::vector<uint16_t>>> adjacent_board_states(
 
 std::vector<Board> algorithm(const Board& start, const Board& goal) noexcept;
 
-#endif  // PUZZLE_SOLVER_HPP
\ No newline at end of file
+#endif  // PUZZLE_SOLVER_HPP
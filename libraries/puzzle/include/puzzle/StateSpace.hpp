@@ -0,0 +1,44 @@
+#ifndef PUZZLE_STATE_SPACE_HPP
+#define PUZZLE_STATE_SPACE_HPP
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+// Breadth-first enumeration of every board of one size reachable from the goal, that is of every
+// solvable board, level by level. It is the ground truth for optimal solution lengths and the
+// way distance tables are built.
+//
+// When two bits per permutation rank fit into `Options::memory_bytes` (90 KB for 3x3), each
+// state holds its depth modulo 3 or "unseen", and a level is expanded by scanning for the states
+// of the current depth. Larger spaces keep every level on disk as a sorted file of ranks: the
+// children of a level are sorted in memory-sized runs, merged, and their duplicates dropped
+// against the level before. No other level can hold them, as every move changes the parity of
+// the blank's cell.
+class StateSpace {
+public:
+    struct Options {
+        // Memory for the bitmap, or else for sorting a run of children.
+        std::size_t memory_bytes = std::size_t{1} << 30;
+        // Where the level and run files of the on-disk search go; the temporary directory if empty.
+        std::string scratch;
+    };
+
+    // Receives the ranks first reached at `depth`, part of a level at a time. The ranks of every
+    // call are increasing in the on-disk search.
+    using Visitor = std::function<void(unsigned depth, std::span<const uint64_t> ranks)>;
+
+    // The number of boards at each depth. Nothing for sizes outside 2..Board::max_ranked_size or
+    // when the scratch files cannot be written.
+    static std::optional<std::vector<uint64_t>> enumerate(unsigned size, const Options& options,
+                                                          const Visitor& visit) noexcept;
+    static std::optional<std::vector<uint64_t>> enumerate(unsigned size) noexcept;
+
+    // Number of permutation ranks of a board of `size`, i.e. (size^2)!.
+    [[nodiscard]] static uint64_t ranks(unsigned size) noexcept;
+};
+
+#endif  // PUZZLE_STATE_SPACE_HPP
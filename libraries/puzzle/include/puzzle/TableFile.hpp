@@ -0,0 +1,81 @@
+#ifndef PUZZLE_TABLE_FILE_HPP
+#define PUZZLE_TABLE_FILE_HPP
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+
+// A precomputed table stored on disk: a 64-byte header (magic "PZLT", version, byte order, the
+// kind of table and four parameters of its layout, payload size and checksum), then the payload
+// starting at a page boundary, in the byte order of the host that wrote it.
+//
+// Files are mapped read-only and shared, so every process using a table shares one copy in the
+// page cache, pages are read on first use, and concurrent readers need no synchronization.
+class TableFile {
+public:
+    using Parameters = std::array<uint64_t, 4>;
+
+    struct MapOptions {
+        // Reads the whole payload up front (MAP_POPULATE) instead of on first use.
+        bool populate = false;
+        // Asks for transparent huge pages where the kernel supports them for files.
+        bool huge_pages = false;
+        // Compares the checksum, which reads every page and so gives up loading on first use. A
+        // table is verified once when it is written; ask again where the file may have been
+        // damaged since.
+        bool verify = false;
+    };
+
+    // Four-character code naming the kind of a table.
+    static constexpr uint32_t tag(char a, char b, char c, char d) noexcept {
+        return static_cast<uint8_t>(a) | static_cast<uint32_t>(static_cast<uint8_t>(b)) << 8 |
+               static_cast<uint32_t>(static_cast<uint8_t>(c)) << 16 |
+               static_cast<uint32_t>(static_cast<uint8_t>(d)) << 24;
+    }
+
+    // Writes the table to a temporary file next to `path`, reads it back against the checksum and
+    // renames it into place, so readers never see a partial or damaged table. False on I/O errors.
+    static bool write(const std::string& path, uint32_t kind, const Parameters& parameters,
+                      std::span<const uint8_t> payload) noexcept;
+
+    // Nothing if the file is missing, of another kind or version, truncated, or fails the checksum
+    // when `MapOptions::verify` asks for it.
+    static std::optional<TableFile> open(const std::string& path, uint32_t kind, const MapOptions& options) noexcept;
+    static std::optional<TableFile> open(const std::string& path, uint32_t kind) noexcept;
+
+    // The table `Table::load` maps from `path` if `fits` accepts it, or else the one `make`
+    // computes, saved to `path` for next time. A table that cannot be saved is still returned;
+    // it is just computed again by the next caller.
+    template <typename Table, typename Fits, typename Make>
+    static std::optional<Table> load_or_make(const std::string& path, const Fits& fits, const Make& make) noexcept {
+        auto table = Table::load(path);
+        if (table && fits(*table)) {
+            return table;
+        }
+        table = make();
+        if (table) {
+            table->save(path);
+        }
+        return table;
+    }
+
+    TableFile(TableFile&& other) noexcept;
+    TableFile& operator=(TableFile&& other) noexcept;
+    TableFile(const TableFile&)            = delete;
+    TableFile& operator=(const TableFile&) = delete;
+    ~TableFile();
+
+    [[nodiscard]] const Parameters& parameters() const noexcept;
+    [[nodiscard]] std::span<const uint8_t> payload() const noexcept;
+
+private:
+    TableFile() noexcept = default;
+
+    const uint8_t* mapping = nullptr;
+    std::size_t length     = 0;
+    Parameters table_parameters{};
+};
+
+#endif  // PUZZLE_TABLE_FILE_HPP
@@ -0,0 +1,41 @@
+#ifndef PUZZLE_TEXT_FORMAT_HPP
+#define PUZZLE_TEXT_FORMAT_HPP
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "puzzle/BatchSolver.hpp"
+
+// The line-oriented text form of boards and results, shared by the command line tool and the
+// solver server.
+//
+// A board is its tiles in row-major order separated by blanks, 0 for the blank. A result starts
+// with a label and the number of moves, or with "invalid", "unsolvable" or "budget".
+class TextFormat {
+public:
+    enum class Detail {
+        count,   // just the number of moves
+        moves,   // followed by the blank moves as U/D/L/R
+        boards,  // followed by every board of the solution on its own line
+    };
+
+    // A line that is not a square number of tiles becomes a board that fails `Board::validate()`.
+    static Board parse_board(std::string_view line) noexcept;
+
+    // The result line (lines with `Detail::boards`) including the final newline.
+    static std::string format_result(std::string_view label, const Board& board,
+                                     const BatchSolver::Solution& solution, Detail detail) noexcept;
+
+    static void append_tiles(std::string& out, const Board& board) noexcept;
+
+    // Picks the search engine of `options` by its command line name: "astar", "epea" (partial
+    // expansion), "bfhs" (breadth-first), "ida" on `threads` threads or "distributed" over
+    // `threads` worker processes. False for any other name.
+    static bool parse_engine(std::string_view name, unsigned threads, SolveOptions& options) noexcept;
+
+    // "regular", "reflected", "dual", "both" or "random", see `SolveOptions::lookups`.
+    static std::optional<SolveOptions::Lookups> parse_lookups(std::string_view name) noexcept;
+};
+
+#endif  // PUZZLE_TEXT_FORMAT_HPP
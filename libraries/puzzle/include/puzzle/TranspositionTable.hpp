@@ -0,0 +1,53 @@
+#ifndef PUZZLE_TRANSPOSITION_TABLE_HPP
+#define PUZZLE_TRANSPOSITION_TABLE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "puzzle/Board.hpp"
+
+// Boards a depth-first search has been through under its current cost bound, shared by all the
+// threads searching one instance. A board reached again under the same bound with no fewer moves
+// from the start leads nowhere new: its subtree has been, or is being, searched with at least as
+// much of the bound left.
+//
+// Like `SolutionCache`, every entry is one 64-bit word (permutation rank, board size, moves from
+// the start and bound) and slots are grouped into 64-byte buckets, so threads share the table
+// without locks. A full bucket is depth-preferred: it gives up the entry with the least bound left,
+// entries of earlier bounds first, and keeps its entries when the new one has even less left.
+// Only boards of side 2..4 are stored.
+class TranspositionTable {
+public:
+    // The table takes at most `memory_bytes` (and at least one bucket).
+    explicit TranspositionTable(std::size_t memory_bytes) noexcept;
+
+    TranspositionTable(const TranspositionTable&)            = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    [[nodiscard]] static bool supports(const Board& board) noexcept;
+
+    // Records that `board` is searched `moves` moves from the start under `bound`. False if it
+    // already was under the same bound with no more moves, in which case the caller can skip it.
+    // With `equal_again`, it needs fewer moves: a search that keeps only one of the equally long
+    // paths to a board, as with a `MovePruner`, may have kept another than the one seen first.
+    [[nodiscard]] bool visit(const Board& board, unsigned moves, unsigned bound, bool equal_again = false) noexcept;
+
+    // Empties the table for another search; not safe while other threads use it.
+    void clear() noexcept;
+
+    [[nodiscard]] std::size_t capacity() const noexcept;
+    [[nodiscard]] std::size_t memory() const noexcept;
+
+private:
+    static constexpr std::size_t bucket_slots = 8;
+
+    struct alignas(64) Bucket {
+        std::atomic<uint64_t> slots[bucket_slots];
+    };
+
+    std::size_t bucket_mask = 0;
+    std::unique_ptr<Bucket[]> buckets;
+};
+
+#endif  // PUZZLE_TRANSPOSITION_TABLE_HPP
@@ -0,0 +1,230 @@
+#include "puzzle/BatchSolver.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+namespace {
+
+// A board from a `Source`, as a batch of one.
+struct SingleBoard {
+    std::optional<Board> board;
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return 1;
+    }
+
+    bool next(Board& out) noexcept {
+        if (not board) {
+            return false;
+        }
+        out = std::move(*board);
+        board.reset();
+        return true;
+    }
+};
+
+// The boards of a corpus chunk, decoded by the worker that took it.
+struct ChunkBoards {
+    CorpusChunk chunk;
+    CorpusRecord record;
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return chunk.size();
+    }
+
+    bool next(Board& out) noexcept {
+        if (not chunk.next(record)) {
+            return false;
+        }
+        std::swap(out, record.board);
+        return true;
+    }
+};
+
+// Solves a board unless it is predicted to run out of the node budget and the options say what
+// to do instead.
+BatchSolver::Solution solve_board(const Board& board, const BatchSolver::Options& options) noexcept {
+    const std::size_t budget = options.solve.node_budget;
+    if (options.over_budget == BatchSolver::OverBudget::attempt || budget == 0 ||
+        Solver::estimate(board) <= static_cast<double>(budget)) {
+        return Solver::solve(board, options.solve);
+    }
+    if (options.over_budget == BatchSolver::OverBudget::approximate) {
+        std::vector<Board> path{board};
+        for (auto move : Solver::approximate(board).value_or(std::vector<Move>{})) {
+            path.push_back(*path.back().moved(move));
+        }
+        return {path};
+    }
+    SolveStats stats;
+    stats.budget_exhausted = true;
+    return {std::vector<Board>{}, stats};
+}
+
+// `take` is called under the lock and returns the next batch of consecutive boards, or nothing at
+// the end of the input. Workers decode and solve the boards of their batch outside of the lock.
+template <typename Batch, typename Take>
+void run_batches(const Take& take, const BatchSolver::Sink& sink, const BatchSolver::Options& options) noexcept {
+    using Solution         = BatchSolver::Solution;
+    const unsigned threads =
+        options.threads != 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t window = std::max<std::size_t>(options.window, 1);
+
+    // Reading the input and reporting results are serialized by one mutex; only solving runs in
+    // parallel.
+    std::mutex mutex;
+    std::condition_variable window_moved;
+    bool finished           = false;
+    std::size_t next_input  = 0;
+    std::size_t next_report = 0;
+    std::map<std::size_t, std::pair<Board, Solution>> pending;
+
+    const auto worker = [&]() {
+        Board board;
+        while (true) {
+            std::optional<Batch> batch;
+            std::size_t index = 0;
+            {
+                std::unique_lock lock(mutex);
+                window_moved.wait(lock, [&]() { return finished || next_input - next_report < window; });
+                if (finished) {
+                    return;
+                }
+                batch = take();
+                if (not batch) {
+                    finished = true;
+                    window_moved.notify_all();
+                    return;
+                }
+                index = next_input;
+                next_input += batch->size();
+            }
+
+            for (; batch->next(board); index++) {
+                auto solution = solve_board(board, options);
+
+                std::lock_guard lock(mutex);
+                if (options.order == BatchSolver::Order::completion) {
+                    sink(index, board, solution);
+                    next_report++;
+                } else {
+                    pending.emplace(index, std::make_pair(board, std::move(solution)));
+                    while (not pending.empty() && pending.begin()->first == next_report) {
+                        const auto& [ready_board, ready_solution] = pending.begin()->second;
+                        sink(next_report, ready_board, ready_solution);
+                        pending.erase(pending.begin());
+                        next_report++;
+                    }
+                }
+                window_moved.notify_all();
+            }
+        }
+    };
+
+    // The calling thread is one of the workers, so that a single one leaves the process with no other
+    // thread: the distributed engine can only fork from such a process.
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (unsigned i = 1; i < threads; i++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+}
+
+}  // anonymous namespace
+
+void BatchSolver::run(const Source& source, const Sink& sink, const Options& options) noexcept {
+    run_batches<SingleBoard>(
+        [&]() -> std::optional<SingleBoard> {
+            auto board = source();
+            if (not board) {
+                return {};
+            }
+            return SingleBoard{std::move(board)};
+        },
+        sink, options);
+}
+
+void BatchSolver::run(CorpusReader& input, const Sink& sink, const Options& options) noexcept {
+    const std::size_t records = std::max<std::size_t>(options.chunk, 1);
+    run_batches<ChunkBoards>(
+        [&]() -> std::optional<ChunkBoards> {
+            auto chunk = input.next_chunk(records);
+            if (not chunk) {
+                return {};
+            }
+            return ChunkBoards{*chunk, {}};
+        },
+        sink, options);
+}
+
+std::vector<BatchSolver::Solution> BatchSolver::solve(std::span<const Board> boards, const Options& options) noexcept {
+    std::vector<std::size_t> order(boards.size());
+    std::iota(order.begin(), order.end(), 0);
+    if (options.longest_first) {
+        std::vector<double> costs(boards.size());
+        for (std::size_t index = 0; index < boards.size(); index++) {
+            costs[index] = Solver::estimate(boards[index]);
+        }
+        std::stable_sort(order.begin(), order.end(),
+                         [&](std::size_t left, std::size_t right) { return costs[left] > costs[right]; });
+    }
+
+    std::vector<Solution> result(boards.size());
+    std::size_t next = 0;
+    run(
+        [&]() -> std::optional<Board> {
+            if (next == boards.size()) {
+                return {};
+            }
+            return boards[order[next++]];
+        },
+        [&](std::size_t index, const Board&, const Solution& solution) { result[order[index]] = solution; },
+        options);
+    return result;
+}
+
+CorpusRecord BatchSolver::record(const Board& board, const Solution& solution) noexcept {
+    CorpusRecord record;
+    record.board = board;
+    if (solution.begin() == solution.end()) {
+        record.status = solution.stats().budget_exhausted ? CorpusRecord::Status::budget
+                                                          : CorpusRecord::Status::unsolvable;
+    } else {
+        record.moves = solution.path();
+    }
+    return record;
+}
+
+std::optional<std::size_t> BatchSolver::solve(CorpusReader& input, CorpusWriter& output,
+                                              const Options& options) noexcept {
+    if (not output.has_solutions() || input.side() != output.side()) {
+        return {};
+    }
+    std::size_t written = 0;
+    bool failed         = false;
+    run(
+        input,
+        [&](std::size_t, const Board& board, const Solution& solution) {
+            if (failed || not board.validate()) {
+                return;
+            }
+            if (output.write(record(board, solution))) {
+                written++;
+            } else {
+                failed = true;
+            }
+        },
+        options);
+    if (failed || not output.flush()) {
+        return {};
+    }
+    return written;
+}
@@ -1,27 +1,33 @@
 #include "puzzle/Board.hpp"
 
 #include <algorithm>
+#include <bit>
 #include <iostream>
 #include <random>
 
-Board::Board() noexcept : data(std::vector<std::vector<uint16_t>>(0)) {}
+#include "Kernels.hpp"
 
-Board::Board(const std::vector<std::vector<uint16_t>>& input) noexcept : data{input} {}
+Board::Board() noexcept : data(std::vector<uint16_t>(0)) {}
 
-Board::Board(const std::vector<std::vector<unsigned>>& input) noexcept {
-    data.reserve(input.size());
-
-    for (const auto& vec : input) {
-        std::vector<uint16_t> row;
-        row.reserve(vec.size());
+Board::Board(const std::vector<std::vector<uint16_t>>& input) noexcept : side(input.size()) {
+    data.reserve(side * side);
+    for (const auto& row : input) {
+        data.insert(data.end(), row.begin(), row.end());
+    }
+}
 
-        for (auto value : vec) {
-            row.push_back(value);
+Board::Board(const std::vector<std::vector<unsigned>>& input) noexcept : side(input.size()) {
+    data.reserve(side * side);
+    for (const auto& row : input) {
+        for (auto value : row) {
+            data.push_back(value);
         }
-        data.push_back(row);
     }
 }
 
+Board::Board(std::size_t side, std::span<const uint16_t> tiles) noexcept
+    : side(side), data(tiles.begin(), tiles.end()) {}
+
 Board Board::create_goal(const unsigned size) noexcept {
     std::vector<std::vector<unsigned>> table(size, std::vector<unsigned>(size, 0));
     for (unsigned i = 0; i < size; i++) {
@@ -34,109 +40,249 @@ Board Board::create_goal(const unsigned size) noexcept {
 }
 
 Board Board::create_random(const unsigned size) noexcept {
-    std::vector<unsigned> numbers(size * size, 0);
+    thread_local std::mt19937 engine(std::random_device{}());
+
+    std::vector<uint16_t> numbers(size * size, 0);
     for (unsigned i = 0; i < size * size; i++) {
         numbers[i] = i;
     }
-    std::shuffle(numbers.begin(), numbers.end(), std::mt19937(std::random_device()()));
+    std::shuffle(numbers.begin(), numbers.end(), engine);
 
-    std::vector<std::vector<unsigned>> table(size, std::vector<unsigned>(size, 0));
-    for (unsigned i = 0; i < size; i++) {
-        for (unsigned j = 0; j < size; j++) {
-            table[i][j] = numbers[i * size + j];
-        }
-    }
-    return Board(table);
+    Board board;
+    board.side = size;
+    board.data = std::move(numbers);
+    return board;
 }
 
 std::size_t Board::size() const noexcept {
-    return data.size();
+    return side;
 }
 
 bool Board::is_goal() const noexcept {
     return hamming() == 0;
 }
 
+std::optional<bool> Board::odd_permutation() const noexcept {
+    const std::size_t size_n = data.size();
+    thread_local std::vector<uint8_t> seen;
+    seen.assign(size_n, 0);
+    for (auto value : data) {
+        if (value >= size_n || seen[value] != 0) {
+            return {};
+        }
+        seen[value] = 1;
+    }
+
+    // The parity of a permutation is the parity of its inversion count, and equals the parity
+    // of (elements - cycles), which a single walk over the cycles gives in linear time.
+    std::fill(seen.begin(), seen.end(), 0);
+    std::size_t cycles = 0;
+    for (std::size_t i = 0; i < size_n; i++) {
+        if (seen[i] == 0) {
+            cycles++;
+            for (std::size_t j = i; seen[j] == 0; j = data[j]) {
+                seen[j] = 1;
+            }
+        }
+    }
+    return (size_n - cycles) % 2 == 1;
+}
+
+bool Board::validate() const noexcept {
+    return data.size() == side * side && odd_permutation().has_value();
+}
+
 bool Board::is_solvable() const noexcept {
-    std::size_t data_size = data.size();
-    if (data_size == 0 || data_size == 1) {
+    if (side == 0 || side == 1) {
         return true;
     }
 
-    std::size_t size_n = data_size * data_size;
-    std::vector<unsigned> numbers(size_n, 0);
-    for (unsigned i = 0; i < data_size; i++) {
-        for (unsigned j = 0; j < data_size; j++) {
-            numbers[i * data_size + j] = data[i][j];
-        }
+    const auto odd = odd_permutation();
+    if (not odd) {
+        return false;
+    }
+    const std::size_t blank         = std::find(data.begin(), data.end(), 0) - data.begin();
+    const std::size_t distance_null = (side - 1 - blank / side) + (side - 1 - blank % side);
+
+    return (static_cast<std::size_t>(*odd) + distance_null + side) % 2 == 1;
+}
+
+std::vector<bool> Board::is_solvable(std::span<const Board> boards) noexcept {
+    std::vector<bool> result(boards.size());
+    for (std::size_t i = 0; i < boards.size(); i++) {
+        result[i] = boards[i].is_solvable();
+    }
+    return result;
+}
+
+std::vector<bool> Board::validate(std::span<const Board> boards) noexcept {
+    std::vector<bool> result(boards.size());
+    for (std::size_t i = 0; i < boards.size(); i++) {
+        result[i] = boards[i].validate();
     }
-    std::size_t permutations = 0;
-    for (unsigned i = 0; i < size_n; i++) {
-        for (unsigned j = i + 1; j < size_n; j++) {
-            if (numbers[i] > numbers[j]) {
-                permutations++;
+    return result;
+}
+
+unsigned Board::hamming() const noexcept {
+    return kernels::hamming(data.data(), side);
+}
+
+unsigned Board::manhattan() const noexcept {
+    return kernels::manhattan(data.data(), side);
+}
+
+void Board::manhattan(std::span<const Board> boards, std::span<unsigned> out) noexcept {
+    constexpr std::size_t batch = 4;
+    for (std::size_t i = 0; i < boards.size() && i < out.size(); i += batch) {
+        const std::size_t count = std::min({batch, boards.size() - i, out.size() - i});
+        const uint16_t* tiles[batch];
+        bool same_size = true;
+        for (std::size_t k = 0; k < count; k++) {
+            tiles[k]  = boards[i + k].data.data();
+            same_size = same_size && boards[i + k].side == boards[i].side;
+        }
+        if (same_size) {
+            kernels::manhattan4(tiles, count, boards[i].side, &out[i]);
+        } else {
+            for (std::size_t k = 0; k < count; k++) {
+                out[i + k] = boards[i + k].manhattan();
             }
         }
     }
-    unsigned distance_null = 0;
-    for (unsigned i = 0; i < data_size; i++) {
-        for (unsigned j = 0; j < data_size; j++) {
-            if (data[i][j] == 0) {
-                distance_null += (data_size - 1 - i) + (data_size - 1 - j);
+}
+
+std::optional<Board> Board::moved(Move move) const noexcept {
+    if (side == 0) {
+        return {};
+    }
+    const std::size_t from = blank();
+    const std::size_t row  = from / side;
+    const std::size_t col  = from % side;
+    std::size_t to         = 0;
+    switch (move) {
+        case Move::up:
+            if (row == 0) {
+                return {};
             }
-        }
+            to = from - side;
+            break;
+        case Move::down:
+            if (row + 1 >= side) {
+                return {};
+            }
+            to = from + side;
+            break;
+        case Move::left:
+            if (col == 0) {
+                return {};
+            }
+            to = from - 1;
+            break;
+        case Move::right:
+            if (col + 1 >= side) {
+                return {};
+            }
+            to = from + 1;
+            break;
     }
 
-    return (permutations + distance_null + data_size) % 2 == 1;
+    Board result = *this;
+    std::swap(result.data[from], result.data[to]);
+    return result;
 }
 
-unsigned Board::hamming() const noexcept {
-    std::size_t data_size = data.size();
-    if (data_size == 0) {
-        return 0;
+std::optional<Move> Board::move_to(const Board& next) const noexcept {
+    if (side != next.side || side == 0) {
+        return {};
+    }
+    for (auto move : {Move::up, Move::down, Move::left, Move::right}) {
+        const auto candidate = moved(move);
+        if (candidate && *candidate == next) {
+            return move;
+        }
     }
+    return {};
+}
 
-    unsigned counter = 0;
-    for (unsigned i = 0; i < data_size; i++) {
-        for (unsigned j = 0; j < data_size; j++) {
-            if (data[i][j] != i * data_size + j + 1) {
-                counter++;
+std::size_t Board::blank() const noexcept {
+    return std::find(data.begin(), data.end(), 0) - data.begin();
+}
+
+Board Board::transposed() const noexcept {
+    Board result = *this;
+    transposed(side, data, result.data);
+    return result;
+}
+
+void Board::transposed(std::size_t side, std::span<const uint16_t> tiles, std::span<uint16_t> out) noexcept {
+    for (std::size_t i = 0; i < side; i++) {
+        for (std::size_t j = 0; j < side; j++) {
+            const uint16_t value = tiles[i * side + j];
+            if (value == 0) {
+                out[j * side + i] = 0;
+            } else {
+                const std::size_t goal = value - 1u;
+                out[j * side + i]      = static_cast<uint16_t>((goal % side) * side + goal / side + 1);
             }
         }
     }
-    if (data[data_size - 1][data_size - 1] == 0) {
-        counter--;
+}
+
+uint64_t Board::rank() const noexcept {
+    return rank(data);
+}
+
+uint64_t Board::rank(std::span<const uint16_t> tiles) noexcept {
+    // Lehmer code: the digit of each cell is the number of smaller tiles still unused.
+    const std::size_t cells = tiles.size();
+    uint32_t unused         = (cells >= 32 ? 0 : 1u << cells) - 1;
+    uint64_t result         = 0;
+    for (std::size_t i = 0; i < cells; i++) {
+        const uint32_t below = unused & ((1u << tiles[i]) - 1);
+        result               = result * (cells - i) + std::popcount(below);
+        unused &= ~(1u << tiles[i]);
     }
-    return counter;
+    return result;
 }
 
-unsigned Board::distance(unsigned i, unsigned j, unsigned value) const noexcept {
-    std::size_t data_size = data.size();
-    int64_t i_goal        = (value - 1) / data_size;
-    int64_t j_goal        = (value - 1) % data_size;
-    return std::abs(i_goal - i) + std::abs(j_goal - j);
+Board Board::unrank(unsigned size, uint64_t rank) noexcept {
+    Board board;
+    board.side = size;
+    board.data.resize(static_cast<std::size_t>(size) * size);
+    unrank(size, rank, board.data);
+    return board;
 }
 
-unsigned Board::manhattan() const noexcept {
-    std::size_t data_size = data.size();
-    unsigned counter      = 0;
-    for (unsigned i = 0; i < data_size; i++) {
-        for (unsigned j = 0; j < data_size; j++) {
-            if (data[i][j] != 0) {
-                counter += distance(i, j, data[i][j]);
-            }
+void Board::unrank(unsigned size, uint64_t rank, std::span<uint16_t> tiles) noexcept {
+    const std::size_t cells = static_cast<std::size_t>(size) * size;
+    if (size > max_ranked_size) {
+        return;
+    }
+    uint8_t digits[max_ranked_size * max_ranked_size] = {};
+    for (std::size_t i = cells; i-- > 0;) {
+        const std::size_t base = cells - i;
+        digits[i]              = static_cast<uint8_t>(rank % base);
+        rank /= base;
+    }
+
+    uint32_t unused = (cells >= 32 ? 0 : 1u << cells) - 1;
+    for (std::size_t i = 0; i < cells; i++) {
+        uint32_t candidates = unused;
+        for (unsigned skip = digits[i]; skip > 0; skip--) {
+            candidates &= candidates - 1;
         }
+        const auto value = static_cast<uint16_t>(std::countr_zero(candidates));
+        tiles[i]         = value;
+        unused &= ~(1u << value);
     }
-    return counter;
 }
 
 std::string Board::to_string() const noexcept {
-    std::size_t data_size = data.size();
     std::string str;
-    for (unsigned i = 0; i < data_size; i++) {
-        for (unsigned j = 0; j < data_size; j++) {
-            str += std::to_string(data[i][j]) + " ";
-            if (j == data_size - 1 && i != data_size - 1) {
+    for (unsigned i = 0; i < side; i++) {
+        for (unsigned j = 0; j < side; j++) {
+            str += std::to_string(data[i * side + j]) + " ";
+            if (j == side - 1 && i != side - 1) {
                 str += "\n";
             }
         }
@@ -149,15 +295,24 @@ std::size_t Board::hash() const noexcept {
 }
 
 std::span<const uint16_t> Board::operator[](unsigned int index) const noexcept {
-    return data[index];
+    return {data.data() + index * side, side};
 }
 
 std::vector<std::vector<uint16_t>> Board::get_board() const noexcept {
+    std::vector<std::vector<uint16_t>> table;
+    table.reserve(side);
+    for (unsigned i = 0; i < side; i++) {
+        table.emplace_back(data.begin() + i * side, data.begin() + (i + 1) * side);
+    }
+    return table;
+}
+
+std::span<const uint16_t> Board::tiles() const noexcept {
     return data;
 }
 
 bool operator==(const Board& left, const Board& right) noexcept {
-    return left.data == right.data;
+    return left.side == right.side && left.data == right.data;
 }
 
 bool operator!=(const Board& left, const Board& right) noexcept {
@@ -0,0 +1,425 @@
+#include "puzzle/Corpus.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+constexpr uint8_t magic[4]          = {'P', 'Z', 'L', 'C'};
+constexpr uint16_t format_version   = 1;
+constexpr std::size_t header_bytes  = 32;
+constexpr uint8_t rank_encoding     = 0;
+constexpr uint8_t packed_encoding   = 1;
+constexpr uint8_t solutions_flag    = 1;
+constexpr uint32_t unsolvable_code  = 0xFFFFFFFF;
+constexpr uint32_t budget_code      = 0xFFFFFFFE;
+constexpr std::size_t flush_bytes   = 1 << 20;
+constexpr std::size_t prefetch_bytes = 8 << 20;
+
+uint64_t load_le(const uint8_t* bytes, std::size_t count) noexcept {
+    uint64_t value = 0;
+    for (std::size_t i = count; i-- > 0;) {
+        value = value << 8 | bytes[i];
+    }
+    return value;
+}
+
+void store_le(uint8_t* bytes, uint64_t value, std::size_t count) noexcept {
+    for (std::size_t i = 0; i < count; i++) {
+        bytes[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+unsigned tile_bits(unsigned side) noexcept {
+    return side < 2 ? 0 : std::bit_width(side * side - 1);
+}
+
+uint8_t default_encoding(unsigned side) noexcept {
+    return side <= Board::max_ranked_size ? rank_encoding : packed_encoding;
+}
+
+std::size_t encoded_bytes(unsigned side, uint8_t encoding) noexcept {
+    const std::size_t cells = static_cast<std::size_t>(side) * side;
+    if (encoding == rank_encoding) {
+        uint64_t permutations = 1;
+        for (std::size_t i = 2; i <= cells; i++) {
+            permutations *= i;
+        }
+        return (std::bit_width(permutations - 1) + 7) / 8;
+    }
+    return (cells * tile_bits(side) + 7) / 8;
+}
+
+void encode_board(const Board& board, uint8_t encoding, uint8_t* out, std::size_t bytes) noexcept {
+    if (encoding == rank_encoding) {
+        store_le(out, board.rank(), bytes);
+        return;
+    }
+    std::memset(out, 0, bytes);
+    const unsigned bits = tile_bits(board.size());
+    std::size_t offset  = 0;
+    for (auto tile : board.tiles()) {
+        for (unsigned bit = 0; bit < bits; bit++, offset++) {
+            out[offset / 8] |= static_cast<uint8_t>(((tile >> bit) & 1) << (offset % 8));
+        }
+    }
+}
+
+struct Header {
+    unsigned side;
+    uint8_t encoding;
+    uint8_t flags;
+    std::size_t board_bytes;
+};
+
+void store_header(uint8_t* out, const Header& header) noexcept {
+    std::memset(out, 0, header_bytes);
+    std::memcpy(out, magic, sizeof(magic));
+    store_le(out + 4, format_version, 2);
+    store_le(out + 6, header.side, 2);
+    out[8] = header.encoding;
+    out[9] = header.flags;
+    store_le(out + 12, header.board_bytes, 4);
+}
+
+std::optional<Header> load_header(const uint8_t* in, std::size_t length) noexcept {
+    if (length < header_bytes || std::memcmp(in, magic, sizeof(magic)) != 0 || load_le(in + 4, 2) != format_version) {
+        return {};
+    }
+    Header header{static_cast<unsigned>(load_le(in + 6, 2)), in[8], in[9], static_cast<std::size_t>(load_le(in + 12, 4))};
+    const bool known_encoding = header.encoding == packed_encoding ||
+                                (header.encoding == rank_encoding && header.side <= Board::max_ranked_size);
+    if (header.side < 2 || not known_encoding || header.board_bytes != encoded_bytes(header.side, header.encoding)) {
+        return {};
+    }
+    return header;
+}
+
+}  // anonymous namespace
+
+std::size_t CorpusChunk::first() const noexcept {
+    return first_index;
+}
+
+std::size_t CorpusChunk::size() const noexcept {
+    return records;
+}
+
+bool CorpusChunk::next(CorpusRecord& record) noexcept {
+    if (remaining == 0) {
+        return false;
+    }
+    remaining--;
+    const uint8_t* cursor = data + position;
+    decode(cursor, layout, record.board);
+    record.status = CorpusRecord::Status::solved;
+    record.moves.clear();
+    position += layout.board_bytes;
+    if ((layout.flags & solutions_flag) == 0) {
+        return true;
+    }
+
+    // The reader has checked that the whole record is inside the file.
+    const auto count = static_cast<uint32_t>(load_le(cursor + layout.board_bytes, 4));
+    position += 4;
+    if (count == unsolvable_code || count == budget_code) {
+        record.status = count == budget_code ? CorpusRecord::Status::budget : CorpusRecord::Status::unsolvable;
+        return true;
+    }
+    record.moves.resize(count);
+    const uint8_t* moves = cursor + layout.board_bytes + 4;
+    for (std::size_t i = 0; i < count; i++) {
+        record.moves[i] = static_cast<Move>((moves[i / 4] >> (2 * (i % 4))) & 3);
+    }
+    position += (static_cast<std::size_t>(count) + 3) / 4;
+    return true;
+}
+
+void CorpusChunk::decode(const uint8_t* bytes, const Layout& layout, Board& board) noexcept {
+    board.side = layout.side;
+    board.data.resize(static_cast<std::size_t>(layout.side) * layout.side);
+    if (layout.encoding == rank_encoding) {
+        Board::unrank(layout.side, load_le(bytes, layout.board_bytes), board.data);
+        return;
+    }
+    const unsigned bits = tile_bits(layout.side);
+    std::size_t offset  = 0;
+    for (auto& tile : board.data) {
+        tile = 0;
+        for (unsigned bit = 0; bit < bits; bit++, offset++) {
+            tile |= static_cast<uint16_t>(((bytes[offset / 8] >> (offset % 8)) & 1) << bit);
+        }
+    }
+}
+
+std::optional<CorpusReader> CorpusReader::open(const std::string& path) noexcept {
+    const int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        return {};
+    }
+    struct stat status {};
+    if (::fstat(descriptor, &status) != 0 || static_cast<std::size_t>(status.st_size) < header_bytes) {
+        ::close(descriptor);
+        return {};
+    }
+    const auto length = static_cast<std::size_t>(status.st_size);
+    void* mapping     = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor);
+    if (mapping == MAP_FAILED) {
+        return {};
+    }
+    ::madvise(mapping, length, MADV_SEQUENTIAL);
+
+    CorpusReader reader;
+    reader.mapping    = static_cast<const uint8_t*>(mapping);
+    reader.length     = length;
+    const auto header = load_header(reader.mapping, length);
+    if (not header) {
+        return {};
+    }
+    reader.layout   = {header->side, header->encoding, header->flags, header->board_bytes};
+    reader.position = header_bytes;
+    return reader;
+}
+
+bool CorpusReader::is_corpus(const std::string& path) noexcept {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    uint8_t head[sizeof(magic)] = {};
+    const bool matches          = std::fread(head, 1, sizeof(head), file) == sizeof(head) &&
+                         std::memcmp(head, magic, sizeof(magic)) == 0;
+    std::fclose(file);
+    return matches;
+}
+
+CorpusReader::CorpusReader(CorpusReader&& other) noexcept {
+    *this = std::move(other);
+}
+
+CorpusReader& CorpusReader::operator=(CorpusReader&& other) noexcept {
+    if (this != &other) {
+        if (mapping != nullptr) {
+            ::munmap(const_cast<uint8_t*>(mapping), length);
+        }
+        mapping  = std::exchange(other.mapping, nullptr);
+        length   = std::exchange(other.length, 0);
+        position = other.position;
+        index    = other.index;
+        advised  = other.advised;
+        layout   = other.layout;
+    }
+    return *this;
+}
+
+CorpusReader::~CorpusReader() {
+    if (mapping != nullptr) {
+        ::munmap(const_cast<uint8_t*>(mapping), length);
+    }
+}
+
+unsigned CorpusReader::side() const noexcept {
+    return layout.side;
+}
+
+bool CorpusReader::has_solutions() const noexcept {
+    return (layout.flags & solutions_flag) != 0;
+}
+
+std::size_t CorpusReader::size() const noexcept {
+    if (has_solutions()) {
+        return 0;
+    }
+    return (length - header_bytes) / layout.board_bytes;
+}
+
+Board CorpusReader::board(std::size_t at) const noexcept {
+    Board board;
+    CorpusChunk::decode(mapping + header_bytes + at * layout.board_bytes, layout, board);
+    return board;
+}
+
+std::optional<CorpusChunk> CorpusReader::next_chunk(std::size_t records) noexcept {
+    const std::size_t start = position;
+    std::size_t count       = 0;
+    if (not has_solutions()) {
+        count = std::min(records, (length - position) / layout.board_bytes);
+        position += count * layout.board_bytes;
+    } else {
+        while (count < records && position + layout.board_bytes + 4 <= length) {
+            const auto moves = static_cast<uint32_t>(load_le(mapping + position + layout.board_bytes, 4));
+            const std::size_t move_bytes =
+                moves == unsolvable_code || moves == budget_code ? 0 : (static_cast<std::size_t>(moves) + 3) / 4;
+            const std::size_t end = position + layout.board_bytes + 4 + move_bytes;
+            if (end > length) {
+                break;
+            }
+            position = end;
+            count++;
+        }
+    }
+    if (count == 0) {
+        return {};
+    }
+
+    // Keep the kernel reading ahead of the chunks being decoded.
+    if (position + prefetch_bytes > advised && advised < length) {
+        static const auto page  = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        const std::size_t from  = std::max(advised, start) & ~(page - 1);
+        const std::size_t until = std::min(length, position + 2 * prefetch_bytes);
+        ::madvise(const_cast<uint8_t*>(mapping) + from, until - from, MADV_WILLNEED);
+        advised = until;
+    }
+
+    CorpusChunk chunk;
+    chunk.data        = mapping;
+    chunk.position    = start;
+    chunk.first_index = index;
+    chunk.records     = count;
+    chunk.remaining   = count;
+    chunk.layout      = layout;
+    index += count;
+    return chunk;
+}
+
+bool CorpusReader::next(CorpusRecord& record) noexcept {
+    auto chunk = next_chunk(1);
+    return chunk && chunk->next(record);
+}
+
+void CorpusReader::rewind() noexcept {
+    position = header_bytes;
+    index    = 0;
+    advised  = 0;
+}
+
+std::optional<CorpusWriter> CorpusWriter::open(const std::string& path, unsigned side, bool with_solutions,
+                                               bool append) noexcept {
+    if (side < 2) {
+        return {};
+    }
+    const Header header{side, default_encoding(side), static_cast<uint8_t>(with_solutions ? solutions_flag : 0),
+                        encoded_bytes(side, default_encoding(side))};
+
+    CorpusWriter writer;
+    writer.board_side  = header.side;
+    writer.encoding    = header.encoding;
+    writer.flags       = header.flags;
+    writer.board_bytes = header.board_bytes;
+
+    if (append) {
+        writer.file = std::fopen(path.c_str(), "r+b");
+    }
+    if (writer.file != nullptr) {
+        uint8_t existing[header_bytes] = {};
+        const auto read                = std::fread(existing, 1, header_bytes, writer.file);
+        const auto found               = load_header(existing, read);
+        if (read != 0 && (not found || found->side != header.side || found->flags != header.flags ||
+                          found->encoding != header.encoding)) {
+            return {};
+        }
+        if (read != 0) {
+            std::fseek(writer.file, 0, SEEK_END);
+            return writer;
+        }
+        std::fclose(std::exchange(writer.file, nullptr));
+    }
+
+    writer.file = std::fopen(path.c_str(), "wb");
+    if (writer.file == nullptr) {
+        return {};
+    }
+    uint8_t bytes[header_bytes];
+    store_header(bytes, header);
+    if (std::fwrite(bytes, 1, header_bytes, writer.file) != header_bytes) {
+        return {};
+    }
+    return writer;
+}
+
+CorpusWriter::CorpusWriter(CorpusWriter&& other) noexcept {
+    *this = std::move(other);
+}
+
+CorpusWriter& CorpusWriter::operator=(CorpusWriter&& other) noexcept {
+    if (this != &other) {
+        if (file != nullptr) {
+            flush();
+            std::fclose(file);
+        }
+        file        = std::exchange(other.file, nullptr);
+        board_side  = other.board_side;
+        encoding    = other.encoding;
+        flags       = other.flags;
+        board_bytes = other.board_bytes;
+        buffer      = std::move(other.buffer);
+    }
+    return *this;
+}
+
+CorpusWriter::~CorpusWriter() {
+    if (file != nullptr) {
+        flush();
+        std::fclose(file);
+    }
+}
+
+unsigned CorpusWriter::side() const noexcept {
+    return board_side;
+}
+
+bool CorpusWriter::has_solutions() const noexcept {
+    return (flags & solutions_flag) != 0;
+}
+
+bool CorpusWriter::write(const Board& board) noexcept {
+    if (has_solutions()) {
+        return false;
+    }
+    CorpusRecord record;
+    record.board = board;
+    return write(record);
+}
+
+bool CorpusWriter::write(const CorpusRecord& record) noexcept {
+    if (file == nullptr || record.board.size() != board_side || not record.board.validate()) {
+        return false;
+    }
+    const std::size_t start = buffer.size();
+    buffer.resize(start + board_bytes);
+    encode_board(record.board, encoding, buffer.data() + start, board_bytes);
+
+    if (has_solutions()) {
+        uint32_t count = static_cast<uint32_t>(record.moves.size());
+        if (record.status != CorpusRecord::Status::solved) {
+            count = record.status == CorpusRecord::Status::budget ? budget_code : unsolvable_code;
+        }
+        const std::size_t move_bytes =
+            record.status == CorpusRecord::Status::solved ? (record.moves.size() + 3) / 4 : 0;
+        const std::size_t offset = buffer.size();
+        buffer.resize(offset + 4 + move_bytes, 0);
+        store_le(buffer.data() + offset, count, 4);
+        for (std::size_t i = 0; i < move_bytes * 4 && i < record.moves.size(); i++) {
+            buffer[offset + 4 + i / 4] |= static_cast<uint8_t>(static_cast<unsigned>(record.moves[i]) << (2 * (i % 4)));
+        }
+    }
+
+    return buffer.size() < flush_bytes || flush();
+}
+
+bool CorpusWriter::flush() noexcept {
+    if (file == nullptr) {
+        return false;
+    }
+    const bool written = std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+    buffer.clear();
+    return written && std::fflush(file) == 0;
+}
@@ -0,0 +1,91 @@
+#include "puzzle/DistanceTable.hpp"
+
+#include <utility>
+
+#include "puzzle/StateSpace.hpp"
+
+std::optional<DistanceTable> DistanceTable::build(unsigned size) noexcept {
+    if (size < 2 || size > max_size) {
+        return {};
+    }
+    DistanceTable table;
+    table.side = size;
+    table.owned.assign(StateSpace::ranks(size), unsolvable);
+    // Moves are reversible, so the distance to the goal is the distance from it.
+    const auto counts = StateSpace::enumerate(size, StateSpace::Options{}, [&](unsigned depth, auto ranks) {
+        for (auto rank : ranks) {
+            table.owned[rank] = static_cast<uint8_t>(depth);
+        }
+    });
+    if (not counts) {
+        return {};
+    }
+    table.distances = table.owned;
+    return table;
+}
+
+std::optional<DistanceTable> DistanceTable::load(const std::string& path,
+                                                 const TableFile::MapOptions& options) noexcept {
+    auto file = TableFile::open(path, kind, options);
+    if (not file) {
+        return {};
+    }
+    const auto size = file->parameters()[0];
+    if (size < 2 || size > max_size || file->payload().size() != StateSpace::ranks(static_cast<unsigned>(size))) {
+        return {};
+    }
+
+    DistanceTable table;
+    table.side      = static_cast<unsigned>(size);
+    table.distances = file->payload();
+    table.file      = std::move(file);
+    return table;
+}
+
+std::optional<DistanceTable> DistanceTable::load(const std::string& path) noexcept {
+    return load(path, TableFile::MapOptions{});
+}
+
+std::optional<DistanceTable> DistanceTable::load_or_build(const std::string& path, unsigned size) noexcept {
+    return TableFile::load_or_make<DistanceTable>(
+        path, [&](const DistanceTable& table) { return table.size() == size; }, [&]() { return build(size); });
+}
+
+bool DistanceTable::save(const std::string& path) const noexcept {
+    return TableFile::write(path, kind, {side, 0, 0, 0}, distances);
+}
+
+unsigned DistanceTable::size() const noexcept {
+    return side;
+}
+
+bool DistanceTable::supports(const Board& board) const noexcept {
+    return side != 0 && board.size() == side && board.validate();
+}
+
+std::optional<unsigned> DistanceTable::distance(const Board& board) const noexcept {
+    if (not supports(board) || distances[board.rank()] == unsolvable) {
+        return {};
+    }
+    return distances[board.rank()];
+}
+
+std::vector<Board> DistanceTable::path(const Board& board) const noexcept {
+    auto remaining = distance(board);
+    if (not remaining) {
+        return {};
+    }
+    std::vector<Board> result{board};
+    result.reserve(*remaining + 1);
+    while (*remaining > 0) {
+        for (auto move : {Move::up, Move::down, Move::left, Move::right}) {
+            auto neighbour = result.back().moved(move);
+            if (neighbour && distances[neighbour->rank()] == *remaining - 1) {
+                result.push_back(std::move(*neighbour));
+                break;
+            }
+        }
+        --*remaining;
+    }
+    return result;
+}
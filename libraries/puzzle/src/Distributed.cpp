@@ -0,0 +1,832 @@
+#include "Distributed.hpp"
+
+#include "Mix.hpp"
+
+#include <arpa/inet.h>
+#include <dirent.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <chrono>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace distributed {
+
+namespace {
+
+// Frames between the processes. Workers send each other only `nodes`; the others pass between
+// the coordinator and a worker.
+enum class kind : uint8_t {
+    nodes,   // the bound of the iteration, then boards with their moves from the start and last move
+    probe,   // asks for a `status` as soon as the worker has nothing left to expand
+    status,  // frames of nodes sent and received, boards expanded and generated, next bound
+    found,   // the goal was reached, in this many moves
+    halt,    // the search is over: drop all work and keep what is recorded for `parent`
+    parent,  // asks for the last move a board was reached by, and answers with it
+    quit,
+};
+
+constexpr std::size_t frame_header = sizeof(uint32_t) + sizeof(kind);
+// Last move of the start board.
+constexpr uint8_t no_move    = 4;
+constexpr unsigned unbounded = std::numeric_limits<unsigned>::max();
+
+// What identifies a board, as in the single-process searches, and which worker owns it.
+uint64_t key_of(const Board& board) noexcept {
+    return board.size() <= Board::max_ranked_size ? board.rank() : board.hash();
+}
+
+std::size_t owner_of(uint64_t key, std::size_t workers) noexcept {
+    return mix(key) % workers;
+}
+
+// Every process runs the same program, so values travel in the byte order of the host.
+template <typename T>
+void put(std::string& out, T value) noexcept {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void put(std::string& out, const Board& board) noexcept {
+    const auto tiles = board.tiles();
+    out.append(reinterpret_cast<const char*>(tiles.data()), tiles.size_bytes());
+}
+
+void put_frame(std::string& out, kind type, std::string_view payload = {}) noexcept {
+    put(out, static_cast<uint32_t>(payload.size()));
+    put(out, type);
+    out.append(payload);
+}
+
+// Reads back what `put` wrote. A payload cut short reads as zeros.
+class reader {
+public:
+    explicit reader(std::string_view payload) noexcept : rest(payload) {}
+
+    template <typename T>
+    [[nodiscard]] T get() noexcept {
+        T value{};
+        const auto size = std::min(sizeof(value), rest.size());
+        std::memcpy(&value, rest.data(), size);
+        rest.remove_prefix(size);
+        return value;
+    }
+
+    [[nodiscard]] Board board(std::size_t side) noexcept {
+        std::vector<uint16_t> tiles(side * side);
+        const auto size = std::min(tiles.size() * sizeof(uint16_t), rest.size());
+        std::memcpy(tiles.data(), rest.data(), size);
+        rest.remove_prefix(size);
+        return Board(side, tiles);
+    }
+
+    [[nodiscard]] std::size_t left() const noexcept {
+        return rest.size();
+    }
+
+private:
+    std::string_view rest;
+};
+
+// Sends all of `data`, waiting for room on the socket.
+bool send_all(int socket, std::string_view data) noexcept {
+    while (not data.empty()) {
+        const auto sent = ::send(socket, data.data(), data.size(), MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            return false;
+        }
+        data.remove_prefix(static_cast<std::size_t>(sent));
+    }
+    return true;
+}
+
+// Frames arriving on one socket.
+class inbox {
+public:
+    // Takes in what has arrived; with `wait`, waits for at least one byte. False once the other
+    // end has closed or failed.
+    bool receive(int socket, bool wait) noexcept {
+        char chunk[1 << 16];
+        while (true) {
+            const auto received = ::recv(socket, chunk, sizeof(chunk), wait ? 0 : MSG_DONTWAIT);
+            if (received > 0) {
+                buffer.append(chunk, static_cast<std::size_t>(received));
+                if (wait) {
+                    return true;
+                }
+                continue;
+            }
+            if (received < 0 && errno == EINTR) {
+                continue;
+            }
+            return received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        }
+    }
+
+    // The next whole frame, if it has arrived. The payload stays valid until the next call.
+    [[nodiscard]] std::optional<std::pair<kind, std::string_view>> next() noexcept {
+        if (start == buffer.size()) {
+            buffer.clear();
+            start = 0;
+        } else if (start > buffer.size() / 2) {
+            buffer.erase(0, start);
+            start = 0;
+        }
+        if (buffer.size() - start < frame_header) {
+            return {};
+        }
+        uint32_t size = 0;
+        std::memcpy(&size, buffer.data() + start, sizeof(size));
+        if (buffer.size() - start < frame_header + size) {
+            return {};
+        }
+        const auto type    = static_cast<kind>(buffer[start + sizeof(size)]);
+        const auto payload = std::string_view(buffer).substr(start + frame_header, size);
+        start += frame_header + size;
+        return std::pair{type, payload};
+    }
+
+private:
+    std::string buffer;
+    std::size_t start = 0;
+};
+
+// Where a worker listens for the others: a Unix domain socket in a directory, or a localhost TCP
+// port when no directory is given.
+struct endpoint {
+    int listener = -1;
+    std::string path;
+    uint16_t port = 0;
+};
+
+std::optional<endpoint> listen_on(const std::string& directory, const std::string& name) noexcept {
+    endpoint result;
+    if (not directory.empty()) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        result.path        = directory + "/" + name + ".sock";
+        if (result.path.size() >= sizeof(address.sun_path)) {
+            return {};
+        }
+        std::memcpy(address.sun_path, result.path.c_str(), result.path.size() + 1);
+        ::unlink(result.path.c_str());
+        result.listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (result.listener < 0 ||
+            ::bind(result.listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            if (result.listener >= 0) {
+                ::close(result.listener);
+            }
+            return {};
+        }
+    } else {
+        sockaddr_in address{};
+        address.sin_family      = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        result.listener         = ::socket(AF_INET, SOCK_STREAM, 0);
+        socklen_t length        = sizeof(address);
+        if (result.listener < 0 ||
+            ::bind(result.listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+            ::getsockname(result.listener, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+            if (result.listener >= 0) {
+                ::close(result.listener);
+            }
+            return {};
+        }
+        result.port = ntohs(address.sin_port);
+    }
+    if (::listen(result.listener, SOMAXCONN) != 0) {
+        ::close(result.listener);
+        if (not result.path.empty()) {
+            ::unlink(result.path.c_str());
+        }
+        return {};
+    }
+    return result;
+}
+
+int connect_to(const endpoint& target) noexcept {
+    int socket = -1;
+    int status = -1;
+    if (not target.path.empty()) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::memcpy(address.sun_path, target.path.c_str(), target.path.size() + 1);
+        socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        status = socket < 0 ? -1 : ::connect(socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+    } else {
+        sockaddr_in address{};
+        address.sin_family      = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port        = htons(target.port);
+        socket                  = ::socket(AF_INET, SOCK_STREAM, 0);
+        status = socket < 0 ? -1 : ::connect(socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+    }
+    if (status != 0 && socket >= 0) {
+        ::close(socket);
+        return -1;
+    }
+    return socket;
+}
+
+// One worker process: the boards it owns that were reached in this iteration, with the fewest
+// moves they were reached in and the last move of that path, and those it still has to expand.
+template <Heuristic H>
+class worker {
+public:
+    worker(const H& heuristic, std::size_t side, std::size_t index, std::size_t batch, int coordinator,
+           const std::vector<int>& sockets) noexcept
+        : heuristic(heuristic),
+          side(side),
+          index(index),
+          batch(batch),
+          node_bytes(sizeof(uint16_t) + sizeof(uint8_t) + side * side * sizeof(uint16_t)),
+          coordinator(coordinator),
+          peers(sockets.size()) {
+        for (std::size_t other = 0; other < sockets.size(); other++) {
+            peers[other].socket = sockets[other];
+        }
+    }
+
+    // Serves until told to quit or the coordinator is gone.
+    void run() noexcept {
+        std::vector<pollfd> polled(peers.size() + 1);
+        while (not quitting) {
+            polled[0] = {coordinator, POLLIN, 0};
+            for (std::size_t other = 0; other < peers.size(); other++) {
+                const auto& peer   = peers[other];
+                const short events = static_cast<short>(POLLIN | (peer.written < peer.out.size() ? POLLOUT : 0));
+                polled[other + 1]  = {peer.socket, events, 0};
+            }
+            if (::poll(polled.data(), polled.size(), stack.empty() ? -1 : 0) < 0 && errno != EINTR) {
+                return;
+            }
+            if (polled[0].revents != 0) {
+                if (not from_coordinator.receive(coordinator, false)) {
+                    return;
+                }
+                while (auto frame = from_coordinator.next()) {
+                    handle(frame->first, frame->second);
+                }
+            }
+            for (std::size_t other = 0; other < peers.size(); other++) {
+                auto& peer = peers[other];
+                if ((polled[other + 1].revents & (POLLIN | POLLHUP | POLLERR)) != 0) {
+                    if (not peer.in.receive(peer.socket, false)) {
+                        ::close(peer.socket);
+                        peer.socket = -1;
+                    }
+                    while (auto frame = peer.in.next()) {
+                        if (frame->first == kind::nodes) {
+                            take(frame->second);
+                        }
+                    }
+                }
+            }
+
+            // A round of expansions, after which the batches go out however full they are.
+            for (std::size_t round = 0; round < batch && not stack.empty(); round++) {
+                auto current = std::move(stack.back());
+                stack.pop_back();
+                expand(current);
+            }
+            for (std::size_t other = 0; other < peers.size(); other++) {
+                flush(other);
+                write(peers[other]);
+            }
+            if (probed && stack.empty()) {
+                std::string status;
+                put<uint64_t>(status, sent);
+                put<uint64_t>(status, received);
+                put<uint64_t>(status, expanded);
+                put<uint64_t>(status, generated);
+                put<uint32_t>(status, next_bound);
+                put<uint32_t>(status, bound);
+                tell(kind::status, status);
+                probed = false;
+            }
+        }
+    }
+
+private:
+    struct node {
+        Board board;
+        unsigned moves;
+        uint8_t last;
+    };
+
+    struct entry {
+        unsigned moves;
+        uint8_t last;
+    };
+
+    struct peer {
+        int socket = -1;
+        inbox in;
+        // Framed bytes not yet written, and nodes for the peer not yet framed.
+        std::string out;
+        std::size_t written = 0;
+        std::string pending;
+    };
+
+    void handle(kind type, std::string_view payload) noexcept {
+        switch (type) {
+            case kind::nodes:
+                take(payload);
+                break;
+            case kind::probe:
+                probed = true;
+                break;
+            case kind::halt:
+                halted = true;
+                stack.clear();
+                for (auto& peer : peers) {
+                    peer.pending.clear();
+                }
+                break;
+            case kind::parent: {
+                reader in(payload);
+                const auto known = table.find(key_of(in.board(side)));
+                std::string answer;
+                put<uint8_t>(answer, known != table.end() ? known->second.last : no_move);
+                tell(kind::parent, answer);
+                break;
+            }
+            case kind::quit:
+                quitting = true;
+                break;
+            default:
+                break;
+        }
+    }
+
+    // A frame of nodes; the first of a new bound starts its iteration here.
+    void take(std::string_view payload) noexcept {
+        reader in(payload);
+        received++;
+        const auto frame_bound = in.get<uint32_t>();
+        if (frame_bound != bound) {
+            bound      = frame_bound;
+            next_bound = unbounded;
+            halted     = false;
+            table.clear();
+            stack.clear();
+        }
+        while (not halted && in.left() >= node_bytes) {
+            const unsigned moves = in.get<uint16_t>();
+            const auto last      = in.get<uint8_t>();
+            auto board           = in.board(side);
+            const auto key       = key_of(board);
+            accept(std::move(board), key, moves, last);
+        }
+    }
+
+    // A board this worker owns, dropped if it was reached in as few moves before.
+    void accept(Board&& board, uint64_t key, unsigned moves, uint8_t last) noexcept {
+        const auto [known, added] = table.try_emplace(key, entry{moves, last});
+        if (not added) {
+            if (known->second.moves <= moves) {
+                return;
+            }
+            known->second = {moves, last};
+        }
+        if (board.is_goal()) {
+            std::string found;
+            put<uint32_t>(found, moves);
+            tell(kind::found, found);
+            return;
+        }
+        stack.push_back({std::move(board), moves, last});
+    }
+
+    // Children within the bound go to their owners, never back to the parent.
+    void expand(const node& current) noexcept {
+        expanded++;
+        H estimate = heuristic;
+        estimate.init(current.board);
+        for (auto move : {Move::up, Move::down, Move::left, Move::right}) {
+            if (current.last != no_move && move == opposite(static_cast<Move>(current.last))) {
+                continue;
+            }
+            auto next = current.board.moved(move);
+            if (not next) {
+                continue;
+            }
+            generated++;
+            H next_estimate = estimate;
+            next_estimate.update(*next, move);
+            const unsigned f = current.moves + 1 + next_estimate.value();
+            if (f > bound) {
+                next_bound = std::min(next_bound, f);
+                continue;
+            }
+            const auto key   = key_of(*next);
+            const auto owner = owner_of(key, peers.size());
+            if (owner == index) {
+                accept(std::move(*next), key, current.moves + 1, static_cast<uint8_t>(move));
+                continue;
+            }
+            auto& pending = peers[owner].pending;
+            put<uint16_t>(pending, static_cast<uint16_t>(current.moves + 1));
+            put<uint8_t>(pending, static_cast<uint8_t>(move));
+            put(pending, *next);
+            if (pending.size() >= batch * node_bytes) {
+                flush(owner);
+            }
+        }
+    }
+
+    void flush(std::size_t other) noexcept {
+        auto& peer = peers[other];
+        if (peer.pending.empty()) {
+            return;
+        }
+        std::string payload;
+        payload.reserve(sizeof(uint32_t) + peer.pending.size());
+        put<uint32_t>(payload, bound);
+        payload += peer.pending;
+        put_frame(peer.out, kind::nodes, payload);
+        peer.pending.clear();
+        sent++;
+    }
+
+    // As much of what is framed for a peer as its socket takes without waiting.
+    void write(peer& target) noexcept {
+        while (target.socket >= 0 && target.written < target.out.size()) {
+            const auto sent_bytes = ::send(target.socket, target.out.data() + target.written,
+                                           target.out.size() - target.written, MSG_DONTWAIT | MSG_NOSIGNAL);
+            if (sent_bytes < 0 && errno == EINTR) {
+                continue;
+            }
+            if (sent_bytes <= 0) {
+                break;
+            }
+            target.written += static_cast<std::size_t>(sent_bytes);
+        }
+        if (target.written == target.out.size()) {
+            target.out.clear();
+            target.written = 0;
+        }
+    }
+
+    void tell(kind type, std::string_view payload) noexcept {
+        std::string frame;
+        put_frame(frame, type, payload);
+        if (not send_all(coordinator, frame)) {
+            quitting = true;
+        }
+    }
+
+    const H heuristic;
+    const std::size_t side;
+    const std::size_t index;
+    const std::size_t batch;
+    const std::size_t node_bytes;
+    const int coordinator;
+    inbox from_coordinator;
+    std::vector<peer> peers;
+
+    unsigned bound      = unbounded;
+    unsigned next_bound = unbounded;
+    std::unordered_map<uint64_t, entry> table;
+    std::vector<node> stack;
+    bool probed   = false;
+    bool halted   = false;
+    bool quitting = false;
+    uint64_t sent      = 0;
+    uint64_t received  = 0;
+    uint64_t expanded  = 0;
+    uint64_t generated = 0;
+};
+
+// Closes what a forked worker inherited but the standard streams and `keep`: the caller's other
+// sockets, files and searches are none of its business, and holding them would keep them open.
+void close_inherited(std::initializer_list<int> keep) noexcept {
+    std::vector<int> inherited;
+    if (DIR* directory = ::opendir("/proc/self/fd")) {
+        while (const dirent* entry = ::readdir(directory)) {
+            const int descriptor = std::atoi(entry->d_name);
+            if (descriptor > STDERR_FILENO && descriptor != ::dirfd(directory) &&
+                std::find(keep.begin(), keep.end(), descriptor) == keep.end()) {
+                inherited.push_back(descriptor);
+            }
+        }
+        ::closedir(directory);
+    }
+    for (const int descriptor : inherited) {
+        ::close(descriptor);
+    }
+}
+
+// The life of a forked worker: it keeps only its own listener and its own end of its channel to
+// the coordinator, connects to the workers before it and is connected to by those after it.
+template <Heuristic H>
+void serve(const H& heuristic, std::size_t side, std::size_t index, std::size_t batch,
+           const std::vector<endpoint>& endpoints, const std::vector<std::array<int, 2>>& channels) noexcept {
+    const std::size_t workers = endpoints.size();
+    close_inherited({endpoints[index].listener, channels[index][1]});
+    // A worker that never connects leaves the others waiting for no longer than this.
+    const timeval patience{10, 0};
+    ::setsockopt(endpoints[index].listener, SOL_SOCKET, SO_RCVTIMEO, &patience, sizeof(patience));
+    std::vector<int> sockets(workers, -1);
+    for (std::size_t other = 0; other < index; other++) {
+        sockets[other] = connect_to(endpoints[other]);
+        std::string hello;
+        put<uint32_t>(hello, static_cast<uint32_t>(index));
+        if (sockets[other] < 0 || not send_all(sockets[other], hello)) {
+            return;
+        }
+    }
+    for (std::size_t count = index + 1; count < workers; count++) {
+        const int socket = ::accept(endpoints[index].listener, nullptr, nullptr);
+        uint32_t other   = 0;
+        if (socket < 0 || ::recv(socket, &other, sizeof(other), MSG_WAITALL) != sizeof(other) || other <= index ||
+            other >= workers || sockets[other] >= 0) {
+            return;
+        }
+        sockets[other] = socket;
+    }
+    ::close(endpoints[index].listener);
+    worker<H>(heuristic, side, index, batch, channels[index][1], sockets).run();
+}
+
+// The calling process's side: a channel to every worker.
+class coordinator {
+public:
+    explicit coordinator(std::vector<int> sockets) noexcept
+        : sockets(std::move(sockets)), inboxes(this->sockets.size()) {}
+    coordinator(const coordinator&)            = delete;
+    coordinator& operator=(const coordinator&) = delete;
+    ~coordinator() {
+        for (int socket : sockets) {
+            ::close(socket);
+        }
+    }
+
+    bool send(std::size_t worker, kind type, std::string_view payload = {}) noexcept {
+        std::string frame;
+        put_frame(frame, type, payload);
+        return send_all(sockets[worker], frame);
+    }
+
+    bool broadcast(kind type) noexcept {
+        bool all = true;
+        for (std::size_t worker = 0; worker < sockets.size(); worker++) {
+            all = send(worker, type) && all;
+        }
+        return all;
+    }
+
+    // The next frame of `type` from a worker, taking note of `found` on the way and skipping the
+    // rest; nothing if the worker is lost.
+    std::optional<std::string> receive(std::size_t worker, kind type) noexcept {
+        while (true) {
+            while (auto frame = inboxes[worker].next()) {
+                if (frame->first == kind::found) {
+                    reader in(frame->second);
+                    found = in.get<uint32_t>();
+                }
+                if (frame->first == type) {
+                    return std::string(frame->second);
+                }
+            }
+            if (not inboxes[worker].receive(sockets[worker], true)) {
+                return {};
+            }
+        }
+    }
+
+    std::optional<unsigned> found;
+
+private:
+    std::vector<int> sockets;
+    std::vector<inbox> inboxes;
+};
+
+// Iterations until the goal is found, the budget runs out or a worker is lost, and the path from
+// the recorded moves when the goal is found. False if a worker was lost.
+template <Heuristic H>
+bool coordinate(const Board& start, const SolveOptions& options, const H& heuristic, coordinator& workers,
+                std::size_t count, Result& result) noexcept {
+    const auto started = std::chrono::steady_clock::now();
+    const auto over    = [&](std::size_t expanded) {
+        return (options.node_budget != 0 && expanded >= options.node_budget) ||
+               (options.time_budget.count() != 0 && std::chrono::steady_clock::now() - started >= options.time_budget);
+    };
+
+    H estimate = heuristic;
+    estimate.init(start);
+    unsigned bound   = estimate.value();
+    uint64_t sent    = 0;
+    const auto first = owner_of(key_of(start), count);
+    while (not workers.found) {
+        // Every worker learns the bound, the owner of the start along with the start.
+        for (std::size_t worker = 0; worker < count; worker++) {
+            std::string payload;
+            put<uint32_t>(payload, bound);
+            if (worker == first) {
+                put<uint16_t>(payload, 0);
+                put<uint8_t>(payload, no_move);
+                put(payload, start);
+            }
+            if (not workers.send(worker, kind::nodes, payload)) {
+                return false;
+            }
+            sent++;
+        }
+
+        // Waves of probes until two in a row see every worker idle and every frame of nodes sent
+        // received, by the same counts (Mattern's four counters).
+        std::pair<uint64_t, uint64_t> previous{std::numeric_limits<uint64_t>::max(), 0};
+        unsigned next_bound = unbounded;
+        while (not workers.found) {
+            if (not workers.broadcast(kind::probe)) {
+                return false;
+            }
+            std::pair<uint64_t, uint64_t> counts{sent, 0};
+            std::size_t expanded  = 0;
+            std::size_t generated = 0;
+            next_bound            = unbounded;
+            for (std::size_t worker = 0; worker < count; worker++) {
+                const auto status = workers.receive(worker, kind::status);
+                if (not status) {
+                    return false;
+                }
+                reader in(*status);
+                counts.first += in.get<uint64_t>();
+                counts.second += in.get<uint64_t>();
+                expanded += in.get<uint64_t>();
+                generated += in.get<uint64_t>();
+                const auto least = in.get<uint32_t>();
+                if (in.get<uint32_t>() == bound) {
+                    next_bound = std::min(next_bound, least);
+                }
+            }
+            result.stats.expanded  = expanded;
+            result.stats.generated = generated;
+            if (workers.found) {
+                break;
+            }
+            if (over(expanded)) {
+                result.stats.budget_exhausted = true;
+                return true;
+            }
+            if (counts.first == counts.second && counts == previous) {
+                break;
+            }
+            previous = counts;
+        }
+        if (workers.found) {
+            break;
+        }
+        if (next_bound == unbounded) {
+            return true;
+        }
+        bound = next_bound;
+    }
+
+    // Back from the goal by the last move its owner recorded for every board, each recorded with
+    // fewer moves than the one after it.
+    if (not workers.broadcast(kind::halt)) {
+        return false;
+    }
+    std::vector<Board> path{Board::create_goal(static_cast<unsigned>(start.size()))};
+    for (unsigned step = 0; step < *workers.found; step++) {
+        const Board board = path.back();
+        const auto owner  = owner_of(key_of(board), count);
+        std::string query;
+        put(query, board);
+        if (not workers.send(owner, kind::parent, query)) {
+            return false;
+        }
+        const auto answer = workers.receive(owner, kind::parent);
+        if (not answer) {
+            return false;
+        }
+        auto previous = answer->size() == 1 && static_cast<uint8_t>((*answer)[0]) < no_move
+                            ? board.moved(opposite(static_cast<Move>((*answer)[0])))
+                            : std::nullopt;
+        if (not previous) {
+            return true;
+        }
+        path.push_back(std::move(*previous));
+    }
+    if (path.back() == start) {
+        std::reverse(path.begin(), path.end());
+        result.path = std::move(path);
+    }
+    return true;
+}
+
+}  // anonymous namespace
+
+template <Heuristic H>
+Result search(const Board& start, const SolveOptions& options, const H& heuristic) noexcept {
+    Result result;
+    const std::size_t count = std::max(1u, options.distributed_workers);
+    const std::size_t batch = std::max<std::size_t>(1, options.distributed_batch);
+
+    // Every listener and channel is made before the first fork, so that each worker knows where
+    // all the others listen. Names tell concurrent searches of the process apart.
+    static std::atomic<unsigned> searches{0};
+    const auto name = "puzzle-" + std::to_string(::getpid()) + "-" + std::to_string(searches++) + "-";
+    std::vector<endpoint> endpoints;
+    std::vector<std::array<int, 2>> channels;
+    bool ready = true;
+    for (std::size_t index = 0; index < count && ready; index++) {
+        auto listening = listen_on(options.distributed_socket_dir, name + std::to_string(index));
+        std::array<int, 2> channel{-1, -1};
+        ready = listening && ::socketpair(AF_UNIX, SOCK_STREAM, 0, channel.data()) == 0;
+        if (listening) {
+            endpoints.push_back(std::move(*listening));
+        }
+        if (ready) {
+            channels.push_back(channel);
+        }
+    }
+
+    std::vector<pid_t> children;
+    for (std::size_t index = 0; index < count && ready; index++) {
+        const pid_t child = ::fork();
+        if (child == 0) {
+            serve(heuristic, start.size(), index, batch, endpoints, channels);
+            ::_exit(0);
+        }
+        ready = child > 0;
+        if (ready) {
+            children.push_back(child);
+        }
+    }
+
+    std::vector<int> sockets;
+    for (const auto& channel : channels) {
+        ::close(channel[1]);
+        sockets.push_back(channel[0]);
+    }
+    for (const auto& listening : endpoints) {
+        ::close(listening.listener);
+    }
+    {
+        coordinator workers(std::move(sockets));
+        ready = ready && coordinate(start, options, heuristic, workers, count, result);
+        if (ready) {
+            workers.broadcast(kind::quit);
+        }
+    }
+
+    // Workers that were told to quit are gone or about to be; after a failure the others may be
+    // waiting for a peer that is not coming.
+    for (const pid_t child : children) {
+        if (not ready) {
+            ::kill(child, SIGKILL);
+        }
+        while (::waitpid(child, nullptr, 0) < 0 && errno == EINTR) {
+        }
+    }
+    for (const auto& listening : endpoints) {
+        if (not listening.path.empty()) {
+            ::unlink(listening.path.c_str());
+        }
+    }
+    return result;
+}
+
+bool forkable() noexcept {
+    std::size_t threads = 0;
+    if (DIR* directory = ::opendir("/proc/self/task")) {
+        while (const dirent* entry = ::readdir(directory)) {
+            threads += entry->d_name[0] != '.';
+        }
+        ::closedir(directory);
+    }
+    return threads == 1;
+}
+
+template Result search(const Board&, const SolveOptions&, const ManhattanHeuristic&) noexcept;
+template Result search(const Board&, const SolveOptions&, const LinearConflictHeuristic&) noexcept;
+template Result search(const Board&, const SolveOptions&, const PatternHeuristic&) noexcept;
+template Result search(const Board&, const SolveOptions&,
+                       const MaxHeuristic<LinearConflictHeuristic, PatternHeuristic>&) noexcept;
+template Result search(const Board&, const SolveOptions&,
+                       const MaxHeuristic<LinearConflictHeuristic, PatternHeuristic, PatternHeuristic>&) noexcept;
+
+}  // namespace distributed
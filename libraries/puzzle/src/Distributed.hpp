@@ -0,0 +1,40 @@
+#ifndef PUZZLE_DISTRIBUTED_HPP
+#define PUZZLE_DISTRIBUTED_HPP
+
+#include <vector>
+
+#include "puzzle/Board.hpp"
+#include "puzzle/Heuristic.hpp"
+#include "puzzle/Solver.hpp"
+
+// Transposition-driven scheduling, behind `SolveOptions::distributed_workers`.
+namespace distributed {
+
+struct Result {
+    // Empty when the budget ran out, or when a worker could not be started or was lost.
+    std::vector<Board> path;
+    SolveStats stats;
+};
+
+// Iterative deepening spread over worker processes that each own the boards whose hash falls to
+// them. A board is sent to its owner, which drops it if it has already reached it with as few
+// moves in this iteration and otherwise expands it, sending on the children within the bound.
+// Boards travel in batches over a mesh of sockets between the workers. The calling process
+// coordinates: it starts every iteration, detects when no worker has work left and no batch is
+// in flight, and rebuilds the path from the moves the owners recorded.
+//
+// The workers are forked, so the calling process must run no other thread: see `forkable`. Each
+// keeps only the descriptors of the search and the standard streams of what it inherits.
+//
+// Instantiated for the heuristics of `Solver::solve`.
+template <Heuristic H>
+[[nodiscard]] Result search(const Board& start, const SolveOptions& options, const H& heuristic) noexcept;
+
+// Whether workers can be forked from the calling process: only while it runs a single thread, as
+// a child of a process with others inherits their locks in whatever state they were left. False
+// where the threads of the process cannot be counted.
+[[nodiscard]] bool forkable() noexcept;
+
+}  // namespace distributed
+
+#endif  // PUZZLE_DISTRIBUTED_HPP
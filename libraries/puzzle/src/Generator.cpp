@@ -0,0 +1,202 @@
+#include "puzzle/Generator.hpp"
+
+#include <cstdlib>
+
+#include "puzzle/Solver.hpp"
+
+namespace {
+
+__extension__ using uint128 = unsigned __int128;
+
+constexpr unsigned no_move = 4;
+
+// Blank displacement for up, down, left and right; `move ^ 1` is the reverse of `move`.
+constexpr int move_rows[4] = {-1, 1, 0, 0};
+constexpr int move_cols[4] = {0, 0, -1, 1};
+
+unsigned tile_distance(std::size_t size, std::size_t value, std::size_t cell) noexcept {
+    const auto goal = value - 1;
+    return std::abs(static_cast<int>(goal / size) - static_cast<int>(cell / size)) +
+           std::abs(static_cast<int>(goal % size) - static_cast<int>(cell % size));
+}
+
+}  // anonymous namespace
+
+Generator::Generator(uint64_t seed) noexcept : engine(seed) {}
+
+Generator& Generator::local() noexcept {
+    thread_local Generator generator((static_cast<uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}());
+    return generator;
+}
+
+void Generator::seed(uint64_t seed) noexcept {
+    engine.seed(seed);
+}
+
+uint64_t Generator::below(uint64_t bound) noexcept {
+    // Lemire's multiply-and-reject: unbiased, and unlike `std::uniform_int_distribution` it gives the
+    // same numbers with every standard library.
+    auto product    = static_cast<uint128>(engine()) * bound;
+    auto low        = static_cast<uint64_t>(product);
+    const auto skip = -bound % bound;
+    while (low < skip) {
+        product = static_cast<uint128>(engine()) * bound;
+        low     = static_cast<uint64_t>(product);
+    }
+    return static_cast<uint64_t>(product >> 64);
+}
+
+void Generator::shuffle_solvable(unsigned size, std::span<uint16_t> tiles) noexcept {
+    const std::size_t cells = static_cast<std::size_t>(size) * size;
+    for (std::size_t i = 0; i < cells; i++) {
+        tiles[i] = static_cast<uint16_t>(i);
+    }
+    if (size < 2) {
+        return;
+    }
+
+    // Fisher-Yates; every real swap flips the parity of the permutation.
+    bool odd = false;
+    for (std::size_t i = cells - 1; i > 0; i--) {
+        const auto j = below(i + 1);
+        if (j != i) {
+            std::swap(tiles[i], tiles[j]);
+            odd = !odd;
+        }
+    }
+
+    std::size_t blank_cell = 0;
+    while (tiles[blank_cell] != 0) {
+        blank_cell++;
+    }
+    const std::size_t distance_null = (size - 1 - blank_cell / size) + (size - 1 - blank_cell % size);
+    if ((static_cast<std::size_t>(odd) + distance_null + size) % 2 == 1) {
+        return;
+    }
+
+    // Swapping the first two tiles flips solvability and is its own inverse, so it maps the
+    // unsolvable boards one-to-one onto the solvable ones.
+    const std::size_t first  = blank_cell == 0 ? 1 : 0;
+    const std::size_t second = blank_cell <= 1 ? 2 : 1;
+    std::swap(tiles[first], tiles[second]);
+}
+
+Board Generator::solvable(unsigned size) noexcept {
+    buffer.resize(static_cast<std::size_t>(size) * size);
+    shuffle_solvable(size, buffer);
+    return {size, buffer};
+}
+
+void Generator::reset(unsigned size) noexcept {
+    const std::size_t cells = static_cast<std::size_t>(size) * size;
+    buffer.resize(cells);
+    for (std::size_t i = 0; i < cells; i++) {
+        buffer[i] = static_cast<uint16_t>(i + 1);
+    }
+    if (cells > 0) {
+        buffer[cells - 1] = 0;
+    }
+    blank     = cells - 1;
+    last_move = no_move;
+}
+
+int Generator::step(unsigned size) noexcept {
+    const auto row = static_cast<int>(blank / size);
+    const auto col = static_cast<int>(blank % size);
+
+    unsigned moves[4];
+    unsigned count = 0;
+    for (unsigned move = 0; move < 4; move++) {
+        const int next_row = row + move_rows[move];
+        const int next_col = col + move_cols[move];
+        const bool inside  = next_row >= 0 && next_row < static_cast<int>(size) && next_col >= 0 &&
+                            next_col < static_cast<int>(size);
+        if (inside && (last_move == no_move || move != (last_move ^ 1))) {
+            moves[count++] = move;
+        }
+    }
+
+    const unsigned move    = moves[below(count)];
+    const std::size_t next = static_cast<std::size_t>(row + move_rows[move]) * size + (col + move_cols[move]);
+    const uint16_t value   = buffer[next];
+    const int delta        = static_cast<int>(tile_distance(size, value, blank)) -
+                      static_cast<int>(tile_distance(size, value, next));
+
+    buffer[blank] = value;
+    buffer[next]  = 0;
+    blank         = next;
+    last_move     = move;
+    return delta;
+}
+
+Board Generator::walk(unsigned size, unsigned moves) noexcept {
+    reset(size);
+    if (size >= 2) {
+        for (unsigned i = 0; i < moves; i++) {
+            step(size);
+        }
+    }
+    return {size, buffer};
+}
+
+std::optional<Board> Generator::at_least(unsigned size, unsigned depth) noexcept {
+    reset(size);
+    if (depth == 0) {
+        return Board(size, buffer);
+    }
+    if (size < 2) {
+        return {};
+    }
+
+    const std::size_t limit = 64 * (static_cast<std::size_t>(depth) + size * size);
+    int manhattan           = 0;
+    for (std::size_t i = 0; i < limit; i++) {
+        manhattan += step(size);
+        if (manhattan >= static_cast<int>(depth)) {
+            return Board(size, buffer);
+        }
+    }
+    return {};
+}
+
+std::optional<Board> Generator::exact(unsigned size, unsigned depth, unsigned attempts) noexcept {
+    if (depth == 0) {
+        return Board::create_goal(size);
+    }
+    if (size < 2) {
+        return {};
+    }
+
+    for (unsigned attempt = 0; attempt < attempts; attempt++) {
+        // A walk of `moves` steps ends at an optimal distance of at most `moves` with the same
+        // parity; slightly longer walks make deep targets reachable.
+        const unsigned moves = depth + 2 * (attempt % 4);
+        const auto board     = walk(size, moves);
+        if (board.manhattan() > depth) {
+            continue;
+        }
+        if (Solver::solve(board).moves() == depth) {
+            return board;
+        }
+    }
+    return {};
+}
+
+void Generator::fill(unsigned size, std::span<Board> out) noexcept {
+    const std::size_t cells = static_cast<std::size_t>(size) * size;
+    for (auto& board : out) {
+        board.side = size;
+        board.data.resize(cells);
+        shuffle_solvable(size, board.data);
+    }
+}
+
+void Generator::fill(unsigned size, std::span<uint16_t> tiles) noexcept {
+    const std::size_t cells = static_cast<std::size_t>(size) * size;
+    if (cells == 0) {
+        return;
+    }
+    for (std::size_t offset = 0; offset + cells <= tiles.size(); offset += cells) {
+        shuffle_solvable(size, tiles.subspan(offset, cells));
+    }
+}
@@ -0,0 +1,163 @@
+#include "puzzle/Heuristic.hpp"
+
+namespace {
+
+// Cell the blank left, i.e. where the moved tile is now.
+std::size_t previous_blank(std::size_t blank, std::size_t side, Move move) noexcept {
+    switch (move) {
+        case Move::up:
+            return blank + side;
+        case Move::down:
+            return blank - side;
+        case Move::left:
+            return blank + 1;
+        case Move::right:
+            return blank - 1;
+    }
+    return blank;
+}
+
+bool vertical(Move move) noexcept {
+    return move == Move::up || move == Move::down;
+}
+
+// Tiles of a row (or column) that have to leave it so that the other tiles whose goal is in that
+// line are in goal order: all of them but a longest increasing run of goal columns (or rows).
+uint8_t line_removals(std::span<const uint16_t> tiles, std::size_t side, std::size_t line, bool row) noexcept {
+    uint16_t targets[LinearConflictHeuristic::max_size];
+    std::size_t count = 0;
+    for (std::size_t k = 0; k < side; k++) {
+        const uint16_t tile = tiles[row ? line * side + k : k * side + line];
+        if (tile == 0) {
+            continue;
+        }
+        const std::size_t goal = tile - 1u;
+        if ((row ? goal / side : goal % side) == line) {
+            targets[count++] = static_cast<uint16_t>(row ? goal % side : goal / side);
+        }
+    }
+
+    uint8_t longest[LinearConflictHeuristic::max_size];
+    uint8_t best = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        longest[i] = 1;
+        for (std::size_t j = 0; j < i; j++) {
+            if (targets[j] < targets[i]) {
+                longest[i] = std::max<uint8_t>(longest[i], longest[j] + 1);
+            }
+        }
+        best = std::max(best, longest[i]);
+    }
+    return static_cast<uint8_t>(count - best);
+}
+
+}  // anonymous namespace
+
+void ManhattanHeuristic::init(const Board& board) noexcept {
+    distance = board.manhattan();
+}
+
+void ManhattanHeuristic::update(const Board& board, Move move) noexcept {
+    // The tile moved from where the blank is now to where it was; only one coordinate changes.
+    const std::size_t side = board.size();
+    const std::size_t from = board.blank();
+    const std::size_t to   = previous_blank(from, side, move);
+    const std::size_t goal = board.tiles()[to] - 1u;
+
+    const auto coordinate = [&](std::size_t cell) { return vertical(move) ? cell / side : cell % side; };
+    const auto away       = [&](std::size_t cell) {
+        const std::size_t a = coordinate(cell);
+        const std::size_t b = coordinate(goal);
+        return a > b ? a - b : b - a;
+    };
+    distance = distance + away(to) - away(from);
+}
+
+unsigned ManhattanHeuristic::value() const noexcept {
+    return distance;
+}
+
+void LinearConflictHeuristic::init(const Board& board) noexcept {
+    manhattan.init(board);
+    conflicts = 0;
+    lines.fill(0);
+    const std::size_t side = board.size();
+    if (side > max_size) {
+        return;
+    }
+    for (std::size_t line = 0; line < side; line++) {
+        lines[line]        = line_removals(board.tiles(), side, line, true);
+        lines[side + line] = line_removals(board.tiles(), side, line, false);
+        conflicts += lines[line] + lines[side + line];
+    }
+}
+
+void LinearConflictHeuristic::update(const Board& board, Move move) noexcept {
+    manhattan.update(board, move);
+    const std::size_t side = board.size();
+    if (side > max_size) {
+        return;
+    }
+    // A vertical move changes the row of one tile, which keeps its place among the tiles of its
+    // column; only the two rows change, and likewise the two columns for a horizontal move.
+    const std::size_t from = board.blank();
+    const std::size_t to   = previous_blank(from, side, move);
+    const bool row         = vertical(move);
+    for (const std::size_t cell : {from, to}) {
+        const std::size_t line  = row ? cell / side : cell % side;
+        const std::size_t index = row ? line : side + line;
+        conflicts -= lines[index];
+        lines[index] = line_removals(board.tiles(), side, line, row);
+        conflicts += lines[index];
+    }
+}
+
+unsigned LinearConflictHeuristic::value() const noexcept {
+    return manhattan.value() + 2 * conflicts;
+}
+
+PatternHeuristic::PatternHeuristic(const PatternDatabase& database, bool reflected) noexcept
+    : database(&database), reflected(reflected) {}
+
+void PatternHeuristic::init(Sum& sum, std::span<const uint16_t> tiles) const noexcept {
+    sum.total = 0;
+    for (std::size_t index = 0; index < database->patterns(); index++) {
+        sum.terms[index] = static_cast<uint8_t>(database->lookup(index, tiles));
+        sum.total += sum.terms[index];
+    }
+}
+
+void PatternHeuristic::update(Sum& sum, std::span<const uint16_t> tiles, std::size_t moved) const noexcept {
+    const std::size_t index = database->pattern_of(tiles[moved]);
+    if (index == database->patterns()) {
+        return;
+    }
+    sum.total -= sum.terms[index];
+    sum.terms[index] = static_cast<uint8_t>(database->lookup(index, tiles, sum.terms[index]));
+    sum.total += sum.terms[index];
+}
+
+void PatternHeuristic::init(const Board& board) noexcept {
+    init(direct, board.tiles());
+    if (reflected) {
+        uint16_t tiles[PatternDatabase::max_cells];
+        Board::transposed(board.size(), board.tiles(), tiles);
+        init(transposed, std::span<const uint16_t>(tiles, board.tiles().size()));
+    }
+}
+
+void PatternHeuristic::update(const Board& board, Move move) noexcept {
+    const std::size_t side = board.size();
+    const std::size_t to   = previous_blank(board.blank(), side, move);
+    update(direct, board.tiles(), to);
+    if (reflected) {
+        // The transposed board made the transposed move; the moved tile sits in the mirrored cell.
+        uint16_t tiles[PatternDatabase::max_cells];
+        Board::transposed(side, board.tiles(), tiles);
+        update(transposed, std::span<const uint16_t>(tiles, board.tiles().size()), to % side * side + to / side);
+    }
+}
+
+unsigned PatternHeuristic::value() const noexcept {
+    return reflected ? std::max(direct.total, transposed.total) : direct.total;
+}
@@ -0,0 +1,315 @@
+#include "Kernels.hpp"
+
+#include <array>
+#include <bit>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#if defined(__x86_64__)
+#define PUZZLE_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace kernels {
+
+namespace {
+
+// Row and column of every cell of a board, indexed by cell. The goal cell of tile `v` is `v - 1`,
+// so the same table serves both sides of the distance.
+struct Layout {
+    std::size_t side = 0;
+    std::vector<int32_t> row;
+    std::vector<int32_t> col;
+};
+
+const Layout& layout(std::size_t side) noexcept {
+    thread_local Layout cached;
+    if (cached.side != side || cached.row.empty()) {
+        const std::size_t cells = side * side;
+        cached.side             = side;
+        cached.row.resize(cells);
+        cached.col.resize(cells);
+        for (std::size_t p = 0; p < cells; p++) {
+            cached.row[p] = static_cast<int32_t>(p / side);
+            cached.col[p] = static_cast<int32_t>(p % side);
+        }
+    }
+    return cached;
+}
+
+// Byte tables for boards of side <= 4, where a whole board fits into one 16-byte register.
+struct alignas(16) SmallTables {
+    uint8_t goal_row[16];
+    uint8_t goal_col[16];
+    uint8_t cell_row[16];
+    uint8_t cell_col[16];
+};
+
+constexpr SmallTables make_small_tables(unsigned side) {
+    SmallTables tables{};
+    for (unsigned p = 0; p < side * side; p++) {
+        tables.cell_row[p] = static_cast<uint8_t>(p / side);
+        tables.cell_col[p] = static_cast<uint8_t>(p % side);
+        if (p + 1 < side * side) {
+            tables.goal_row[p + 1] = static_cast<uint8_t>(p / side);
+            tables.goal_col[p + 1] = static_cast<uint8_t>(p % side);
+        }
+    }
+    return tables;
+}
+
+constexpr std::size_t max_small_side = 4;
+
+constexpr std::array<SmallTables, max_small_side + 1> small_tables = {
+    make_small_tables(0), make_small_tables(1), make_small_tables(2), make_small_tables(3), make_small_tables(4)};
+
+#ifdef PUZZLE_KERNELS_X86
+
+Isa detect() noexcept {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return Isa::avx2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return Isa::sse4;
+    }
+    return Isa::scalar;
+}
+
+__attribute__((target("sse4.1"))) __m128i load_small(const uint16_t* tiles, std::size_t side) noexcept {
+    alignas(16) uint16_t buffer[16] = {};
+    std::memcpy(buffer, tiles, side * side * sizeof(uint16_t));
+    const __m128i low  = _mm_load_si128(reinterpret_cast<const __m128i*>(buffer));
+    const __m128i high = _mm_load_si128(reinterpret_cast<const __m128i*>(buffer + 8));
+    return _mm_packus_epi16(low, high);
+}
+
+// Looks up the goal row and column of every tile with `pshufb` and lets `psadbw` sum the
+// absolute differences. Blank cells (and the padding past the board) are replaced by their own
+// coordinates, so they contribute nothing; so are tiles past the board.
+__attribute__((target("sse4.1"))) unsigned manhattan_small_sse4(const uint16_t* tiles, std::size_t side) noexcept {
+    const SmallTables& tables = small_tables[side];
+
+    const __m128i values   = load_small(tiles, side);
+    const __m128i last     = _mm_set1_epi8(static_cast<char>(side * side - 1));
+    const __m128i outside  = _mm_xor_si128(_mm_cmpeq_epi8(_mm_min_epu8(values, last), values), _mm_set1_epi8(-1));
+    const __m128i blank    = _mm_or_si128(_mm_cmpeq_epi8(values, _mm_setzero_si128()), outside);
+    const __m128i cell_row = _mm_load_si128(reinterpret_cast<const __m128i*>(tables.cell_row));
+    const __m128i cell_col = _mm_load_si128(reinterpret_cast<const __m128i*>(tables.cell_col));
+
+    __m128i goal_row = _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(tables.goal_row)), values);
+    __m128i goal_col = _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(tables.goal_col)), values);
+    goal_row         = _mm_blendv_epi8(goal_row, cell_row, blank);
+    goal_col         = _mm_blendv_epi8(goal_col, cell_col, blank);
+
+    const __m128i sums = _mm_add_epi64(_mm_sad_epu8(goal_row, cell_row), _mm_sad_epu8(goal_col, cell_col));
+    return static_cast<unsigned>(_mm_cvtsi128_si32(sums) + _mm_extract_epi32(sums, 2));
+}
+
+__attribute__((target("avx2"))) inline __m256i broadcast_table(const uint8_t* bytes) noexcept {
+    return _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(bytes)));
+}
+
+// Same as `manhattan_small_sse4`, two boards per 256-bit register.
+__attribute__((target("avx2"))) void manhattan_small_avx2(const uint16_t* const* boards, std::size_t count,
+                                                          std::size_t side, unsigned* out) noexcept {
+    const SmallTables& tables    = small_tables[side];
+    const __m256i goal_row_table = broadcast_table(tables.goal_row);
+    const __m256i goal_col_table = broadcast_table(tables.goal_col);
+    const __m256i cell_row       = broadcast_table(tables.cell_row);
+    const __m256i cell_col       = broadcast_table(tables.cell_col);
+    const __m256i last           = _mm256_set1_epi8(static_cast<char>(side * side - 1));
+
+    for (std::size_t k = 0; k < count; k += 2) {
+        alignas(32) uint16_t buffer[32] = {};
+        std::memcpy(buffer, boards[k], side * side * sizeof(uint16_t));
+        if (k + 1 < count) {
+            std::memcpy(buffer + 16, boards[k + 1], side * side * sizeof(uint16_t));
+        }
+        const __m256i first  = _mm256_load_si256(reinterpret_cast<const __m256i*>(buffer));
+        const __m256i second = _mm256_load_si256(reinterpret_cast<const __m256i*>(buffer + 16));
+        // packus interleaves the 64-bit halves of both boards; put each board back into its own lane.
+        const __m256i values  = _mm256_permute4x64_epi64(_mm256_packus_epi16(first, second), 0xD8);
+        const __m256i outside = _mm256_xor_si256(_mm256_cmpeq_epi8(_mm256_min_epu8(values, last), values),
+                                                 _mm256_set1_epi8(-1));
+        const __m256i blank   = _mm256_or_si256(_mm256_cmpeq_epi8(values, _mm256_setzero_si256()), outside);
+
+        __m256i goal_row = _mm256_shuffle_epi8(goal_row_table, values);
+        __m256i goal_col = _mm256_shuffle_epi8(goal_col_table, values);
+        goal_row         = _mm256_blendv_epi8(goal_row, cell_row, blank);
+        goal_col         = _mm256_blendv_epi8(goal_col, cell_col, blank);
+
+        alignas(32) uint64_t sums[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(sums),
+                           _mm256_add_epi64(_mm256_sad_epu8(goal_row, cell_row), _mm256_sad_epu8(goal_col, cell_col)));
+        out[k] = static_cast<unsigned>(sums[0] + sums[1]);
+        if (k + 1 < count) {
+            out[k + 1] = static_cast<unsigned>(sums[2] + sums[3]);
+        }
+    }
+}
+
+// Eight tiles per step: the goal coordinates of each tile are gathered from the layout table.
+// Lanes holding the blank or a tile past the board are masked out of the gather and count zero.
+__attribute__((target("avx2"))) unsigned manhattan_avx2(const uint16_t* tiles, std::size_t side) noexcept {
+    const Layout& cells     = layout(side);
+    const std::size_t total = side * side;
+    const __m256i one       = _mm256_set1_epi32(1);
+    const __m256i zero      = _mm256_setzero_si256();
+    const __m256i limit     = _mm256_set1_epi32(static_cast<int32_t>(total));
+    __m256i acc             = zero;
+
+    std::size_t p = 0;
+    for (; p + 8 <= total; p += 8) {
+        const __m256i values =
+            _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(tiles + p)));
+        const __m256i occupied =
+            _mm256_andnot_si256(_mm256_cmpeq_epi32(values, zero), _mm256_cmpgt_epi32(limit, values));
+        const __m256i index    = _mm256_and_si256(_mm256_sub_epi32(values, one), occupied);
+        const __m256i cell_row = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cells.row.data() + p));
+        const __m256i cell_col = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cells.col.data() + p));
+        const __m256i goal_row = _mm256_mask_i32gather_epi32(cell_row, cells.row.data(), index, occupied, 4);
+        const __m256i goal_col = _mm256_mask_i32gather_epi32(cell_col, cells.col.data(), index, occupied, 4);
+        acc                    = _mm256_add_epi32(acc, _mm256_abs_epi32(_mm256_sub_epi32(goal_row, cell_row)));
+        acc                    = _mm256_add_epi32(acc, _mm256_abs_epi32(_mm256_sub_epi32(goal_col, cell_col)));
+    }
+
+    alignas(32) int32_t lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    unsigned counter = 0;
+    for (auto lane : lanes) {
+        counter += static_cast<unsigned>(lane);
+    }
+    for (; p < total; p++) {
+        if (tiles[p] != 0 && tiles[p] < total) {
+            const std::size_t goal = tiles[p] - 1u;
+            counter += std::abs(cells.row[goal] - cells.row[p]) + std::abs(cells.col[goal] - cells.col[p]);
+        }
+    }
+    return counter;
+}
+
+// Counts cells that differ from the goal by comparing against a running `1, 2, 3, ...` vector.
+__attribute__((target("avx2"))) unsigned hamming_avx2(const uint16_t* tiles, std::size_t side) noexcept {
+    const std::size_t last = side * side - 1;
+    const __m256i step     = _mm256_set1_epi16(16);
+    __m256i goal           = _mm256_setr_epi16(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16);
+
+    unsigned counter = 0;
+    std::size_t p    = 0;
+    for (; p + 16 <= last; p += 16) {
+        const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tiles + p));
+        const auto equal     = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(values, goal)));
+        counter += 16 - std::popcount(equal) / 2;
+        goal = _mm256_add_epi16(goal, step);
+    }
+    for (; p < last; p++) {
+        counter += tiles[p] != p + 1 ? 1 : 0;
+    }
+    return counter + (tiles[last] != 0 ? 1 : 0);
+}
+
+unsigned hamming_sse2(const uint16_t* tiles, std::size_t side) noexcept {
+    const std::size_t last = side * side - 1;
+    const __m128i step     = _mm_set1_epi16(8);
+    __m128i goal           = _mm_setr_epi16(1, 2, 3, 4, 5, 6, 7, 8);
+
+    unsigned counter = 0;
+    std::size_t p    = 0;
+    for (; p + 8 <= last; p += 8) {
+        const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tiles + p));
+        const auto equal     = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi16(values, goal)));
+        counter += 8 - std::popcount(equal) / 2;
+        goal = _mm_add_epi16(goal, step);
+    }
+    for (; p < last; p++) {
+        counter += tiles[p] != p + 1 ? 1 : 0;
+    }
+    return counter + (tiles[last] != 0 ? 1 : 0);
+}
+
+#else
+
+Isa detect() noexcept {
+    return Isa::scalar;
+}
+
+#endif  // PUZZLE_KERNELS_X86
+
+}  // anonymous namespace
+
+Isa detected_isa() noexcept {
+    static const Isa isa = detect();
+    return isa;
+}
+
+unsigned hamming_scalar(const uint16_t* tiles, std::size_t side) noexcept {
+    if (side == 0) {
+        return 0;
+    }
+    const std::size_t last = side * side - 1;
+    unsigned counter       = 0;
+    for (std::size_t p = 0; p < last; p++) {
+        counter += tiles[p] != p + 1 ? 1 : 0;
+    }
+    return counter + (tiles[last] != 0 ? 1 : 0);
+}
+
+unsigned manhattan_scalar(const uint16_t* tiles, std::size_t side) noexcept {
+    const Layout& cells     = layout(side);
+    const std::size_t total = side * side;
+    unsigned counter        = 0;
+    for (std::size_t p = 0; p < total; p++) {
+        // Tiles past the board, which only a board failing `validate` holds, count nothing.
+        if (tiles[p] != 0 && tiles[p] < total) {
+            const std::size_t goal = tiles[p] - 1u;
+            counter += std::abs(cells.row[goal] - cells.row[p]) + std::abs(cells.col[goal] - cells.col[p]);
+        }
+    }
+    return counter;
+}
+
+unsigned hamming(const uint16_t* tiles, std::size_t side) noexcept {
+    if (side == 0) {
+        return 0;
+    }
+#ifdef PUZZLE_KERNELS_X86
+    if (detected_isa() == Isa::avx2) {
+        return hamming_avx2(tiles, side);
+    }
+    return hamming_sse2(tiles, side);
+#else
+    return hamming_scalar(tiles, side);
+#endif
+}
+
+unsigned manhattan(const uint16_t* tiles, std::size_t side) noexcept {
+    if (side <= 1) {
+        return 0;
+    }
+#ifdef PUZZLE_KERNELS_X86
+    const Isa isa = detected_isa();
+    if (side <= max_small_side && isa != Isa::scalar) {
+        return manhattan_small_sse4(tiles, side);
+    }
+    if (isa == Isa::avx2) {
+        return manhattan_avx2(tiles, side);
+    }
+#endif
+    return manhattan_scalar(tiles, side);
+}
+
+void manhattan4(const uint16_t* const* boards, std::size_t count, std::size_t side, unsigned* out) noexcept {
+#ifdef PUZZLE_KERNELS_X86
+    if (side > 1 && side <= max_small_side && detected_isa() == Isa::avx2) {
+        manhattan_small_avx2(boards, count, side, out);
+        return;
+    }
+#endif
+    for (std::size_t k = 0; k < count; k++) {
+        out[k] = manhattan(boards[k], side);
+    }
+}
+
+}  // namespace kernels
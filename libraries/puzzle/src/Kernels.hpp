@@ -0,0 +1,27 @@
+#ifndef PUZZLE_KERNELS_HPP
+#define PUZZLE_KERNELS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// Heuristic kernels over row-major tile arrays. The implementation is picked once per process from
+// the instruction sets the CPU reports (AVX2, SSE4.1, or plain scalar code).
+namespace kernels {
+
+enum class Isa { scalar, sse4, avx2 };
+
+[[nodiscard]] Isa detected_isa() noexcept;
+
+[[nodiscard]] unsigned hamming(const uint16_t* tiles, std::size_t side) noexcept;
+[[nodiscard]] unsigned manhattan(const uint16_t* tiles, std::size_t side) noexcept;
+
+// Scores up to four boards of the same side, used for the children of one expanded node.
+void manhattan4(const uint16_t* const* boards, std::size_t count, std::size_t side, unsigned* out) noexcept;
+
+// Reference implementations, always available regardless of the detected ISA.
+[[nodiscard]] unsigned hamming_scalar(const uint16_t* tiles, std::size_t side) noexcept;
+[[nodiscard]] unsigned manhattan_scalar(const uint16_t* tiles, std::size_t side) noexcept;
+
+}  // namespace kernels
+
+#endif  // PUZZLE_KERNELS_HPP
@@ -0,0 +1,16 @@
+#ifndef PUZZLE_MIX_HPP
+#define PUZZLE_MIX_HPP
+
+#include <cstdint>
+
+// The splitmix64 finalizer. Ranks and hashes of boards a move apart differ in few bits; tables
+// that pick a bucket, a slot or a worker from a key mix it first so that every bit counts.
+[[nodiscard]] inline uint64_t mix(uint64_t key) noexcept {
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    return key ^ (key >> 31);
+}
+
+#endif  // PUZZLE_MIX_HPP
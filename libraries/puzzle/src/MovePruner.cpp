@@ -0,0 +1,279 @@
+#include "puzzle/MovePruner.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+// Moves of a path, two bits each with the first lowest.
+struct sequence {
+    uint32_t moves  = 0;
+    unsigned length = 0;
+
+    [[nodiscard]] Move operator[](unsigned index) const noexcept {
+        return static_cast<Move>(moves >> 2 * index & 3);
+    }
+
+    [[nodiscard]] sequence then(Move move) const noexcept {
+        return {moves | static_cast<uint32_t>(move) << 2 * length, length + 1};
+    }
+
+    [[nodiscard]] sequence suffix(unsigned from) const noexcept {
+        return {static_cast<uint32_t>(uint64_t{moves} >> 2 * from), length - from};
+    }
+
+    [[nodiscard]] uint64_t key() const noexcept {
+        return uint64_t{length} << 32 | moves;
+    }
+};
+
+// Rows and columns the blank visits, relative to the one it starts in.
+struct extent {
+    int top    = 0;
+    int bottom = 0;
+    int left   = 0;
+    int right  = 0;
+
+    [[nodiscard]] bool contains(const extent& other) const noexcept {
+        return top <= other.top && bottom >= other.bottom && left <= other.left && right >= other.right;
+    }
+};
+
+// A board wide enough for no path of `depth` moves from its center to reach an edge, on which
+// paths are replayed from the center one at a time.
+class plane {
+public:
+    explicit plane(unsigned depth) noexcept : width(2 * depth + 1), tiles(width * width), center(width * width / 2) {
+        for (std::size_t cell = 0; cell < tiles.size(); cell++) {
+            tiles[cell] = static_cast<uint16_t>(cell);
+        }
+    }
+
+    void replay(const sequence& path) noexcept {
+        for (auto cell : touched) {
+            tiles[cell] = static_cast<uint16_t>(cell);
+        }
+        touched.assign(1, center);
+        blank  = center;
+        bounds = {};
+        int row = 0;
+        int col = 0;
+        for (unsigned index = 0; index < path.length; index++) {
+            std::size_t to = blank;
+            switch (path[index]) {
+                case Move::up:
+                    to -= width;
+                    bounds.top = std::min(bounds.top, --row);
+                    break;
+                case Move::down:
+                    to += width;
+                    bounds.bottom = std::max(bounds.bottom, ++row);
+                    break;
+                case Move::left:
+                    to -= 1;
+                    bounds.left = std::min(bounds.left, --col);
+                    break;
+                case Move::right:
+                    to += 1;
+                    bounds.right = std::max(bounds.right, ++col);
+                    break;
+            }
+            std::swap(tiles[blank], tiles[to]);
+            blank = to;
+            touched.push_back(to);
+        }
+    }
+
+    // The blank's cell and every tile off its own, which is what the path does.
+    [[nodiscard]] std::string outcome() noexcept {
+        std::sort(touched.begin(), touched.end());
+        touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+        std::string key;
+        const auto put = [&](std::size_t value) {
+            key.push_back(static_cast<char>(value & 0xff));
+            key.push_back(static_cast<char>(value >> 8));
+        };
+        put(blank);
+        for (auto cell : touched) {
+            if (tiles[cell] != cell) {
+                put(cell);
+                put(tiles[cell]);
+            }
+        }
+        return key;
+    }
+
+    [[nodiscard]] const extent& visited() const noexcept {
+        return bounds;
+    }
+
+private:
+    std::size_t width;
+    std::vector<uint16_t> tiles;
+    std::size_t center;
+    std::size_t blank = center;
+    std::vector<std::size_t> touched;
+    extent bounds;
+};
+
+}  // anonymous namespace
+
+std::optional<MovePruner> MovePruner::learn(unsigned depth) noexcept {
+    if (depth == 0 || depth > max_depth) {
+        return {};
+    }
+
+    // Breadth-first over paths in move order, so the first path to an outcome is the shortest and
+    // earliest. A later one is rejected if the blank of the first stays within its rows and
+    // columns; either way it is not extended, nor is a path ending in a rejected one.
+    plane board(depth);
+    std::unordered_map<std::string, extent> seen;
+    std::unordered_set<uint64_t> rejected;
+    std::vector<sequence> found;
+    board.replay({});
+    seen.emplace(board.outcome(), board.visited());
+
+    const auto ends_rejected = [&](const sequence& path) {
+        for (unsigned from = 0; from + 1 < path.length; from++) {
+            if (rejected.contains(path.suffix(from).key())) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    std::vector<sequence> level{sequence{}};
+    for (unsigned length = 0; length < depth; length++) {
+        std::vector<sequence> next_level;
+        for (const auto& path : level) {
+            for (auto move : {Move::up, Move::down, Move::left, Move::right}) {
+                const auto longer = path.then(move);
+                if (ends_rejected(longer)) {
+                    continue;
+                }
+                board.replay(longer);
+                const auto [first, added] = seen.try_emplace(board.outcome(), board.visited());
+                if (added) {
+                    next_level.push_back(longer);
+                } else if (board.visited().contains(first->second)) {
+                    rejected.insert(longer.key());
+                    found.push_back(longer);
+                }
+            }
+        }
+        level = std::move(next_level);
+    }
+
+    // Trie of the rejected sequences, then the failure links that make it an automaton. Node 0 is
+    // the root, so 0 marks a missing child while the trie is built.
+    std::vector<std::array<State, 4>> trie(1, std::array<State, 4>{});
+    std::vector<bool> terminal(1, false);
+    for (const auto& path : found) {
+        State node = start;
+        for (unsigned index = 0; index < path.length; index++) {
+            const auto move = static_cast<uint8_t>(path[index]);
+            if (trie[node][move] == 0) {
+                trie[node][move] = static_cast<State>(trie.size());
+                trie.emplace_back();
+                terminal.push_back(false);
+            }
+            node = trie[node][move];
+        }
+        terminal[node] = true;
+    }
+
+    std::vector<State> failure(trie.size(), start);
+    std::deque<State> queue;
+    for (State child : trie[start]) {
+        if (child != 0) {
+            queue.push_back(child);
+        }
+    }
+    while (not queue.empty()) {
+        const State node = queue.front();
+        queue.pop_front();
+        for (std::size_t move = 0; move < 4; move++) {
+            State& child = trie[node][move];
+            if (child == 0) {
+                child = trie[failure[node]][move];
+                continue;
+            }
+            failure[child]  = trie[failure[node]][move];
+            terminal[child] = terminal[child] || terminal[failure[child]];
+            queue.push_back(child);
+        }
+    }
+
+    MovePruner pruner;
+    pruner.horizon   = depth;
+    pruner.forbidden = found.size();
+    pruner.owned     = std::move(trie);
+    for (auto& row : pruner.owned) {
+        for (auto& target : row) {
+            target = terminal[target] ? pruned : target;
+        }
+    }
+    pruner.transitions = pruner.owned;
+    return pruner;
+}
+
+// The payload is the transition table, four states per state in move order, which the page
+// alignment of payloads lets the search read in place.
+std::optional<MovePruner> MovePruner::load(const std::string& path, const TableFile::MapOptions& options) noexcept {
+    auto file = TableFile::open(path, kind, options);
+    if (not file) {
+        return {};
+    }
+    const auto& parameters = file->parameters();
+    const auto payload     = file->payload();
+    const auto states      = parameters[2];
+    if (parameters[0] == 0 || parameters[0] > max_depth || states == 0 ||
+        payload.size() != states * sizeof(std::array<State, 4>)) {
+        return {};
+    }
+    const std::span<const std::array<State, 4>> transitions(
+        reinterpret_cast<const std::array<State, 4>*>(payload.data()), states);
+    for (const auto& row : transitions) {
+        for (auto target : row) {
+            if (target != pruned && target >= states) {
+                return {};
+            }
+        }
+    }
+
+    MovePruner pruner;
+    pruner.horizon     = static_cast<unsigned>(parameters[0]);
+    pruner.forbidden   = parameters[1];
+    pruner.transitions = transitions;
+    pruner.file        = std::move(file);
+    return pruner;
+}
+
+std::optional<MovePruner> MovePruner::load(const std::string& path) noexcept {
+    return load(path, TableFile::MapOptions{});
+}
+
+std::optional<MovePruner> MovePruner::load_or_learn(const std::string& path, unsigned depth) noexcept {
+    return TableFile::load_or_make<MovePruner>(
+        path, [&](const MovePruner& pruner) { return pruner.depth() == depth; }, [&]() { return learn(depth); });
+}
+
+bool MovePruner::save(const std::string& path) const noexcept {
+    const std::span<const uint8_t> bytes(reinterpret_cast<const uint8_t*>(transitions.data()), transitions.size_bytes());
+    return TableFile::write(path, kind, {horizon, forbidden, transitions.size(), 0}, bytes);
+}
+
+unsigned MovePruner::depth() const noexcept {
+    return horizon;
+}
+
+std::size_t MovePruner::states() const noexcept {
+    return transitions.size();
+}
+
+std::size_t MovePruner::sequences() const noexcept {
+    return forbidden;
+}
@@ -0,0 +1,485 @@
+#include "puzzle/PatternDatabase.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <deque>
+#include <utility>
+
+namespace {
+
+using Encoding = PatternDatabase::Encoding;
+using Storage  = PatternDatabase::Storage;
+
+constexpr uint8_t unvisited  = 0xFF;
+constexpr uint8_t max_stored = 0xFE;
+constexpr uint8_t max_nibble = 0xF;
+// Residues of five distances make a base-3 number below 243.
+constexpr uint8_t powers_of_three[] = {1, 3, 9, 27, 81};
+
+std::size_t count_placements(std::size_t cells, std::size_t tiles) noexcept {
+    std::size_t result = 1;
+    for (std::size_t i = 0; i < tiles; i++) {
+        result *= cells - i;
+    }
+    return result;
+}
+
+// Placements are ranked as k-permutations of the cells: each digit counts the free cells before
+// the tile's cell, in base (cells - i) for the i-th tile.
+std::size_t encode(const uint8_t* positions, std::size_t tiles, std::size_t cells) noexcept {
+    uint64_t used    = 0;
+    std::size_t rank = 0;
+    for (std::size_t i = 0; i < tiles; i++) {
+        const uint64_t below = used & ((uint64_t{1} << positions[i]) - 1);
+        rank                 = rank * (cells - i) + positions[i] - std::popcount(below);
+        used |= uint64_t{1} << positions[i];
+    }
+    return rank;
+}
+
+void decode(std::size_t rank, std::size_t tiles, std::size_t cells, uint8_t* positions) noexcept {
+    uint8_t digits[PatternDatabase::max_cells];
+    for (std::size_t i = tiles; i-- > 0;) {
+        digits[i] = static_cast<uint8_t>(rank % (cells - i));
+        rank /= cells - i;
+    }
+    uint64_t used = 0;
+    for (std::size_t i = 0; i < tiles; i++) {
+        uint64_t unused = ~used;
+        for (unsigned skip = digits[i]; skip > 0; skip--) {
+            unused &= unused - 1;
+        }
+        positions[i] = static_cast<uint8_t>(std::countr_zero(unused));
+        used |= uint64_t{1} << positions[i];
+    }
+}
+
+// Calls `visit` with the rank of every placement one step of a tile away from `positions`, onto a
+// cell no other tile holds. When `visit` accepts one, `positions` stay at it and the result is true.
+template <typename Visit>
+bool for_each_step(uint8_t* positions, std::size_t tiles, unsigned side, Visit&& visit) noexcept {
+    const std::size_t cells = static_cast<std::size_t>(side) * side;
+    uint64_t taken          = 0;
+    for (std::size_t i = 0; i < tiles; i++) {
+        taken |= uint64_t{1} << positions[i];
+    }
+    for (std::size_t i = 0; i < tiles; i++) {
+        const uint8_t from = positions[i];
+        const uint8_t row  = from / side;
+        const uint8_t col  = from % side;
+        uint8_t targets[4];
+        std::size_t count = 0;
+        if (row > 0) {
+            targets[count++] = static_cast<uint8_t>(from - side);
+        }
+        if (row + 1u < side) {
+            targets[count++] = static_cast<uint8_t>(from + side);
+        }
+        if (col > 0) {
+            targets[count++] = static_cast<uint8_t>(from - 1);
+        }
+        if (col + 1u < side) {
+            targets[count++] = static_cast<uint8_t>(from + 1);
+        }
+        for (std::size_t t = 0; t < count; t++) {
+            if ((taken >> targets[t] & 1) != 0) {
+                continue;
+            }
+            positions[i] = targets[t];
+            if (visit(encode(positions, tiles, cells))) {
+                return true;
+            }
+        }
+        positions[i] = from;
+    }
+    return false;
+}
+
+// Breadth-first search over placements of the pattern and cells of the blank, where moving a
+// pattern tile costs one and moving any other tile is free.
+std::vector<uint8_t> build_table(unsigned side, const PatternDatabase::Pattern& pattern) noexcept {
+    const std::size_t cells      = static_cast<std::size_t>(side) * side;
+    const std::size_t tiles      = pattern.size();
+    const std::size_t placements = count_placements(cells, tiles);
+
+    std::vector<uint8_t> distance(placements * cells, unvisited);
+    uint8_t positions[PatternDatabase::max_cells];
+    for (std::size_t i = 0; i < tiles; i++) {
+        positions[i] = static_cast<uint8_t>(pattern[i] - 1);
+    }
+    const std::size_t start = encode(positions, tiles, cells) * cells + cells - 1;
+    distance[start]         = 0;
+    std::deque<std::size_t> queue{start};
+
+    while (not queue.empty()) {
+        const std::size_t state = queue.front();
+        queue.pop_front();
+        const std::size_t blank = state % cells;
+        const uint8_t depth     = distance[state];
+        decode(state / cells, tiles, cells, positions);
+
+        const std::size_t row = blank / side;
+        const std::size_t col = blank % side;
+        std::size_t neighbours[4];
+        std::size_t count = 0;
+        if (row > 0) {
+            neighbours[count++] = blank - side;
+        }
+        if (row + 1 < side) {
+            neighbours[count++] = blank + side;
+        }
+        if (col > 0) {
+            neighbours[count++] = blank - 1;
+        }
+        if (col + 1 < side) {
+            neighbours[count++] = blank + 1;
+        }
+
+        for (std::size_t n = 0; n < count; n++) {
+            const std::size_t cell = neighbours[n];
+            const auto tile        = std::find(positions, positions + tiles, cell) - positions;
+            std::size_t next       = state / cells * cells + cell;
+            uint8_t next_depth     = depth;
+            if (static_cast<std::size_t>(tile) < tiles) {
+                positions[tile] = static_cast<uint8_t>(blank);
+                next            = encode(positions, tiles, cells) * cells + cell;
+                positions[tile] = static_cast<uint8_t>(cell);
+                next_depth      = std::min<uint8_t>(depth + 1, max_stored);
+            }
+            if (next_depth < distance[next]) {
+                distance[next] = next_depth;
+                if (next_depth == depth) {
+                    queue.push_front(next);
+                } else {
+                    queue.push_back(next);
+                }
+            }
+        }
+    }
+
+    // The blank is free to go anywhere, so a placement costs its cheapest blank cell.
+    std::vector<uint8_t> table(placements);
+    for (std::size_t p = 0; p < placements; p++) {
+        const auto* first = distance.data() + p * cells;
+        table[p]          = *std::min_element(first, first + cells);
+    }
+    return table;
+}
+
+// Lowers distances until those of placements one step apart differ by at most one, to one more
+// than the least neighbour's, which keeps them admissible. Placements are settled by increasing
+// distance, each one lowering its neighbours once.
+void smooth(unsigned side, std::size_t tiles, std::span<uint8_t> values) noexcept {
+    const std::size_t cells = static_cast<std::size_t>(side) * side;
+    const uint8_t highest   = *std::max_element(values.begin(), values.end());
+    uint8_t positions[PatternDatabase::max_cells];
+    for (unsigned level = 0; level < highest; level++) {
+        for (std::size_t rank = 0; rank < values.size(); rank++) {
+            if (values[rank] != level) {
+                continue;
+            }
+            decode(rank, tiles, cells, positions);
+            for_each_step(positions, tiles, side, [&](std::size_t next) {
+                values[next] = static_cast<uint8_t>(std::min<unsigned>(values[next], level + 1));
+                return false;
+            });
+        }
+    }
+}
+
+std::size_t entries_per_byte(Encoding encoding) noexcept {
+    switch (encoding) {
+        case Encoding::bytes:
+            return 1;
+        case Encoding::nibbles:
+            return 2;
+        case Encoding::mod3:
+            return 5;
+    }
+    return 1;
+}
+
+std::size_t table_bytes(std::size_t placements, const Storage& storage) noexcept {
+    const std::size_t entries = (placements + storage.fold - 1) / storage.fold;
+    const std::size_t packed  = entries_per_byte(storage.encoding);
+    return (entries + packed - 1) / packed;
+}
+
+std::vector<uint8_t> pack(std::span<const uint8_t> values, const Storage& storage) noexcept {
+    std::vector<uint8_t> packed(table_bytes(values.size(), storage));
+    for (std::size_t first = 0, slot = 0; first < values.size(); first += storage.fold, slot++) {
+        const auto group    = values.subspan(first, std::min<std::size_t>(storage.fold, values.size() - first));
+        const uint8_t value = *std::min_element(group.begin(), group.end());
+        switch (storage.encoding) {
+            case Encoding::bytes:
+                packed[slot] = value;
+                break;
+            case Encoding::nibbles:
+                packed[slot / 2] |= static_cast<uint8_t>(std::min(value, max_nibble) << slot % 2 * 4);
+                break;
+            case Encoding::mod3:
+                packed[slot / 5] += static_cast<uint8_t>(value % 3 * powers_of_three[slot % 5]);
+                break;
+        }
+    }
+    return packed;
+}
+
+}  // anonymous namespace
+
+bool PatternDatabase::layout(unsigned size, std::vector<Pattern> patterns, const Storage& storage) noexcept {
+    const std::size_t cells = static_cast<std::size_t>(size) * size;
+    if (size < 2 || cells > max_cells || patterns.empty() || patterns.size() > max_patterns) {
+        return false;
+    }
+    if (storage.encoding > Encoding::mod3 || not std::has_single_bit(storage.fold) ||
+        (storage.encoding == Encoding::mod3 && storage.fold != 1)) {
+        return false;
+    }
+    side    = size;
+    packing = storage;
+    owner.assign(cells, static_cast<uint8_t>(patterns.size()));
+    offsets.assign(1, 0);
+    for (std::size_t index = 0; index < patterns.size(); index++) {
+        const auto& pattern = patterns[index];
+        if (pattern.empty() || count_placements(cells, pattern.size()) * cells > max_build_states) {
+            return false;
+        }
+        for (auto tile : pattern) {
+            if (tile == 0 || tile >= cells || owner[tile] != patterns.size()) {
+                return false;
+            }
+            owner[tile] = static_cast<uint8_t>(index);
+        }
+        offsets.push_back(offsets.back() + table_bytes(count_placements(cells, pattern.size()), storage));
+    }
+    tile_sets = std::move(patterns);
+    return true;
+}
+
+std::optional<PatternDatabase> PatternDatabase::build(unsigned size, const std::vector<Pattern>& patterns) noexcept {
+    PatternDatabase database;
+    if (not database.layout(size, patterns, {})) {
+        return {};
+    }
+    database.owned.reserve(database.offsets.back());
+    for (const auto& pattern : database.tile_sets) {
+        const auto table = build_table(size, pattern);
+        database.owned.insert(database.owned.end(), table.begin(), table.end());
+    }
+    database.distances = database.owned;
+    return database;
+}
+
+std::optional<PatternDatabase> PatternDatabase::compress(const Storage& storage) const noexcept {
+    PatternDatabase database;
+    if (packing.encoding != Encoding::bytes || packing.fold != 1 || not database.layout(side, tile_sets, storage)) {
+        return {};
+    }
+    database.owned.reserve(database.offsets.back());
+    for (std::size_t index = 0; index < tile_sets.size(); index++) {
+        std::vector<uint8_t> values(distances.begin() + offsets[index], distances.begin() + offsets[index + 1]);
+        if (storage.encoding == Encoding::mod3) {
+            smooth(side, tile_sets[index].size(), values);
+        }
+        const auto packed = pack(values, storage);
+        database.owned.insert(database.owned.end(), packed.begin(), packed.end());
+    }
+    database.distances = database.owned;
+    return database;
+}
+
+// The payload lists the patterns, each as its length and tiles in 16-bit words, padded to eight
+// bytes, followed by the tables in pattern order. The last parameter holds the encoding in its low
+// byte and the fold less one above it, so that files of byte tables have it zero.
+std::optional<PatternDatabase> PatternDatabase::load(const std::string& path,
+                                                     const TableFile::MapOptions& options) noexcept {
+    auto file = TableFile::open(path, kind, options);
+    if (not file) {
+        return {};
+    }
+    const auto& parameters = file->parameters();
+    const auto payload     = file->payload();
+    const auto count       = parameters[1];
+    const auto tables      = parameters[2];
+    if (parameters[0] > max_cells || count > max_patterns || tables > payload.size()) {
+        return {};
+    }
+
+    std::vector<Pattern> patterns(count);
+    std::size_t offset = 0;
+    const auto word    = [&]() -> std::optional<uint16_t> {
+        if (offset + 2 > tables) {
+            return {};
+        }
+        uint16_t value = 0;
+        std::memcpy(&value, payload.data() + offset, 2);
+        offset += 2;
+        return value;
+    };
+    for (auto& pattern : patterns) {
+        const auto length = word();
+        for (uint16_t i = 0; length && i < *length; i++) {
+            const auto tile = word();
+            if (not tile) {
+                return {};
+            }
+            pattern.push_back(*tile);
+        }
+    }
+
+    const Storage storage{static_cast<Encoding>(parameters[3] & 0xFF), static_cast<unsigned>((parameters[3] >> 8) + 1)};
+    PatternDatabase database;
+    if (not database.layout(static_cast<unsigned>(parameters[0]), std::move(patterns), storage) ||
+        payload.size() != tables + database.offsets.back()) {
+        return {};
+    }
+    database.distances = payload.subspan(tables);
+    database.file      = std::move(file);
+    return database;
+}
+
+std::optional<PatternDatabase> PatternDatabase::load(const std::string& path) noexcept {
+    return load(path, TableFile::MapOptions{});
+}
+
+bool PatternDatabase::save(const std::string& path) const noexcept {
+    std::vector<uint8_t> payload;
+    const auto word = [&](uint16_t value) {
+        payload.resize(payload.size() + 2);
+        std::memcpy(payload.data() + payload.size() - 2, &value, 2);
+    };
+    for (const auto& pattern : tile_sets) {
+        word(static_cast<uint16_t>(pattern.size()));
+        for (auto tile : pattern) {
+            word(tile);
+        }
+    }
+    payload.resize((payload.size() + 7) / 8 * 8);
+    const std::size_t tables = payload.size();
+    payload.insert(payload.end(), distances.begin(), distances.end());
+    const uint64_t storage = static_cast<uint64_t>(packing.encoding) | uint64_t{packing.fold - 1} << 8;
+    return TableFile::write(path, kind, {side, tile_sets.size(), tables, storage}, payload);
+}
+
+unsigned PatternDatabase::size() const noexcept {
+    return side;
+}
+
+std::size_t PatternDatabase::patterns() const noexcept {
+    return tile_sets.size();
+}
+
+std::size_t PatternDatabase::pattern_of(uint16_t tile) const noexcept {
+    return tile < owner.size() ? owner[tile] : tile_sets.size();
+}
+
+const PatternDatabase::Storage& PatternDatabase::storage() const noexcept {
+    return packing;
+}
+
+std::size_t PatternDatabase::memory() const noexcept {
+    return distances.size();
+}
+
+std::size_t PatternDatabase::placement(std::size_t index, const uint8_t* cells) const noexcept {
+    const auto& pattern = tile_sets[index];
+    uint8_t positions[max_cells];
+    for (std::size_t i = 0; i < pattern.size(); i++) {
+        positions[i] = cells[pattern[i]];
+    }
+    return encode(positions, pattern.size(), owner.size());
+}
+
+unsigned PatternDatabase::entry(std::size_t index, std::size_t rank) const noexcept {
+    const std::size_t slot = rank >> std::countr_zero(packing.fold);
+    const uint8_t* table   = distances.data() + offsets[index];
+    switch (packing.encoding) {
+        case Encoding::bytes:
+            return table[slot];
+        case Encoding::nibbles:
+            return table[slot / 2] >> slot % 2 * 4 & max_nibble;
+        case Encoding::mod3:
+            return table[slot / 5] / powers_of_three[slot % 5] % 3;
+    }
+    return 0;
+}
+
+unsigned PatternDatabase::walk(std::size_t index, const uint8_t* cells) const noexcept {
+    const auto& pattern = tile_sets[index];
+    uint8_t positions[max_cells];
+    bool home = true;
+    for (std::size_t i = 0; i < pattern.size(); i++) {
+        positions[i] = cells[pattern[i]];
+        home         = home && positions[i] == pattern[i] - 1;
+    }
+    // Every placement but the goal has a neighbour one move closer, the one whose residue is
+    // one less.
+    unsigned moves = 0;
+    for (std::size_t rank = encode(positions, pattern.size(), owner.size()); not home; moves++) {
+        const unsigned closer = (entry(index, rank) + 2) % 3;
+        if (not for_each_step(positions, pattern.size(), side, [&](std::size_t next) {
+                rank = next;
+                return entry(index, next) == closer;
+            })) {
+            break;
+        }
+        home = std::equal(pattern.begin(), pattern.end(), positions,
+                          [](uint16_t tile, uint8_t cell) { return cell == tile - 1; });
+    }
+    return moves;
+}
+
+unsigned PatternDatabase::lookup(std::size_t index, const Board& board) const noexcept {
+    return lookup(index, board.tiles());
+}
+
+unsigned PatternDatabase::lookup(std::size_t index, const Board& board, unsigned previous) const noexcept {
+    return lookup(index, board.tiles(), previous);
+}
+
+unsigned PatternDatabase::estimate(const Board& board) const noexcept {
+    return estimate(board.tiles());
+}
+
+unsigned PatternDatabase::lookup(std::size_t index, std::span<const uint16_t> tiles) const noexcept {
+    uint8_t cells[max_cells];
+    for (std::size_t cell = 0; cell < tiles.size(); cell++) {
+        cells[tiles[cell]] = static_cast<uint8_t>(cell);
+    }
+    if (packing.encoding == Encoding::mod3) {
+        return walk(index, cells);
+    }
+    return entry(index, placement(index, cells));
+}
+
+unsigned PatternDatabase::lookup(std::size_t index, std::span<const uint16_t> tiles, unsigned previous) const noexcept {
+    if (packing.encoding != Encoding::mod3) {
+        return lookup(index, tiles);
+    }
+    uint8_t cells[max_cells];
+    for (std::size_t cell = 0; cell < tiles.size(); cell++) {
+        cells[tiles[cell]] = static_cast<uint8_t>(cell);
+    }
+    switch ((entry(index, placement(index, cells)) + 3 - previous % 3) % 3) {
+        case 0:
+            return previous;
+        case 1:
+            return previous + 1;
+        default:
+            return previous - 1;
+    }
+}
+
+unsigned PatternDatabase::estimate(std::span<const uint16_t> tiles) const noexcept {
+    uint8_t cells[max_cells];
+    for (std::size_t cell = 0; cell < tiles.size(); cell++) {
+        cells[tiles[cell]] = static_cast<uint8_t>(cell);
+    }
+    unsigned total = 0;
+    for (std::size_t index = 0; index < tile_sets.size(); index++) {
+        total += packing.encoding == Encoding::mod3 ? walk(index, cells) : entry(index, placement(index, cells));
+    }
+    return total;
+}
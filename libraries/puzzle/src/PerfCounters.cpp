@@ -0,0 +1,112 @@
+#include "puzzle/PerfCounters.hpp"
+
+#include <utility>
+
+#if PUZZLE_PERF_COUNTERS && defined(__linux__)
+#define PUZZLE_PERF_EVENTS 1
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+PhaseCounters& PhaseCounters::operator+=(const PhaseCounters& other) noexcept {
+    cycles += other.cycles;
+    instructions += other.instructions;
+    cache_misses += other.cache_misses;
+    branch_misses += other.branch_misses;
+    scopes += other.scopes;
+    return *this;
+}
+
+PerfReport& PerfReport::operator+=(const PerfReport& other) noexcept {
+    available = available || other.available;
+    for (std::size_t phase = 0; phase < phase_count; phase++) {
+        phases[phase] += other.phases[phase];
+    }
+    return *this;
+}
+
+#ifdef PUZZLE_PERF_EVENTS
+namespace {
+
+// One event of the calling thread on any CPU, counted in user space only. Members of the group
+// count whenever the leader does, which starts disabled until the group is complete.
+int open_event(uint64_t config, int leader) noexcept {
+    perf_event_attr attributes{};
+    attributes.size           = sizeof(attributes);
+    attributes.type           = PERF_TYPE_HARDWARE;
+    attributes.config         = config;
+    attributes.disabled       = leader == -1 ? 1 : 0;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv     = 1;
+    attributes.read_format    = PERF_FORMAT_GROUP;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, leader, 0));
+}
+
+}  // anonymous namespace
+#endif
+
+std::optional<PerfCounters> PerfCounters::open() noexcept {
+#ifdef PUZZLE_PERF_EVENTS
+    constexpr uint64_t events[] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+                                   PERF_COUNT_HW_BRANCH_MISSES};
+    PerfCounters counters;
+    for (std::size_t index = 0; index < counters.descriptors.size(); index++) {
+        counters.descriptors[index] = open_event(events[index], counters.descriptors[0]);
+        if (counters.descriptors[index] == -1) {
+            return {};
+        }
+    }
+    const int leader = counters.descriptors[0];
+    if (ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP) == -1 ||
+        ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP) == -1) {
+        return {};
+    }
+    return counters;
+#else
+    return {};
+#endif
+}
+
+PerfCounters::PerfCounters(PerfCounters&& other) noexcept
+    : descriptors(std::exchange(other.descriptors, {-1, -1, -1, -1})) {}
+
+PerfCounters& PerfCounters::operator=(PerfCounters&& other) noexcept {
+    if (this != &other) {
+        close();
+        descriptors = std::exchange(other.descriptors, {-1, -1, -1, -1});
+    }
+    return *this;
+}
+
+PerfCounters::~PerfCounters() {
+    close();
+}
+
+void PerfCounters::close() noexcept {
+#ifdef PUZZLE_PERF_EVENTS
+    // Members before the leader, which takes the group with it.
+    for (auto descriptor = descriptors.rbegin(); descriptor != descriptors.rend(); ++descriptor) {
+        if (*descriptor != -1) {
+            ::close(*descriptor);
+            *descriptor = -1;
+        }
+    }
+#endif
+}
+
+PhaseCounters PerfCounters::read() const noexcept {
+    PhaseCounters totals;
+#ifdef PUZZLE_PERF_EVENTS
+    // PERF_FORMAT_GROUP: the number of events, then their values in the order they were opened.
+    uint64_t values[1 + 4] = {};
+    if (::read(descriptors[0], values, sizeof(values)) == static_cast<ssize_t>(sizeof(values)) && values[0] == 4) {
+        totals.cycles        = values[1];
+        totals.instructions  = values[2];
+        totals.cache_misses  = values[3];
+        totals.branch_misses = values[4];
+    }
+#endif
+    return totals;
+}
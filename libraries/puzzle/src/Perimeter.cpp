@@ -0,0 +1,139 @@
+#include "puzzle/Perimeter.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+constexpr uint64_t empty            = ~uint64_t{0};
+constexpr std::size_t initial_slots = 1024;
+
+std::size_t hash(uint64_t rank) noexcept {
+    return static_cast<std::size_t>(rank * 0x9E3779B97F4A7C15 >> 17);
+}
+
+}  // anonymous namespace
+
+std::optional<Perimeter> Perimeter::build(unsigned size, unsigned depth) noexcept {
+    if (size < 2 || size > Board::max_ranked_size || depth > max_depth) {
+        return {};
+    }
+    Perimeter perimeter;
+    perimeter.side   = size;
+    perimeter.radius = depth;
+    perimeter.slots.assign(initial_slots, empty);
+
+    const uint64_t goal = Board::create_goal(size).rank();
+    perimeter.insert(goal, 0);
+    std::vector<uint64_t> frontier{goal};
+    std::vector<uint64_t> next;
+    std::vector<uint16_t> tiles(static_cast<std::size_t>(size) * size);
+    for (unsigned level = 1; level <= depth && not frontier.empty(); level++) {
+        next.clear();
+        for (auto rank : frontier) {
+            Board::unrank(size, rank, tiles);
+            const std::size_t blank = std::find(tiles.begin(), tiles.end(), 0) - tiles.begin();
+            const auto visit        = [&](std::size_t cell) {
+                std::swap(tiles[blank], tiles[cell]);
+                const uint64_t neighbour = Board::rank(tiles);
+                if (perimeter.insert(neighbour, level)) {
+                    next.push_back(neighbour);
+                }
+                std::swap(tiles[blank], tiles[cell]);
+            };
+            if (blank >= size) {
+                visit(blank - size);
+            }
+            if (blank + size < tiles.size()) {
+                visit(blank + size);
+            }
+            if (blank % size > 0) {
+                visit(blank - 1);
+            }
+            if (blank % size + 1 < size) {
+                visit(blank + 1);
+            }
+        }
+        std::swap(frontier, next);
+    }
+    return perimeter;
+}
+
+std::size_t Perimeter::slot(uint64_t rank) const noexcept {
+    // Linear probing in a power-of-two table that is never more than half full.
+    const std::size_t mask = slots.size() - 1;
+    for (std::size_t index = hash(rank) & mask;; index = (index + 1) & mask) {
+        if (slots[index] == empty || slots[index] >> 8 == rank) {
+            return index;
+        }
+    }
+}
+
+bool Perimeter::insert(uint64_t rank, unsigned distance) noexcept {
+    if (slots[slot(rank)] != empty) {
+        return false;
+    }
+    if (2 * (count + 1) > slots.size()) {
+        std::vector<uint64_t> previous(slots.size() * 2, empty);
+        std::swap(slots, previous);
+        for (auto entry : previous) {
+            if (entry != empty) {
+                slots[slot(entry >> 8)] = entry;
+            }
+        }
+    }
+    slots[slot(rank)] = rank << 8 | distance;
+    count++;
+    return true;
+}
+
+unsigned Perimeter::size() const noexcept {
+    return side;
+}
+
+unsigned Perimeter::depth() const noexcept {
+    return radius;
+}
+
+std::size_t Perimeter::boards() const noexcept {
+    return count;
+}
+
+bool Perimeter::supports(const Board& board) const noexcept {
+    return side != 0 && board.size() == side && board.validate();
+}
+
+std::optional<unsigned> Perimeter::distance(const Board& board) const noexcept {
+    if (not supports(board)) {
+        return {};
+    }
+    return distance(board.rank());
+}
+
+std::optional<unsigned> Perimeter::distance(uint64_t rank) const noexcept {
+    const uint64_t entry = slots[slot(rank)];
+    if (entry == empty) {
+        return {};
+    }
+    return static_cast<unsigned>(entry & 0xFF);
+}
+
+std::vector<Board> Perimeter::path(const Board& board) const noexcept {
+    auto remaining = distance(board);
+    if (not remaining) {
+        return {};
+    }
+    std::vector<Board> result{board};
+    result.reserve(*remaining + 1);
+    while (*remaining > 0) {
+        for (auto move : {Move::up, Move::down, Move::left, Move::right}) {
+            auto neighbour = result.back().moved(move);
+            if (neighbour && distance(neighbour->rank()) == *remaining - 1) {
+                result.push_back(std::move(*neighbour));
+                break;
+            }
+        }
+        --*remaining;
+    }
+    return result;
+}
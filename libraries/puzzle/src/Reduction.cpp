@@ -0,0 +1,422 @@
+#include "Reduction.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <utility>
+
+namespace {
+
+// Blank moves along a row-major board; the tiles locked in place are never moved again.
+class Reducer {
+public:
+    Reducer(std::span<uint16_t> tiles, std::size_t side) noexcept
+        : tiles(tiles), side(side), where(tiles.size()), locked(tiles.size(), 0), seen(tiles.size(), 0),
+          parent(tiles.size()) {
+        for (std::size_t cell = 0; cell < tiles.size(); cell++) {
+            where[tiles[cell]] = cell;
+        }
+    }
+
+    std::vector<Move> run() noexcept {
+        for (std::size_t corner = 0; side - corner > 3; corner++) {
+            place_row(corner);
+            place_column(corner);
+        }
+        return std::move(moves);
+    }
+
+private:
+    [[nodiscard]] std::size_t cell(std::size_t row, std::size_t column) const noexcept {
+        return row * side + column;
+    }
+
+    [[nodiscard]] Move direction(std::size_t from, std::size_t to) const noexcept {
+        if (to + side == from) {
+            return Move::up;
+        }
+        if (to == from + side) {
+            return Move::down;
+        }
+        return to + 1 == from ? Move::left : Move::right;
+    }
+
+    // Moves the blank to the adjacent cell `to`.
+    void step(std::size_t to) noexcept {
+        const std::size_t from = where[0];
+        moves.push_back(direction(from, to));
+        const uint16_t tile = tiles[to];
+        tiles[from]         = tile;
+        tiles[to]           = 0;
+        where[tile]         = from;
+        where[0]            = to;
+    }
+
+    [[nodiscard]] bool free(std::size_t at, std::size_t avoid) const noexcept {
+        return locked[at] == 0 && at != avoid;
+    }
+
+    // Cells from `from` along the row, then along the column to `to`, if none is taken.
+    bool straight(std::size_t from, std::size_t to, bool row_first, std::size_t avoid,
+                  std::vector<std::size_t>& path) const noexcept {
+        path.clear();
+        std::size_t row    = from / side;
+        std::size_t column = from % side;
+        const auto walk    = [&](bool along_row) {
+            std::size_t& coordinate = along_row ? column : row;
+            const std::size_t goal  = along_row ? to % side : to / side;
+            while (coordinate != goal) {
+                coordinate = coordinate < goal ? coordinate + 1 : coordinate - 1;
+                if (not free(cell(row, column), avoid)) {
+                    return false;
+                }
+                path.push_back(cell(row, column));
+            }
+            return true;
+        };
+        return walk(row_first) && walk(not row_first);
+    }
+
+    // Breadth-first search from `from` to `to` within the rows and columns `low`..`high`.
+    bool search(std::size_t from, std::size_t to, std::size_t avoid, std::size_t low_row, std::size_t high_row,
+                std::size_t low_column, std::size_t high_column, std::vector<std::size_t>& path) noexcept {
+        generation++;
+        queue.assign(1, from);
+        seen[from] = generation;
+        for (std::size_t head = 0; head < queue.size() && seen[to] != generation; head++) {
+            const std::size_t at     = queue[head];
+            const std::size_t row    = at / side;
+            const std::size_t column = at % side;
+            const auto visit         = [&](std::size_t next) {
+                if (seen[next] != generation && free(next, avoid)) {
+                    seen[next]   = generation;
+                    parent[next] = at;
+                    queue.push_back(next);
+                }
+            };
+            if (row > low_row) {
+                visit(at - side);
+            }
+            if (row < high_row) {
+                visit(at + side);
+            }
+            if (column > low_column) {
+                visit(at - 1);
+            }
+            if (column < high_column) {
+                visit(at + 1);
+            }
+        }
+        if (seen[to] != generation) {
+            return false;
+        }
+        path.clear();
+        for (std::size_t at = to; at != from; at = parent[at]) {
+            path.push_back(at);
+        }
+        std::reverse(path.begin(), path.end());
+        return true;
+    }
+
+    // Brings the blank to `to` without moving locked tiles or the one at `avoid`. A straight
+    // route almost always exists; otherwise a search near both ends, then over the whole board.
+    bool walk_blank(std::size_t to, std::size_t avoid) noexcept {
+        const std::size_t from = where[0];
+        if (not straight(from, to, true, avoid, path) && not straight(from, to, false, avoid, path)) {
+            constexpr std::size_t margin = 2;
+            const auto [top, bottom]     = std::minmax({from / side, to / side});
+            const auto [left, right]     = std::minmax({from % side, to % side});
+            if (not search(from, to, avoid, top - std::min(top, margin), std::min(bottom + margin, side - 1),
+                           left - std::min(left, margin), std::min(right + margin, side - 1), path) &&
+                not search(from, to, avoid, 0, side - 1, 0, side - 1, path)) {
+                return false;
+            }
+        }
+        for (auto next : path) {
+            step(next);
+        }
+        return true;
+    }
+
+    // Moves `tile` to `target` one cell at a time, taking the blank around it. When locked tiles
+    // bar both cells towards `target`, the tile follows the shortest route around them.
+    void move_tile(uint16_t tile, std::size_t target) noexcept {
+        while (where[tile] != target) {
+            const std::size_t at = where[tile];
+            std::optional<std::size_t> candidates[2];
+            if (target / side != at / side) {
+                candidates[0] = target / side < at / side ? at - side : at + side;
+            }
+            if (target % side != at % side) {
+                candidates[1] = target % side < at % side ? at - 1 : at + 1;
+            }
+            bool moved = false;
+            for (const auto& next : candidates) {
+                if (next && locked[*next] == 0 && walk_blank(*next, at)) {
+                    step(at);
+                    moved = true;
+                    break;
+                }
+            }
+            if (moved) {
+                continue;
+            }
+            if (not search(at, target, tiles.size(), 0, side - 1, 0, side - 1, route)) {
+                return;
+            }
+            for (auto next : route) {
+                if (not walk_blank(next, where[tile])) {
+                    return;
+                }
+                step(where[tile]);
+            }
+        }
+    }
+
+    void place(uint16_t tile, std::size_t target) noexcept {
+        move_tile(tile, target);
+        locked[target] = 1;
+    }
+
+    // The last two tiles of a line, `first` for `near` and `second` for `far` at its end, where
+    // `along` leads from `near` to `far` and `inward` off the line. They cannot be placed one after
+    // the other, as the blank would be shut in behind the first. So `first` is parked two lines
+    // inwards, where it cannot shut the blank in either, `second` goes to `near`, and both finish
+    // with a search over the four lines of the last three cells, in which only they and the
+    // blank count.
+    void place_pair(uint16_t first, uint16_t second, std::size_t near, std::size_t along, std::size_t inward) noexcept {
+        const std::size_t far = near + along;
+        if (where[first] != near || where[second] != far) {
+            const std::size_t parking = near + 2 * inward;
+            place(first, parking);
+            place(second, near);
+            walk_blank(near + inward, tiles.size());
+            locked[parking] = locked[near] = 0;
+            finish_pair(first, second, near, along, inward);
+        }
+        locked[near] = locked[far] = 1;
+    }
+
+    void finish_pair(uint16_t first, uint16_t second, std::size_t near, std::size_t along, std::size_t inward) noexcept {
+        // The cells but for the locked one before `near` on its line.
+        constexpr std::size_t cells  = 11;
+        constexpr std::size_t states = cells * cells * cells;
+        std::size_t window[cells]    = {near, near + along};
+        for (std::size_t line = 1; line < 4; line++) {
+            for (std::size_t offset = 0; offset < 3; offset++) {
+                window[2 + (line - 1) * 3 + offset] = near + line * inward + offset * along - along;
+            }
+        }
+        const auto index    = [&](std::size_t at) { return std::find(window, window + cells, at) - window; };
+        const auto adjacent = [&](std::size_t a, std::size_t b) {
+            return a + side == b || b + side == a || (a / side == b / side && (a + 1 == b || b + 1 == a));
+        };
+
+        // A state is the window cells of `first`, `second` and the blank; the goal has them on 0 and 1.
+        std::size_t previous[states];
+        std::size_t queue[states];
+        std::fill(previous, previous + states, states);
+        const std::size_t start = (index(where[first]) * cells + index(where[second])) * cells + index(where[0]);
+        previous[start]         = start;
+        queue[0]                = start;
+        std::size_t found       = start;
+        for (std::size_t head = 0, tail = 1; head < tail; head++) {
+            found               = queue[head];
+            const std::size_t f = found / (cells * cells);
+            const std::size_t s = found / cells % cells;
+            const std::size_t b = found % cells;
+            if (f == 0 && s == 1) {
+                break;
+            }
+            for (std::size_t next = 0; next < cells; next++) {
+                const std::size_t moved = ((next == f ? b : f) * cells + (next == s ? b : s)) * cells + next;
+                if (adjacent(window[b], window[next]) && previous[moved] == states) {
+                    previous[moved] = found;
+                    queue[tail++]   = moved;
+                }
+            }
+        }
+
+        std::vector<std::size_t> blanks;
+        for (std::size_t at = found; at != start; at = previous[at]) {
+            blanks.push_back(window[at % cells]);
+        }
+        std::for_each(blanks.rbegin(), blanks.rend(), [&](std::size_t cell) { step(cell); });
+    }
+
+    void place_row(std::size_t row) noexcept {
+        for (std::size_t column = row; column + 2 < side; column++) {
+            place(static_cast<uint16_t>(cell(row, column) + 1), cell(row, column));
+        }
+        const std::size_t near = cell(row, side - 2);
+        place_pair(static_cast<uint16_t>(near + 1), static_cast<uint16_t>(near + 2), near, 1, side);
+    }
+
+    void place_column(std::size_t column) noexcept {
+        for (std::size_t row = column + 1; row + 2 < side; row++) {
+            place(static_cast<uint16_t>(cell(row, column) + 1), cell(row, column));
+        }
+        const std::size_t near = cell(side - 2, column);
+        place_pair(static_cast<uint16_t>(near + 1), static_cast<uint16_t>(near + side + 1), near, side, 1);
+    }
+
+    std::span<uint16_t> tiles;
+    std::size_t side;
+    std::vector<std::size_t> where;
+    std::vector<uint8_t> locked;
+    std::vector<Move> moves;
+    // Scratch space of the routes of the blank and of tiles.
+    std::vector<std::size_t> path;
+    std::vector<std::size_t> route;
+    std::vector<std::size_t> queue;
+    std::vector<uint32_t> seen;
+    std::vector<std::size_t> parent;
+    uint32_t generation = 0;
+};
+
+[[nodiscard]] bool perpendicular(Move left, Move right) noexcept {
+    return (static_cast<uint8_t>(left) ^ static_cast<uint8_t>(right)) >= 2;
+}
+
+// Appends `move`, cancelling it against an opposite last move and folding two equal laps
+// around a 2x2 block, which cycle its three tiles by two places, into one lap the other way.
+void push(std::vector<Move>& moves, Move move) noexcept {
+    if (not moves.empty() && moves.back() == opposite(move)) {
+        moves.pop_back();
+        return;
+    }
+    moves.push_back(move);
+    const std::size_t count = moves.size();
+    if (count < 8) {
+        return;
+    }
+    const Move* lap = moves.data() + count - 4;
+    const bool square = perpendicular(lap[0], lap[1]) && lap[2] == opposite(lap[0]) && lap[3] == opposite(lap[1]);
+    if (square && std::equal(lap, lap + 4, lap - 4)) {
+        const Move reversed[] = {opposite(lap[3]), opposite(lap[2]), opposite(lap[1]), opposite(lap[0])};
+        moves.resize(count - 8);
+        for (auto next : reversed) {
+            push(moves, next);
+        }
+    }
+}
+
+// Hash of `tile` on `cell`; the hash of a board is the exclusive or over its cells.
+uint64_t mix(uint64_t tile, uint64_t cell, uint64_t cells) noexcept {
+    uint64_t value = tile * cells + cell + 0x9E3779B97F4A7C15;
+    value          = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9;
+    value          = (value ^ (value >> 27)) * 0x94D049BB133111EB;
+    return value ^ (value >> 31);
+}
+
+// Whether `moves` from a board with the blank at `blank` come back to the same board.
+bool returns(std::span<const Move> moves, std::size_t blank, std::size_t side) noexcept {
+    // Cells the moves touch, with the cell whose content each holds now.
+    std::vector<std::pair<std::size_t, std::size_t>> contents;
+    const auto content = [&](std::size_t cell) -> std::size_t& {
+        for (auto& [at, from] : contents) {
+            if (at == cell) {
+                return from;
+            }
+        }
+        return contents.emplace_back(cell, cell).second;
+    };
+    std::size_t at = blank;
+    for (auto move : moves) {
+        std::size_t next = at;
+        switch (move) {
+            case Move::up:
+                next = at - side;
+                break;
+            case Move::down:
+                next = at + side;
+                break;
+            case Move::left:
+                next = at - 1;
+                break;
+            case Move::right:
+                next = at + 1;
+                break;
+        }
+        std::swap(content(at), content(next));
+        at = next;
+    }
+    return at == blank && std::all_of(contents.begin(), contents.end(), [](const auto& pair) {
+               return pair.first == pair.second;
+           });
+}
+
+// Drops every stretch of moves that returns to one of the last `window` boards.
+std::vector<Move> drop_cycles(std::span<const uint16_t> start, std::size_t side, const std::vector<Move>& moves) {
+    constexpr std::size_t window = 64;
+    const std::size_t cells      = start.size();
+    std::vector<uint16_t> tiles(start.begin(), start.end());
+    std::size_t blank = std::find(tiles.begin(), tiles.end(), 0) - tiles.begin();
+    uint64_t hash     = 0;
+    for (std::size_t cell = 0; cell < cells; cell++) {
+        hash ^= mix(tiles[cell], cell, cells);
+    }
+
+    // `hashes[i]` is the hash of the board after the first `i` kept moves.
+    std::vector<Move> kept;
+    std::vector<uint64_t> hashes{hash};
+    kept.reserve(moves.size());
+    hashes.reserve(moves.size() + 1);
+    for (auto move : moves) {
+        const std::size_t next = move == Move::up     ? blank - side
+                                 : move == Move::down ? blank + side
+                                 : move == Move::left ? blank - 1
+                                                      : blank + 1;
+        const uint16_t tile = tiles[next];
+        hash ^= mix(0, blank, cells) ^ mix(tile, next, cells) ^ mix(tile, blank, cells) ^ mix(0, next, cells);
+        tiles[blank] = tile;
+        tiles[next]  = 0;
+        blank        = next;
+        kept.push_back(move);
+
+        // The blank changes colour with every move, so only boards an even number of moves
+        // back can be the same.
+        const std::size_t last = kept.size();
+        bool cut               = false;
+        for (std::size_t back = 2; back <= std::min(window, last) && not cut; back += 2) {
+            const std::size_t earlier = last - back;
+            if (hashes[earlier] == hash &&
+                returns(std::span<const Move>(kept).subspan(earlier), blank, side)) {
+                kept.resize(earlier);
+                hashes.resize(earlier + 1);
+                cut = true;
+            }
+        }
+        if (not cut) {
+            hashes.push_back(hash);
+        }
+    }
+    return kept;
+}
+
+}  // anonymous namespace
+
+namespace reduction {
+
+std::vector<Move> place(std::span<uint16_t> tiles, std::size_t side) noexcept {
+    return Reducer(tiles, side).run();
+}
+
+std::vector<Move> shorten(std::span<const uint16_t> tiles, std::size_t side, const std::vector<Move>& moves) noexcept {
+    std::vector<Move> result = moves;
+    // A pass can expose more to shorten; the gain fades after a few.
+    for (int pass = 0; pass < 4; pass++) {
+        std::vector<Move> folded;
+        folded.reserve(result.size());
+        for (auto move : result) {
+            push(folded, move);
+        }
+        folded = drop_cycles(tiles, side, folded);
+        if (folded.size() == result.size()) {
+            break;
+        }
+        result = std::move(folded);
+    }
+    return result;
+}
+
+}  // namespace reduction
@@ -0,0 +1,27 @@
+#ifndef PUZZLE_REDUCTION_HPP
+#define PUZZLE_REDUCTION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "puzzle/Board.hpp"
+
+// Constructive solving of large boards, behind `Solver::approximate`.
+namespace reduction {
+
+// Puts the top row and the left column of the board in place, then those of the board without
+// them, and so on until the bottom-right 3x3 block is all that is left. `tiles` are row-major,
+// solvable and of a side of at least 4; they are updated along with the moves.
+[[nodiscard]] std::vector<Move> place(std::span<uint16_t> tiles, std::size_t side) noexcept;
+
+// Shorter moves to the same board: two laps of the blank around a 2x2 block become one lap the
+// other way, a move undone by the next one goes, and so does every short detour that returns to
+// an earlier board.
+[[nodiscard]] std::vector<Move> shorten(std::span<const uint16_t> tiles, std::size_t side,
+                                        const std::vector<Move>& moves) noexcept;
+
+}  // namespace reduction
+
+#endif  // PUZZLE_REDUCTION_HPP
@@ -0,0 +1,366 @@
+#include "puzzle/Server.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#include "puzzle/TextFormat.hpp"
+
+namespace {
+
+// A client sending this much without a newline is dropped.
+constexpr std::size_t max_line = 1 << 20;
+
+std::optional<std::size_t> parse_number(std::string_view text) noexcept {
+    std::size_t value = 0;
+    const auto parsed = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (parsed.ec != std::errc() || parsed.ptr != text.data() + text.size()) {
+        return {};
+    }
+    return value;
+}
+
+// A budget a request asks for, which never exceeds the server's own unless that is unlimited.
+std::size_t clamp_budget(std::size_t requested, std::size_t limit) noexcept {
+    if (limit == 0) {
+        return requested;
+    }
+    return requested == 0 ? limit : std::min(requested, limit);
+}
+
+std::string_view next_token(std::string_view& line) noexcept {
+    const auto start = line.find_first_not_of(" \t\r");
+    if (start == std::string_view::npos) {
+        line = {};
+        return {};
+    }
+    line             = line.substr(start);
+    const auto end   = std::min(line.find_first_of(" \t\r"), line.size());
+    const auto token = line.substr(0, end);
+    line             = line.substr(end);
+    return token;
+}
+
+}  // anonymous namespace
+
+// Answers are queued by the workers and written by the connection's own thread, so that a client
+// that does not read them holds up nothing but itself.
+struct Server::Connection {
+    explicit Connection(int socket) noexcept : socket(socket), wake(::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) {}
+    Connection(const Connection&)            = delete;
+    Connection& operator=(const Connection&) = delete;
+    ~Connection() {
+        ::close(socket);
+        if (wake >= 0) {
+            ::close(wake);
+        }
+    }
+
+    // A request was queued for this connection.
+    void expect() noexcept {
+        std::lock_guard lock(mutex);
+        unanswered++;
+    }
+
+    // Queues the answer of a request; never waits for the client.
+    void answer(const std::string& text) noexcept {
+        {
+            std::lock_guard lock(mutex);
+            output += text;
+            unanswered--;
+        }
+        const uint64_t one = 1;
+        while (::write(wake, &one, sizeof(one)) < 0 && errno == EINTR) {
+        }
+    }
+
+    // Sends as much of the queued answers as the socket takes without blocking. False once the
+    // client is gone.
+    bool flush() noexcept {
+        std::lock_guard lock(mutex);
+        while (not output.empty()) {
+            const auto sent = ::send(socket, output.data(), output.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+            if (sent < 0 && errno == EINTR) {
+                continue;
+            }
+            if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                return true;
+            }
+            if (sent <= 0) {
+                return false;
+            }
+            output.erase(0, static_cast<std::size_t>(sent));
+        }
+        return true;
+    }
+
+    // Bytes of answers waiting for the client, and requests waiting for their answer.
+    [[nodiscard]] std::pair<std::size_t, std::size_t> backlog() noexcept {
+        std::lock_guard lock(mutex);
+        return {output.size(), unanswered};
+    }
+
+    const int socket;
+    // Readable when answers were queued.
+    const int wake;
+
+private:
+    std::mutex mutex;
+    std::string output;
+    std::size_t unanswered = 0;
+};
+
+Server::Server(Options options) noexcept : options(std::move(options)) {
+    if (this->options.cache_bytes > 0) {
+        cache = std::make_unique<SolutionCache>(this->options.cache_bytes);
+    }
+    this->options.solve.cache = cache.get();
+}
+
+Server::~Server() {
+    stop();
+    if (listener >= 0) {
+        ::close(listener);
+        if (not options.socket_path.empty()) {
+            ::unlink(options.socket_path.c_str());
+        }
+    }
+}
+
+bool Server::listen() noexcept {
+    if (not options.socket_path.empty()) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (options.socket_path.size() >= sizeof(address.sun_path)) {
+            return false;
+        }
+        std::memcpy(address.sun_path, options.socket_path.c_str(), options.socket_path.size() + 1);
+        // A socket file left behind by a previous run would make bind fail.
+        ::unlink(options.socket_path.c_str());
+        listener = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (listener < 0 || ::bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            return false;
+        }
+    } else {
+        sockaddr_in address{};
+        address.sin_family      = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port        = htons(options.port);
+        listener                = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        const int reuse         = 1;
+        if (listener < 0 || ::setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0 ||
+            ::bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            return false;
+        }
+        socklen_t length = sizeof(address);
+        if (::getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+            return false;
+        }
+        bound_port = ntohs(address.sin_port);
+    }
+    return ::listen(listener, SOMAXCONN) == 0;
+}
+
+uint16_t Server::port() const noexcept {
+    return bound_port;
+}
+
+void Server::serve() noexcept {
+    if (listener < 0) {
+        return;
+    }
+    const unsigned threads =
+        options.threads != 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (unsigned i = 0; i < threads; i++) {
+        workers.emplace_back(&Server::work, this);
+    }
+
+    while (not stopping) {
+        const int socket = ::accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+        if (socket < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            break;
+        }
+        auto connection = std::make_shared<Connection>(socket);
+        std::lock_guard lock(mutex);
+        if (stopping) {
+            break;
+        }
+        std::erase_if(connections, [](const auto& weak) { return weak.expired(); });
+        connections.push_back(connection);
+        readers++;
+        std::thread([this, connection]() { read(connection); }).detach();
+    }
+
+    stop();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    // Every answer is queued by now. Clients that do not take theirs in time are cut off, which
+    // fails their readers' next send.
+    std::unique_lock lock(mutex);
+    if (not queue_changed.wait_for(lock, options.drain_timeout, [&]() { return readers == 0; })) {
+        for (const auto& weak : connections) {
+            if (auto connection = weak.lock()) {
+                ::shutdown(connection->socket, SHUT_RDWR);
+            }
+        }
+    }
+    queue_changed.wait(lock, [&]() { return readers == 0; });
+}
+
+void Server::stop() noexcept {
+    std::lock_guard lock(mutex);
+    if (stopping.exchange(true)) {
+        return;
+    }
+    // Wakes up accept and the readers; answers to requests already queued can still be sent.
+    if (listener >= 0) {
+        ::shutdown(listener, SHUT_RDWR);
+    }
+    for (const auto& weak : connections) {
+        if (auto connection = weak.lock()) {
+            ::shutdown(connection->socket, SHUT_RD);
+        }
+    }
+    queue_changed.notify_all();
+}
+
+void Server::read(const std::shared_ptr<Connection>& connection) noexcept {
+    std::string buffer;
+    char chunk[1 << 16];
+    // Requests are read until the client ends them, the server stops or the client misbehaves;
+    // answers are written until the last one is out or the client is gone.
+    bool reading = connection->wake >= 0;
+    bool alive   = true;
+    while (alive) {
+        const auto [waiting, unanswered] = connection->backlog();
+        if (not reading && (waiting == 0 || connection->wake < 0) && unanswered == 0) {
+            break;
+        }
+        // A client leaving its answers unread is not read from until it has taken them.
+        pollfd polled[2] = {{connection->socket, 0, 0}, {connection->wake, POLLIN, 0}};
+        if (reading && waiting < options.output_limit) {
+            polled[0].events |= POLLIN;
+        }
+        if (waiting > 0) {
+            polled[0].events |= POLLOUT;
+        }
+        if (::poll(polled, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if ((polled[1].revents & POLLIN) != 0) {
+            uint64_t count = 0;
+            [[maybe_unused]] const auto drained = ::read(connection->wake, &count, sizeof(count));
+        }
+        if ((polled[0].revents & POLLOUT) != 0) {
+            alive = connection->flush();
+        }
+        if (not reading && (polled[0].revents & (POLLERR | POLLHUP)) != 0) {
+            alive = false;
+        }
+        if (not reading || (polled[0].revents & (POLLIN | POLLERR | POLLHUP)) == 0) {
+            continue;
+        }
+
+        const auto received = ::recv(connection->socket, chunk, sizeof(chunk), MSG_DONTWAIT);
+        if (received < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
+            continue;
+        }
+        if (received <= 0) {
+            reading = false;
+            continue;
+        }
+        buffer.append(chunk, static_cast<std::size_t>(received));
+
+        std::size_t start = 0;
+        bool dropped      = false;
+        for (auto newline = buffer.find('\n'); newline != std::string::npos && not dropped;
+             start = newline + 1, newline = buffer.find('\n', start)) {
+            std::string_view line(buffer.data() + start, newline - start);
+            const auto id = next_token(line);
+            if (id.empty()) {
+                continue;
+            }
+
+            Job job{connection, std::string(id), Board(), options.solve};
+            bool valid = true;
+            while (true) {
+                auto rest        = line;
+                const auto token = next_token(rest);
+                if (token.starts_with("nodes=")) {
+                    const auto value      = parse_number(token.substr(6));
+                    valid                 = valid && value.has_value();
+                    job.solve.node_budget = clamp_budget(value.value_or(0), options.solve.node_budget);
+                } else if (token.starts_with("ms=")) {
+                    const auto value      = parse_number(token.substr(3));
+                    const auto limit      = static_cast<std::size_t>(options.solve.time_budget.count());
+                    valid                 = valid && value.has_value();
+                    job.solve.time_budget = std::chrono::milliseconds(clamp_budget(value.value_or(0), limit));
+                } else {
+                    break;
+                }
+                line = rest;
+            }
+            job.board = valid && line.find_first_not_of(" \t\r") != std::string_view::npos
+                            ? TextFormat::parse_board(line)
+                            : Board(1, {});
+
+            std::unique_lock lock(mutex);
+            queue_changed.wait(lock, [&]() { return stopping || jobs.size() < options.queue; });
+            dropped = stopping;
+            if (not dropped) {
+                // Counted before a worker can take it, so that its answer is waited for.
+                connection->expect();
+                jobs.push_back(std::move(job));
+                queue_changed.notify_all();
+            }
+        }
+        buffer.erase(0, start);
+        if (dropped || buffer.size() > max_line) {
+            reading = false;
+        }
+    }
+
+    std::lock_guard lock(mutex);
+    readers--;
+    queue_changed.notify_all();
+}
+
+void Server::work() noexcept {
+    while (true) {
+        std::optional<Job> job;
+        {
+            std::unique_lock lock(mutex);
+            queue_changed.wait(lock, [&]() { return stopping || not jobs.empty(); });
+            if (jobs.empty()) {
+                return;
+            }
+            job.emplace(std::move(jobs.front()));
+            jobs.pop_front();
+            queue_changed.notify_all();
+        }
+
+        const auto solution = Solver::solve(job->board, job->solve);
+        job->connection->answer(TextFormat::format_result(job->id, job->board, solution, TextFormat::Detail::moves));
+    }
+}
@@ -0,0 +1,150 @@
+#include "puzzle/SolutionCache.hpp"
+
+#include "Mix.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace {
+
+// Entry layout, low to high: 45 bits of rank (16! < 2^45), 2 bits of side - 1, 7 bits of distance,
+// 2 bits of move and the reference bit. A zero word is an empty slot, since side - 1 is never 0.
+constexpr unsigned size_shift      = 45;
+constexpr unsigned distance_shift  = 47;
+constexpr unsigned move_shift      = 54;
+constexpr uint64_t key_mask        = (uint64_t{1} << distance_shift) - 1;
+constexpr uint64_t referenced      = uint64_t{1} << 56;
+constexpr unsigned max_distance    = 127;
+constexpr std::size_t bucket_bytes = 64;
+
+struct Key {
+    uint64_t key;
+    // The board is the transposed form of its canonical representative, so moves stored for the
+    // representative have to be transposed.
+    bool flipped;
+};
+
+// A board and its transpose share one entry, keyed by the smaller of the two ranks. The transpose
+// is ranked from the stack: every child A* generates is looked up.
+Key make_key(const Board& board) noexcept {
+    const std::size_t side   = board.size();
+    const uint64_t size_bits = static_cast<uint64_t>(side - 1) << size_shift;
+    uint16_t transpose[Board::max_ranked_size * Board::max_ranked_size];
+    Board::transposed(side, board.tiles(), transpose);
+    const uint64_t direct    = board.rank();
+    const uint64_t reflected = Board::rank(std::span<const uint16_t>(transpose, side * side));
+    return {std::min(direct, reflected) | size_bits, reflected < direct};
+}
+
+}  // anonymous namespace
+
+SolutionCache::SolutionCache(std::size_t memory_bytes) noexcept {
+    const std::size_t count = std::bit_floor(std::max<std::size_t>(memory_bytes / bucket_bytes, 1));
+    bucket_mask             = count - 1;
+    buckets                 = std::make_unique<Bucket[]>(count);
+}
+
+bool SolutionCache::supports(const Board& board) noexcept {
+    return board.size() >= 2 && board.size() <= Board::max_ranked_size;
+}
+
+SolutionCache::Bucket& SolutionCache::bucket(uint64_t key) const noexcept {
+    return buckets[mix(key) & bucket_mask];
+}
+
+std::optional<SolutionCache::Entry> SolutionCache::find(const Board& board) const noexcept {
+    if (not supports(board)) {
+        return {};
+    }
+    const auto [key, flipped] = make_key(board);
+    for (auto& slot : bucket(key).slots) {
+        const uint64_t word = slot.load(std::memory_order_relaxed);
+        if ((word & key_mask) == key) {
+            if ((word & referenced) == 0) {
+                slot.fetch_or(referenced, std::memory_order_relaxed);
+            }
+            const auto next = static_cast<Move>((word >> move_shift) & 3);
+            return Entry{static_cast<unsigned>((word >> distance_shift) & max_distance),
+                         flipped ? transposed(next) : next};
+        }
+    }
+    return {};
+}
+
+void SolutionCache::insert(const Board& board, Entry entry) noexcept {
+    if (not supports(board) || entry.distance > max_distance) {
+        return;
+    }
+    const auto [key, flipped] = make_key(board);
+    const Move next           = flipped ? transposed(entry.next) : entry.next;
+    const uint64_t word       = key | static_cast<uint64_t>(entry.distance) << distance_shift |
+                                static_cast<uint64_t>(next) << move_shift | referenced;
+    auto& slots               = bucket(key).slots;
+
+    for (auto& slot : slots) {
+        if ((slot.load(std::memory_order_relaxed) & key_mask) == key) {
+            return;
+        }
+    }
+
+    // CLOCK over the bucket, starting at a key-dependent hand: take an empty slot, or clear the
+    // reference bit of used ones until an unreferenced entry can be replaced.
+    const std::size_t hand = mix(key) >> 61;
+    for (std::size_t step = 0; step < 2 * bucket_slots + 1; step++) {
+        auto& slot    = slots[(hand + step) % bucket_slots];
+        uint64_t seen = slot.load(std::memory_order_relaxed);
+        if (seen != 0 && (seen & referenced) != 0) {
+            slot.compare_exchange_strong(seen, seen & ~referenced, std::memory_order_relaxed);
+            continue;
+        }
+        if (slot.compare_exchange_strong(seen, word, std::memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+void SolutionCache::insert(const std::vector<Board>& path) noexcept {
+    for (std::size_t i = 0; i < path.size(); i++) {
+        const auto distance = static_cast<unsigned>(path.size() - 1 - i);
+        const auto next     = i + 1 < path.size() ? path[i].move_to(path[i + 1]) : std::optional<Move>(Move::up);
+        if (not next) {
+            return;
+        }
+        insert(path[i], {distance, *next});
+    }
+}
+
+std::optional<std::vector<Board>> SolutionCache::solution(const Board& board) const noexcept {
+    auto entry = find(board);
+    if (not entry) {
+        return {};
+    }
+
+    std::vector<Board> path;
+    path.reserve(entry->distance + 1);
+    path.push_back(board);
+    while (entry->distance > 0) {
+        auto next = path.back().moved(entry->next);
+        if (not next) {
+            return {};
+        }
+        const auto next_entry = find(*next);
+        if (not next_entry || next_entry->distance + 1 != entry->distance) {
+            return {};
+        }
+        path.push_back(std::move(*next));
+        entry = next_entry;
+    }
+    if (not path.back().is_goal()) {
+        return {};
+    }
+    return path;
+}
+
+std::size_t SolutionCache::capacity() const noexcept {
+    return (bucket_mask + 1) * bucket_slots;
+}
+
+std::size_t SolutionCache::memory() const noexcept {
+    return (bucket_mask + 1) * sizeof(Bucket);
+}
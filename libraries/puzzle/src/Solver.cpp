@@ -1,11 +1,22 @@
 #include "puzzle/Solver.hpp"
 
+#include "Distributed.hpp"
+#include "Mix.hpp"
+#include "Reduction.hpp"
+#include "puzzle/Generator.hpp"
+#include "puzzle/TranspositionTable.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
+#include <limits>
 #include <map>
-#include <memory>
-#include <queue>
 #include <set>
 #include <unordered_map>
+#include <unordered_set>
+#include <thread>
 
 Solver::Solution::Solution() noexcept {
     m_moves.resize(0);
@@ -13,6 +24,9 @@ Solver::Solution::Solution() noexcept {
 
 Solver::Solution::Solution(const std::vector<Board>& elements) noexcept : m_moves(elements) {}
 
+Solver::Solution::Solution(const std::vector<Board>& elements, const SolveStats& stats) noexcept
+    : m_moves(elements), m_stats(stats) {}
+
 std::size_t Solver::Solution::moves() const noexcept {
     if (m_moves.empty()) {
         return 0;
@@ -21,6 +35,19 @@ std::size_t Solver::Solution::moves() const noexcept {
     }
 }
 
+std::vector<Move> Solver::Solution::path() const noexcept {
+    std::vector<Move> result;
+    result.reserve(moves());
+    for (std::size_t i = 1; i < m_moves.size(); i++) {
+        result.push_back(*m_moves[i - 1].move_to(m_moves[i]));
+    }
+    return result;
+}
+
+const SolveStats& Solver::Solution::stats() const noexcept {
+    return m_stats;
+}
+
 Solver::Solution::const_iterator Solver::Solution::begin() const noexcept {
     return m_moves.begin();
 }
@@ -70,75 +97,1010 @@ std::vector<std::vector<std::vector<uint16_t>>> adjacent_board_states(
     return result;
 }
 
+namespace {
+
+// A board in the open list of A*. The path to it is kept in the `closed_set`.
+template <Heuristic H>
 struct solution_step {
-    solution_step(const Board& other, std::size_t cost, std::size_t depth, const std::shared_ptr<solution_step>& prev)
-        : state(other), cost(cost), depth(depth), prev(prev) {}
+    solution_step(const Board& other, const H& heuristic, std::size_t depth)
+        : state(other), heuristic(heuristic), cost(heuristic.value()), depth(depth) {}
 
     Board state;
+    H heuristic;
     std::size_t cost;
     std::size_t depth;
-    std::shared_ptr<solution_step> prev;
+    // `cost` is the exact distance taken from the solution cache or the perimeter.
+    bool exact = false;
+    // With partial expansion, the f the step is queued with once some of its children are
+    // generated, and the f up to which they are.
+    std::size_t bound     = 0;
+    std::size_t generated = 0;
+
+    [[nodiscard]] std::size_t priority() const noexcept {
+        return std::max(cost + depth, bound);
+    }
 };
 
-using solution_ptr = std::shared_ptr<solution_step>;
+struct search_result {
+    std::vector<Board> path;
+    // False if the open list had to be truncated, in which case the path may not be optimal.
+    bool exact = true;
+    SolveStats stats;
+};
 
-std::vector<Board> algorithm(const Board& start, const Board& goal) noexcept {
-    auto cmp = [](const solution_ptr& left, const solution_ptr& right) {
-        return (left->cost + left->depth) > (right->cost + right->depth);
+// Tracks the node and time budgets of one search.
+class budget_guard {
+public:
+    explicit budget_guard(const SolveOptions& options) noexcept
+        : node_budget(options.node_budget),
+          time_budget(options.time_budget),
+          started(std::chrono::steady_clock::now()) {}
+
+    [[nodiscard]] bool exhausted(std::size_t expanded) const noexcept {
+        if (node_budget != 0 && expanded >= node_budget) {
+            return true;
+        }
+        constexpr std::size_t clock_period = 1024;
+        return time_budget.count() != 0 && expanded % clock_period == 0 &&
+               std::chrono::steady_clock::now() - started >= time_budget;
+    }
+
+private:
+    std::size_t node_budget;
+    std::chrono::milliseconds time_budget;
+    std::chrono::steady_clock::time_point started;
+};
+
+// Cell the tile moved by `move` comes from, i.e. where the blank goes; nothing if it leaves the board.
+std::optional<std::size_t> next_blank(std::size_t blank, std::size_t side, Move move) noexcept {
+    switch (move) {
+        case Move::up:
+            return blank >= side ? std::optional(blank - side) : std::nullopt;
+        case Move::down:
+            return blank + side < side * side ? std::optional(blank + side) : std::nullopt;
+        case Move::left:
+            return blank % side > 0 ? std::optional(blank - 1) : std::nullopt;
+        case Move::right:
+            return blank % side + 1 < side ? std::optional(blank + 1) : std::nullopt;
+    }
+    return {};
+}
+
+// Operator table of enhanced partial expansion for the Manhattan distance: its change for every
+// cell of the blank, tile next to it and direction, so that children are ranked without being
+// generated.
+class manhattan_deltas {
+public:
+    explicit manhattan_deltas(std::size_t side) : side(side), deltas(side * side * side * side * 4) {
+        const std::size_t cells = side * side;
+        for (std::size_t blank = 0; blank < cells; blank++) {
+            for (auto move : {Move::up, Move::down, Move::left, Move::right}) {
+                const auto from = next_blank(blank, side, move);
+                if (not from) {
+                    continue;
+                }
+                const bool vertical = move == Move::up || move == Move::down;
+                const auto axis     = [&](std::size_t cell) {
+                    return static_cast<int>(vertical ? cell / side : cell % side);
+                };
+                for (std::size_t tile = 1; tile < cells; tile++) {
+                    const int goal = axis(tile - 1);
+                    deltas[index(blank, tile, move)] =
+                        static_cast<int8_t>(std::abs(axis(blank) - goal) - std::abs(axis(*from) - goal));
+                }
+            }
+        }
+    }
+
+    // Nothing if the move leaves the board.
+    [[nodiscard]] std::optional<int> operator()(const Board& board, Move move) const noexcept {
+        const std::size_t blank = board.blank();
+        const auto from         = next_blank(blank, side, move);
+        if (not from) {
+            return {};
+        }
+        return deltas[index(blank, board.tiles()[*from], move)];
+    }
+
+private:
+    [[nodiscard]] std::size_t index(std::size_t blank, std::size_t tile, Move move) const noexcept {
+        return (blank * side * side + tile) * 4 + static_cast<std::size_t>(move);
+    }
+
+    std::size_t side;
+    std::vector<int8_t> deltas;
+};
+
+// What identifies a board in the searches that keep boards apart: its rank where it has one,
+// its hash otherwise.
+uint64_t board_key(const Board& board) noexcept {
+    return board.size() <= Board::max_ranked_size ? board.rank() : board.hash();
+}
+
+// Closed set of A*: every board reached, with the fewest moves from the start it was reached in
+// and the last move of that path. Paths are rebuilt backwards from these moves, so boards are not
+// kept. A board of side up to 4 takes one word: its rank, the move and the moves from the start.
+// Larger ones take their hash, which stands for the board as it did in the hash map before, and
+// two more bytes; boards whose hashes collide share an entry, so their paths are checked.
+class closed_set {
+public:
+    struct entry {
+        Move move;
+        std::size_t depth;
     };
 
-    std::priority_queue<solution_ptr, std::vector<solution_ptr>, decltype(cmp)> queue{cmp};
-    std::unordered_map<std::size_t, solution_ptr> checked;
+    explicit closed_set(std::size_t side) noexcept
+        : ranked(side <= Board::max_ranked_size), keys(initial_slots, empty), extra(ranked ? 0 : initial_slots) {}
+
+    [[nodiscard]] std::optional<entry> find(const Board& board) const noexcept {
+        const std::size_t index = slot(key_of(board));
+        if (keys[index] == empty) {
+            return {};
+        }
+        if (ranked) {
+            return entry{static_cast<Move>(keys[index] >> move_shift & 3), keys[index] >> depth_shift};
+        }
+        return entry{static_cast<Move>(extra[index] & 3), static_cast<std::size_t>(extra[index] >> 2)};
+    }
 
-    auto initial_state    = std::make_shared<solution_step>(start, start.manhattan(), 0, nullptr);
-    checked[start.hash()] = initial_state;
-    queue.push(initial_state);
+    // The most moves from the start an entry can hold.
+    [[nodiscard]] std::size_t max_depth() const noexcept {
+        return ranked ? (std::size_t{1} << (64 - depth_shift)) - 1 : (std::size_t{1} << 14) - 1;
+    }
+
+    // Adds the board or replaces what is known of it; `depth` is at most `max_depth()`.
+    void assign(const Board& board, Move move, std::size_t depth) noexcept {
+        const uint64_t key = key_of(board);
+        if (keys[slot(key)] == empty) {
+            if (4 * (count + 1) > 3 * keys.size()) {
+                grow();
+            }
+            count++;
+        }
+        const std::size_t index = slot(key);
+        if (ranked) {
+            keys[index] = key | static_cast<uint64_t>(move) << move_shift | static_cast<uint64_t>(depth) << depth_shift;
+        } else {
+            keys[index]  = key;
+            extra[index] = static_cast<uint16_t>(depth << 2 | static_cast<std::size_t>(move));
+        }
+    }
+
+    // The path from `start` to `board` by the recorded moves, undone one by one. Every board on
+    // the way back was reached in fewer moves than the one after it; empty if the moves break off
+    // or do not lead back to `start`, as the entry of a colliding board can make them.
+    [[nodiscard]] std::vector<Board> path(const Board& start, const Board& board) const noexcept {
+        auto known = find(board);
+        std::vector<Board> result{board};
+        while (known && known->depth > 0) {
+            auto previous      = result.back().moved(opposite(known->move));
+            const auto earlier = previous ? find(*previous) : std::nullopt;
+            if (not earlier || earlier->depth >= known->depth) {
+                return {};
+            }
+            result.push_back(std::move(*previous));
+            known = earlier;
+        }
+        if (not known || result.back() != start) {
+            return {};
+        }
+        std::reverse(result.begin(), result.end());
+        return result;
+    }
+
+    [[nodiscard]] std::size_t memory() const noexcept {
+        return keys.size() * sizeof(uint64_t) + extra.size() * sizeof(uint16_t);
+    }
+
+private:
+    static constexpr uint64_t empty            = ~uint64_t{0};
+    static constexpr std::size_t initial_slots = 1024;
+    static constexpr unsigned move_shift       = 45;
+    static constexpr unsigned depth_shift      = 47;
+    static constexpr uint64_t rank_mask        = (uint64_t{1} << move_shift) - 1;
+
+    [[nodiscard]] uint64_t key_of(const Board& board) const noexcept {
+        return std::min<uint64_t>(board_key(board), empty - 1);
+    }
+
+    // Linear probing in a power-of-two table that is never more than three quarters full.
+    [[nodiscard]] std::size_t slot(uint64_t key) const noexcept {
+        const std::size_t mask = keys.size() - 1;
+        for (std::size_t index = mix(key) & mask;; index = (index + 1) & mask) {
+            if (keys[index] == empty || (ranked ? keys[index] & rank_mask : keys[index]) == key) {
+                return index;
+            }
+        }
+    }
+
+    void grow() noexcept {
+        std::vector<uint64_t> previous_keys(keys.size() * 2, empty);
+        std::vector<uint16_t> previous_extra(extra.size() * 2);
+        std::swap(keys, previous_keys);
+        std::swap(extra, previous_extra);
+        for (std::size_t index = 0; index < previous_keys.size(); index++) {
+            if (previous_keys[index] == empty) {
+                continue;
+            }
+            const std::size_t to = slot(ranked ? previous_keys[index] & rank_mask : previous_keys[index]);
+            keys[to]             = previous_keys[index];
+            if (not ranked) {
+                extra[to] = previous_extra[index];
+            }
+        }
+    }
+
+    bool ranked;
+    std::size_t count = 0;
+    std::vector<uint64_t> keys;
+    std::vector<uint16_t> extra;
+};
+
+template <Heuristic H>
+search_result astar(const Board& start, const Board& goal, const SolveOptions& options, H heuristic) noexcept {
+    const SolutionCache* cache = options.cache;
+    const Perimeter* perimeter =
+        options.perimeter != nullptr && options.perimeter->size() == start.size() ? options.perimeter : nullptr;
+    const budget_guard budget(options);
+
+    // Boards outside the perimeter are farther than its depth; those inside have exact costs.
+    const auto sharpen = [&](solution_step<H>& step) {
+        if (perimeter == nullptr) {
+            return;
+        }
+        if (const auto distance = perimeter->distance(step.state.rank())) {
+            step.cost  = *distance;
+            step.exact = true;
+        } else {
+            step.cost = std::max<std::size_t>(step.cost, perimeter->depth() + 1);
+        }
+    };
+    // The rest of an optimal solution from a board with an exact cost.
+    const auto rest = [&](const Board& board) -> std::optional<std::vector<Board>> {
+        if (perimeter != nullptr) {
+            if (auto path = perimeter->path(board); not path.empty()) {
+                return path;
+            }
+        }
+        return cache != nullptr ? cache->solution(board) : std::nullopt;
+    };
+
+    // Enhanced partial expansion generates only the children whose f is the parent's, and queues
+    // the parent again with the least f of the others. The table only exists for the Manhattan
+    // distance; other heuristics evaluate the children they hold back.
+    const bool partial = options.partial_expansion;
+    std::optional<manhattan_deltas> deltas;
+    if constexpr (std::same_as<H, ManhattanHeuristic>) {
+        if (partial) {
+            deltas.emplace(start.size());
+        }
+    }
+
+    // The open list is a binary heap of steps, the one of least f in front.
+    const auto cmp = [](const solution_step<H>& left, const solution_step<H>& right) {
+        return left.priority() > right.priority();
+    };
+    closed_set closed(start.size());
+    search_result result;
+
+    // Every phase of an expansion goes through one of these, under the hardware counters of
+    // `SolveOptions::perf_counters` when there are any.
+    const auto counters         = options.perf_counters ? PerfCounters::open() : std::nullopt;
+    result.stats.perf.available = counters.has_value();
+    const auto measure          = [&](Phase phase) {
+        return PerfScope(counters ? &*counters : nullptr, result.stats.perf, phase);
+    };
+    std::vector<solution_step<H>> queue;
+    const auto push = [&](solution_step<H>&& step) {
+        const auto scope = measure(Phase::open_list);
+        queue.push_back(std::move(step));
+        std::push_heap(queue.begin(), queue.end(), cmp);
+    };
+    const auto pop = [&]() {
+        const auto scope = measure(Phase::open_list);
+        std::pop_heap(queue.begin(), queue.end(), cmp);
+        auto step = std::move(queue.back());
+        queue.pop_back();
+        return step;
+    };
+    const auto successor = [&](const Board& board, Move move) {
+        const auto scope = measure(Phase::successors);
+        return board.moved(move);
+    };
+    const auto evaluate = [&](H& next_heuristic, const Board& board, Move move) {
+        const auto scope = measure(Phase::heuristic);
+        next_heuristic.update(board, move);
+    };
+    const auto find = [&](const Board& board) {
+        const auto scope = measure(Phase::closed_set);
+        return closed.find(board);
+    };
+
+    heuristic.init(start);
+    solution_step<H> initial_state(start, heuristic, 0);
+    sharpen(initial_state);
+    closed.assign(start, Move::up, 0);
+    queue.push_back(std::move(initial_state));
 
     while (not queue.empty()) {
-        auto current = queue.top();
-        if (current->state == goal) {
+        const auto& top = queue.front();
+        if (top.state == goal) {
+            const auto scope = measure(Phase::path);
+            result.path      = closed.path(start, goal);
+            break;
+        }
+        // A state with an exact cost and the lowest f lies on an optimal solution, and the rest
+        // of the path can be read from the cache or the perimeter.
+        if (top.exact) {
+            if (auto remaining = rest(top.state)) {
+                const auto scope = measure(Phase::path);
+                result.path      = closed.path(start, top.state);
+                if (not result.path.empty()) {
+                    result.path.insert(result.path.end(), remaining->begin() + 1, remaining->end());
+                }
+                break;
+            }
+        }
+        if (budget.exhausted(result.stats.expanded)) {
+            result.stats.budget_exhausted = true;
             break;
         }
 
-        queue.pop();
-        const auto one_step   = adjacent_board_states(current->state.get_board());
-        const auto next_depth = current->depth + 1;
+        auto current = pop();
+        // Reached again with fewer moves since it was queued, the board is queued once more.
+        if (find(current.state)->depth < current.depth) {
+            continue;
+        }
+        // Children deeper than the closed set can record end the search as the budget would.
+        if (current.depth + 1 > closed.max_depth()) {
+            result.stats.budget_exhausted = true;
+            break;
+        }
+        result.stats.expanded++;
+        const auto next_depth = current.depth + 1;
+        const auto bound      = current.priority();
+        auto held_back        = std::numeric_limits<std::size_t>::max();
 
-        for (auto& next : one_step) {
-            auto next_board      = Board(next);
-            const auto next_hash = next_board.hash();
-            const auto next_cost = next_board.manhattan();
+        for (auto move : {Move::up, Move::down, Move::left, Move::right}) {
+            std::optional<Board> next_board;
+            std::optional<H> next_heuristic;
+            if (partial) {
+                std::size_t estimate = 0;
+                if (deltas) {
+                    const auto scope = measure(Phase::heuristic);
+                    const auto delta = (*deltas)(current.state, move);
+                    if (not delta) {
+                        continue;
+                    }
+                    estimate = current.heuristic.value() + *delta;
+                } else {
+                    next_board = successor(current.state, move);
+                    if (not next_board) {
+                        continue;
+                    }
+                    next_heuristic = current.heuristic;
+                    evaluate(*next_heuristic, *next_board, move);
+                    estimate = next_heuristic->value();
+                }
+                // Children up to `generated` came with an earlier expansion of this step.
+                const auto next_f = next_depth + estimate;
+                if (next_f <= current.generated) {
+                    continue;
+                }
+                if (next_f > bound) {
+                    held_back = std::min(held_back, next_f);
+                    continue;
+                }
+            }
+            if (not next_board) {
+                next_board = successor(current.state, move);
+                if (not next_board) {
+                    continue;
+                }
+            }
+            result.stats.generated++;
 
-            if (not checked.contains(next_hash) || next_depth < checked[next_hash]->depth) {
-                auto next_step     = std::make_shared<solution_step>(next_board, next_cost, next_depth, current);
-                checked[next_hash] = next_step;
-                queue.push(next_step);
+            const auto known = find(*next_board);
+            if (not known || next_depth < known->depth) {
+                if (not next_heuristic) {
+                    next_heuristic = current.heuristic;
+                    evaluate(*next_heuristic, *next_board, move);
+                }
+                solution_step<H> next_step(*next_board, *next_heuristic, next_depth);
+                sharpen(next_step);
+                if (const auto entry = cache != nullptr ? cache->find(*next_board) : std::nullopt) {
+                    next_step.cost  = entry->distance;
+                    next_step.exact = true;
+                }
+                {
+                    const auto scope = measure(Phase::closed_set);
+                    closed.assign(*next_board, move, next_depth);
+                }
+                push(std::move(next_step));
             }
         }
+        if (held_back != std::numeric_limits<std::size_t>::max()) {
+            current.generated = bound;
+            current.bound     = held_back;
+            push(std::move(current));
+        }
 
         constexpr std::size_t max_queue_size = 50'000;
         if (queue.size() > max_queue_size * 2) {
-            std::priority_queue<solution_ptr, std::vector<solution_ptr>, decltype(cmp)> new_queue{cmp};
+            const auto scope = measure(Phase::open_list);
+            std::vector<solution_step<H>> kept;
+            kept.reserve(max_queue_size);
             for (std::size_t i = 0; i < max_queue_size; i++) {
-                new_queue.push(queue.top());
-                queue.pop();
+                std::pop_heap(queue.begin(), queue.end(), cmp);
+                kept.push_back(std::move(queue.back()));
+                queue.pop_back();
             }
+            std::make_heap(kept.begin(), kept.end(), cmp);
+            std::swap(queue, kept);
+            result.exact = false;
+        }
+    }
+
+    result.stats.closed_memory = closed.memory();
+    return result;
+}
+
+// Breadth-first heuristic search: layer after layer from one board, keeping the boards whose f is
+// within a bound. The graph of moves is bipartite, so a board of the next layer can only have
+// been seen in it or in the one before the current layer, and no other layer is kept but the
+// middle one. Every board past the middle carries the middle board it descends from, and the
+// path is recovered by searching the two halves around that board the same way.
+template <Heuristic H>
+class layered_search {
+public:
+    layered_search(const budget_guard& budget, SolveStats& stats, const PerfCounters* counters) noexcept
+        : budget(budget), stats(stats), counters(counters) {}
+
+    // Bound on f = moves from the start + estimate; the least f above it met so far; whether the
+    // budget ran out, which ends every search.
+    std::size_t bound      = 0;
+    std::size_t next_bound = std::numeric_limits<std::size_t>::max();
+    bool exhausted         = false;
+
+    // A shortest path from `from` to `to`, `offset` moves from the start, of at most `length` moves
+    // along boards within the bound; nothing if there is none.
+    std::optional<std::vector<Board>> path(const Board& from, const H& heuristic, const Board& to, std::size_t offset,
+                                           std::size_t length) noexcept {
+        if (from == to) {
+            return std::vector<Board>{from};
+        }
+        // Cells of the tiles of `to`, for the Manhattan distance to it: a path needs at least that
+        // many moves more.
+        std::vector<std::size_t> target(to.tiles().size());
+        for (std::size_t cell = 0; cell < target.size(); cell++) {
+            target[to.tiles()[cell]] = cell;
+        }
+        const auto apart = [&](const Board& board) {
+            const std::size_t side = board.size();
+            std::size_t moves      = 0;
+            for (std::size_t cell = 0; cell < target.size(); cell++) {
+                if (const auto tile = board.tiles()[cell]; tile != 0) {
+                    const std::size_t other = target[tile];
+                    moves += std::max(cell / side, other / side) - std::min(cell / side, other / side);
+                    moves += std::max(cell % side, other % side) - std::min(cell % side, other % side);
+                }
+            }
+            return moves;
+        };
+
+        const std::size_t middle = length / 2;
+        std::vector<step> current{{from, heuristic, 0}};
+        std::vector<step> relays;
+        std::unordered_set<uint64_t> previous_keys;
+        std::unordered_set<uint64_t> current_keys{board_key(from)};
+        for (std::size_t depth = 0; depth < length && not current.empty(); depth++) {
+            if (depth == middle) {
+                for (std::size_t index = 0; index < current.size(); index++) {
+                    current[index].relay = index;
+                }
+                relays = current;
+            }
+            std::vector<step> next;
+            std::unordered_set<uint64_t> next_keys;
+            for (const auto& parent : current) {
+                if (budget.exhausted(stats.expanded)) {
+                    exhausted = true;
+                    return {};
+                }
+                stats.expanded++;
+                for (auto move : {Move::up, Move::down, Move::left, Move::right}) {
+                    auto board = measure(Phase::successors, [&]() { return parent.board.moved(move); });
+                    if (not board) {
+                        continue;
+                    }
+                    stats.generated++;
+                    const uint64_t key = board_key(*board);
+                    if (measure(Phase::closed_set,
+                                [&]() { return previous_keys.contains(key) || next_keys.contains(key); })) {
+                        continue;
+                    }
+                    H next_heuristic = parent.heuristic;
+                    measure(Phase::heuristic, [&]() { next_heuristic.update(*board, move); });
+                    const std::size_t f = offset + depth + 1 + next_heuristic.value();
+                    if (f > bound) {
+                        next_bound = std::min(next_bound, f);
+                        continue;
+                    }
+                    if (depth + 1 + apart(*board) > length) {
+                        continue;
+                    }
+                    if (*board == to) {
+                        return split(from, heuristic, to, offset, depth + 1,
+                                     depth >= middle ? &relays[parent.relay] : nullptr);
+                    }
+                    measure(Phase::closed_set, [&]() { next_keys.insert(key); });
+                    measure(Phase::open_list,
+                            [&]() { next.push_back({std::move(*board), next_heuristic, parent.relay}); });
+                }
+            }
+            stats.frontier_peak = std::max(stats.frontier_peak,
+                                           previous_keys.size() + current.size() + next.size() + relays.size());
+            previous_keys = std::move(current_keys);
+            current_keys  = std::move(next_keys);
+            current       = std::move(next);
+        }
+        return {};
+    }
+
+private:
+    struct step {
+        Board board;
+        H heuristic;
+        // Index of the middle board it descends from.
+        std::size_t relay;
+    };
 
-            std::swap(queue, new_queue);
+    // The path to `to`, found `moves` moves from `from` through `relay` when past the middle.
+    std::optional<std::vector<Board>> split(const Board& from, const H& heuristic, const Board& to, std::size_t offset,
+                                            std::size_t moves, const step* relay) noexcept {
+        if (moves == 1) {
+            return std::vector<Board>{from, to};
+        }
+        if (relay == nullptr) {
+            // Found before the middle: the search again with the length known sets one.
+            return path(from, heuristic, to, offset, moves);
+        }
+        const std::size_t half = moves / 2;
+        const auto middle      = relay->board;
+        const auto middle_h    = relay->heuristic;
+        auto first             = path(from, heuristic, middle, offset, half);
+        if (not first) {
+            return {};
         }
+        auto second = path(middle, middle_h, to, offset + half, moves - half);
+        if (not second) {
+            return {};
+        }
+        measure(Phase::path, [&]() { first->insert(first->end(), second->begin() + 1, second->end()); });
+        return first;
     }
 
-    std::vector<Board> result;
-    auto current = queue.top();
-    while (current) {
-        result.insert(result.begin(), current->state);
-        current = current->prev;
+    // What `work` returns, counted as `phase`.
+    template <typename F>
+    auto measure(Phase phase, F&& work) noexcept {
+        const PerfScope scope(counters, stats.perf, phase);
+        return work();
     }
 
+    const budget_guard& budget;
+    SolveStats& stats;
+    const PerfCounters* counters;
+};
+
+// Breadth-first heuristic search under bounds on f that rise as in iterative deepening.
+template <Heuristic H>
+search_result breadth_first(const Board& start, const Board& goal, const SolveOptions& options, H heuristic) noexcept {
+    const budget_guard budget(options);
+    search_result result;
+    const auto counters         = options.perf_counters ? PerfCounters::open() : std::nullopt;
+    result.stats.perf.available = counters.has_value();
+    layered_search<H> search(budget, result.stats, counters ? &*counters : nullptr);
+
+    heuristic.init(start);
+    search.bound = heuristic.value();
+    while (true) {
+        search.next_bound = std::numeric_limits<std::size_t>::max();
+        if (auto path = search.path(start, heuristic, goal, 0, search.bound)) {
+            result.path = std::move(*path);
+            break;
+        }
+        if (search.exhausted) {
+            result.stats.budget_exhausted = true;
+            break;
+        }
+        if (search.next_bound == std::numeric_limits<std::size_t>::max()) {
+            break;
+        }
+        search.bound = search.next_bound;
+    }
     return result;
 }
 
-Solver::Solution Solver::solve(const Board& board) noexcept {
+// Further estimates of iterative deepening, see `SolveOptions::lookups`: the pattern databases of
+// the board's size looked up on boards as far from the goal.
+class extra_lookups {
+public:
+    using Lookups = SolveOptions::Lookups;
+
+    extra_lookups(const Board& start, const SolveOptions& options) noexcept : kind(options.lookups) {
+        for (const auto* database : options.patterns) {
+            if (database != nullptr && database->size() == start.size()) {
+                databases.push_back(database);
+            }
+        }
+        if (databases.empty()) {
+            kind = Lookups::regular;
+        }
+    }
+
+    // Room for the boards the lookups derive, so that they allocate nothing; one per thread.
+    struct scratch {
+        std::array<uint16_t, PatternDatabase::max_cells> walked;
+        std::array<uint16_t, PatternDatabase::max_cells> dual;
+    };
+
+    // Zero when there are none. The reflected lookup is already part of the search's heuristic,
+    // see `choose_heuristic`, so only the dual is left to look up.
+    [[nodiscard]] unsigned operator()(const Board& board, scratch& space) const noexcept {
+        switch (kind) {
+            case Lookups::regular:
+            case Lookups::reflected:
+                return 0;
+            case Lookups::dual:
+            case Lookups::both:
+                return dual(board, space);
+            case Lookups::random:
+                return board.hash() % 2 == 0 ? 0 : dual(board, space);
+        }
+        return 0;
+    }
+
+private:
+    [[nodiscard]] unsigned lookup(std::span<const uint16_t> tiles) const noexcept {
+        unsigned estimate = 0;
+        for (const auto* database : databases) {
+            estimate = std::max(estimate, database->estimate(tiles));
+        }
+        return estimate;
+    }
+
+    // In the dual board tiles and cells trade places: the tile at home in cell c goes to where
+    // the tile at home in the other's cell is. The dual is as far from the goal only with the
+    // blank at home, so the blank is first walked home, and the moves of the walk are taken off.
+    [[nodiscard]] unsigned dual(const Board& board, scratch& space) const noexcept {
+        const std::size_t side  = board.size();
+        const std::size_t cells = side * side;
+        const std::size_t last  = cells - 1;
+        auto& tiles             = space.walked;
+        std::copy(board.tiles().begin(), board.tiles().end(), tiles.begin());
+        std::size_t blank = board.blank();
+        unsigned walk     = 0;
+        for (; blank / side + 1 < side; blank += side, walk++) {
+            std::swap(tiles[blank], tiles[blank + side]);
+        }
+        for (; blank % side + 1 < side; blank++, walk++) {
+            std::swap(tiles[blank], tiles[blank + 1]);
+        }
+
+        // Tiles are named by their home cells here: tile t by t - 1, the blank by the last cell.
+        // The dual holds in the home cell of each the tile at home in the cell it is in.
+        for (std::size_t cell = 0; cell <= last; cell++) {
+            const std::size_t home = tiles[cell] == 0 ? last : tiles[cell] - 1u;
+            space.dual[home]       = static_cast<uint16_t>(cell == last ? 0 : cell + 1);
+        }
+        const unsigned estimate = lookup(std::span<const uint16_t>(space.dual.data(), cells));
+        return estimate > walk ? estimate - walk : 0;
+    }
+
+    Lookups kind;
+    std::vector<const PatternDatabase*> databases;
+};
+
+// The machine of iterative deepening without a `SolveOptions::move_pruner`.
+const MovePruner& undo_pruner() noexcept {
+    static const MovePruner pruner = *MovePruner::learn(2);
+    return pruner;
+}
+
+// State shared by the threads of one iterative deepening search.
+struct deepening_shared {
+    deepening_shared(TranspositionTable* table, const budget_guard& budget, const SolveOptions& options,
+                     const Board& start) noexcept
+        : table(table),
+          budget(budget),
+          lookups(start, options),
+          pathmax(options.pathmax),
+          pruner(options.move_pruner != nullptr ? *options.move_pruner : undo_pruner()),
+          pruning(options.move_pruner != nullptr),
+          counting(options.perf_counters) {}
+
+    // Null for boards the table does not support.
+    TranspositionTable* table;
+    const budget_guard& budget;
+    const extra_lookups lookups;
+    const bool pathmax;
+    const MovePruner& pruner;
+    // Whether `pruner` is more than the one that only forbids undoing a move.
+    const bool pruning;
+    // Whether every thread counts its phases into its own slot of `perf`.
+    const bool counting;
+    unsigned bound = 0;
+    // The least f above `bound` met so far, the bound of the next iteration.
+    std::atomic<unsigned> next_bound{0};
+    std::atomic<bool> solved{false};
+    std::atomic<bool> exhausted{false};
+    std::atomic<std::size_t> expanded{0};
+    std::atomic<std::size_t> generated{0};
+    std::atomic<std::size_t> lookups_raised{0};
+    std::atomic<std::size_t> pathmax_cutoffs{0};
+    // Written only by the thread that sets `solved`.
+    std::vector<Board> path;
+    // One report per thread, summed once the threads are joined.
+    std::vector<PerfReport> perf;
+
+    void exceed(unsigned f) noexcept {
+        unsigned least = next_bound.load(std::memory_order_relaxed);
+        while (f < least && not next_bound.compare_exchange_weak(least, f, std::memory_order_relaxed)) {
+        }
+    }
+};
+
+// One thread of iterative deepening: a depth-first search of the paths whose f stays within the
+// bound, with the moves tried in an order of its own.
+template <Heuristic H>
+class deepening_thread {
+public:
+    deepening_thread(deepening_shared& shared, std::size_t index) noexcept
+        : shared(shared), counters(shared.counting ? PerfCounters::open() : std::nullopt), index(index) {
+        perf.available               = counters.has_value();
+        constexpr std::size_t orders = 24;
+        for (std::size_t i = 0; i < index % orders; i++) {
+            std::next_permutation(order.begin(), order.end());
+        }
+    }
+
+    void run(const Board& start, const H& heuristic, unsigned estimate) noexcept {
+        path.assign(1, start);
+        search(heuristic, estimate, MovePruner::start);
+        flush();
+        if (shared.counting) {
+            shared.perf[index] += perf;
+        }
+    }
+
+private:
+    struct child {
+        Board board;
+        H heuristic;
+        unsigned estimate;
+        MovePruner::State state;
+    };
+
+    // Whether the search is over, by this thread or another. With pathmax, `estimate` is raised
+    // to what the children show.
+    bool search(const H& heuristic, unsigned& estimate, MovePruner::State state) noexcept {
+        if (path.back().is_goal()) {
+            if (not shared.solved.exchange(true)) {
+                const auto scope = measure(Phase::path);
+                shared.path      = path;
+            }
+            return true;
+        }
+        if (shared.solved.load(std::memory_order_relaxed) || shared.exhausted.load(std::memory_order_relaxed)) {
+            return true;
+        }
+        // Counts are shared in batches, the budget's clock being read once per batch anyway.
+        constexpr std::size_t batch = 1024;
+        if (++expanded == batch) {
+            const std::size_t total = shared.expanded.load(std::memory_order_relaxed) + batch;
+            flush();
+            if (shared.budget.exhausted(total)) {
+                shared.exhausted = true;
+                return true;
+            }
+        }
+
+        // Every child is estimated before any is searched, so that pathmax can cut them all.
+        const auto moves = static_cast<unsigned>(path.size());
+        std::optional<child> children[4];
+        std::size_t count = 0;
+        for (auto move : order) {
+            std::optional<Board> next;
+            auto next_state = MovePruner::pruned;
+            {
+                const auto scope = measure(Phase::successors);
+                next_state       = shared.pruner.next(state, move);
+                if (next_state == MovePruner::pruned) {
+                    continue;
+                }
+                next = path.back().moved(move);
+                if (not next) {
+                    continue;
+                }
+            }
+            generated++;
+            H next_heuristic = heuristic;
+            unsigned regular = 0;
+            unsigned extra   = 0;
+            {
+                const auto scope = measure(Phase::heuristic);
+                next_heuristic.update(*next, move);
+                regular = next_heuristic.value();
+                extra   = shared.lookups(*next, space);
+            }
+            raised += extra > regular ? 1 : 0;
+            children[count++].emplace(std::move(*next), next_heuristic, std::max(regular, extra), next_state);
+        }
+
+        const auto lift = [&](unsigned child_estimate) {
+            if (not shared.pathmax || child_estimate <= estimate + 1) {
+                return false;
+            }
+            estimate = child_estimate - 1;
+            if (moves - 1 + estimate <= shared.bound) {
+                return false;
+            }
+            cutoffs++;
+            shared.exceed(moves - 1 + estimate);
+            return true;
+        };
+        for (std::size_t i = 0; i < count; i++) {
+            if (lift(children[i]->estimate)) {
+                return false;
+            }
+        }
+        for (std::size_t i = 0; i < count; i++) {
+            auto& next       = *children[i];
+            const unsigned f = moves + next.estimate;
+            if (f > shared.bound) {
+                shared.exceed(f);
+                continue;
+            }
+            if (shared.table != nullptr) {
+                const auto scope = measure(Phase::closed_set);
+                if (not shared.table->visit(next.board, moves, shared.bound, shared.pruning)) {
+                    continue;
+                }
+            }
+            path.push_back(std::move(next.board));
+            if (search(next.heuristic, next.estimate, next.state)) {
+                return true;
+            }
+            path.pop_back();
+            if (lift(next.estimate)) {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    void flush() noexcept {
+        shared.expanded.fetch_add(expanded, std::memory_order_relaxed);
+        shared.generated.fetch_add(generated, std::memory_order_relaxed);
+        shared.lookups_raised.fetch_add(raised, std::memory_order_relaxed);
+        shared.pathmax_cutoffs.fetch_add(cutoffs, std::memory_order_relaxed);
+        expanded  = 0;
+        generated = 0;
+        raised    = 0;
+        cutoffs   = 0;
+    }
+
+    // Phases of this thread. There is no open list, the path being the stack of the search, and
+    // the transposition table stands in for the closed set.
+    PerfScope measure(Phase phase) noexcept {
+        return PerfScope(counters ? &*counters : nullptr, perf, phase);
+    }
+
+    deepening_shared& shared;
+    std::optional<PerfCounters> counters;
+    const std::size_t index;
+    PerfReport perf;
+    std::array<Move, 4> order{Move::up, Move::down, Move::left, Move::right};
+    std::vector<Board> path;
+    extra_lookups::scratch space;
+    std::size_t expanded  = 0;
+    std::size_t generated = 0;
+    std::size_t raised    = 0;
+    std::size_t cutoffs   = 0;
+};
+
+// IDA*: depth-first searches under a bound on f that starts at the estimate of `start` and rises
+// to the least f above it after every search that fails.
+template <Heuristic H>
+search_result deepen(const Board& start, const SolveOptions& options, H heuristic) noexcept {
+    const budget_guard budget(options);
+    const bool tabled = TranspositionTable::supports(start);
+    TranspositionTable table(tabled ? options.transposition_bytes : 0);
+    deepening_shared shared(tabled ? &table : nullptr, budget, options, start);
+    shared.perf.resize(std::max(options.deepening_threads, 1u));
+
+    heuristic.init(start);
+    extra_lookups::scratch space;
+    const unsigned estimate = std::max(heuristic.value(), shared.lookups(start, space));
+    shared.bound            = estimate;
+    search_result result;
+    while (true) {
+        shared.next_bound = std::numeric_limits<unsigned>::max();
+        std::vector<std::thread> pool;
+        for (unsigned index = 1; index < options.deepening_threads; index++) {
+            pool.emplace_back([&, index]() { deepening_thread<H>(shared, index).run(start, heuristic, estimate); });
+        }
+        deepening_thread<H>(shared, 0).run(start, heuristic, estimate);
+        for (auto& thread : pool) {
+            thread.join();
+        }
+
+        if (shared.solved) {
+            result.path = std::move(shared.path);
+            break;
+        }
+        if (shared.exhausted) {
+            result.stats.budget_exhausted = true;
+            break;
+        }
+        if (shared.next_bound == std::numeric_limits<unsigned>::max()) {
+            break;
+        }
+        shared.bound = shared.next_bound;
+    }
+    result.stats.expanded        = shared.expanded;
+    result.stats.generated       = shared.generated;
+    result.stats.lookups_raised  = shared.lookups_raised;
+    result.stats.pathmax_cutoffs = shared.pathmax_cutoffs;
+    for (const auto& report : shared.perf) {
+        result.stats.perf += report;
+    }
+    return result;
+}
+
+// Transposition-driven scheduling over worker processes, see `distributed::search`. A caller with
+// other threads cannot fork safely and gets iterative deepening on as many threads instead.
+template <Heuristic H>
+search_result distribute(const Board& start, const SolveOptions& options, const H& heuristic) noexcept {
+    if (not distributed::forkable()) {
+        SolveOptions threaded      = options;
+        threaded.deepening_threads = options.distributed_workers;
+        return deepen(start, threaded, heuristic);
+    }
+    auto found = distributed::search(start, options, heuristic);
+    search_result result;
+    result.path  = std::move(found.path);
+    result.stats = found.stats;
+    return result;
+}
+
+// The heuristic `options` ask for: pattern databases only count for boards of their size.
+AnyHeuristic choose_heuristic(const Board& board, const SolveOptions& options) noexcept {
+    std::vector<PatternHeuristic> patterns;
+    for (const auto* database : options.patterns) {
+        if (database != nullptr && database->size() == board.size()) {
+            patterns.emplace_back(*database, true);
+        }
+    }
+    if (patterns.size() == 2) {
+        return MaxHeuristic(LinearConflictHeuristic(), patterns[0], patterns[1]);
+    }
+    if (patterns.size() == 1) {
+        return MaxHeuristic(LinearConflictHeuristic(), patterns[0]);
+    }
+    if (options.linear_conflict) {
+        return LinearConflictHeuristic();
+    }
+    return ManhattanHeuristic();
+}
+
+}  // anonymous namespace
+
+template <Heuristic H>
+Solver::Solution Solver::solve(const Board& board, const SolveOptions& options, const H& heuristic) noexcept {
+    if (not board.validate()) {
+        return {};
+    }
     if (board.size() == 0 || board.size() == 1) {
         std::vector<Board> result(1, board);
         return {result};
@@ -148,7 +1110,308 @@ Solver::Solution Solver::solve(const Board& board) noexcept {
         return {result};
     }
 
-    Board goal                = Board::create_goal(board.size());
-    std::vector<Board> result = algorithm(board, goal);
-    return {result};
+    if (options.distances != nullptr && options.distances->supports(board)) {
+        return {options.distances->path(board)};
+    }
+    if (options.perimeter != nullptr) {
+        if (auto path = options.perimeter->path(board); not path.empty()) {
+            return {path};
+        }
+    }
+
+    SolutionCache* cache = options.cache;
+    if (cache != nullptr) {
+        if (auto cached = cache->solution(board)) {
+            return {*cached};
+        }
+    }
+
+    Board goal          = Board::create_goal(board.size());
+    const auto searched = options.deepening_threads != 0   ? deepen(board, options, heuristic)
+                          : options.distributed_workers != 0 ? distribute(board, options, heuristic)
+                          : options.breadth_first            ? breadth_first(board, goal, options, heuristic)
+                                                             : astar(board, goal, options, heuristic);
+    if (cache != nullptr && searched.exact && not searched.path.empty()) {
+        cache->insert(searched.path);
+    }
+    return {searched.path, searched.stats};
+}
+
+template Solver::Solution Solver::solve(const Board&, const SolveOptions&, const ManhattanHeuristic&) noexcept;
+template Solver::Solution Solver::solve(const Board&, const SolveOptions&, const LinearConflictHeuristic&) noexcept;
+template Solver::Solution Solver::solve(const Board&, const SolveOptions&, const PatternHeuristic&) noexcept;
+template Solver::Solution Solver::solve(const Board&, const SolveOptions&,
+                                        const MaxHeuristic<LinearConflictHeuristic, PatternHeuristic>&) noexcept;
+template Solver::Solution Solver::solve(
+    const Board&, const SolveOptions&,
+    const MaxHeuristic<LinearConflictHeuristic, PatternHeuristic, PatternHeuristic>&) noexcept;
+
+Solver::Solution Solver::solve(const Board& board, const SolveOptions& options) noexcept {
+    return std::visit([&](const auto& heuristic) { return solve(board, options, heuristic); },
+                      choose_heuristic(board, options));
+}
+
+std::vector<Board> algorithm(const Board& start, const Board& goal) noexcept {
+    return astar(start, goal, {}, ManhattanHeuristic()).path;
+}
+
+Solver::Solution Solver::solve(const Board& board) noexcept {
+    return solve(board, SolveOptions{});
+}
+
+Solver::Solution Solver::solve(const Board& board, SolutionCache& cache) noexcept {
+    SolveOptions options;
+    options.cache = &cache;
+    return solve(board, options);
+}
+
+std::optional<std::vector<Move>> Solver::approximate(const Board& board) noexcept {
+    if (not board.validate() || not board.is_solvable()) {
+        return {};
+    }
+    const std::size_t side = board.size();
+    if (side <= 3) {
+        return solve(board).path();
+    }
+
+    std::vector<uint16_t> tiles(board.tiles().begin(), board.tiles().end());
+    auto moves = reduction::place(tiles, side);
+
+    // What is left lies in the bottom-right 3x3 block; renumbered, it is a board of its own.
+    const std::size_t corner = side - 3;
+    std::vector<uint16_t> block(9);
+    for (std::size_t row = 0; row < 3; row++) {
+        for (std::size_t column = 0; column < 3; column++) {
+            const uint16_t tile = tiles[(corner + row) * side + corner + column];
+            if (tile != 0) {
+                const std::size_t goal     = tile - 1u;
+                block[row * 3 + column] = static_cast<uint16_t>((goal / side - corner) * 3 + goal % side - corner + 1);
+            }
+        }
+    }
+    const auto rest = solve(Board(3, block)).path();
+    moves.insert(moves.end(), rest.begin(), rest.end());
+    return reduction::shorten(board.tiles(), side, moves);
+}
+
+Solver::Solution Solver::repair(const Solution& previous, const Board& board, const RepairOptions& options) noexcept {
+    const std::vector<Board> old(previous.begin(), previous.end());
+    if (old.empty() || not old.back().is_goal() || old.front().size() != board.size() || board.size() < 2 ||
+        not board.validate() || not board.is_solvable()) {
+        return solve(board, options.solve);
+    }
+
+    // Boards of the old path by their position on it; from position i, n - i moves are left. A
+    // repaired solution longer than the bound it found is not known to be optimal, so its boards
+    // bound nothing and give the search no costs.
+    const bool optimal       = not previous.stats().repaired || previous.moves() <= previous.stats().lower_bound;
+    const std::size_t length = old.size() - 1;
+    std::unordered_map<uint64_t, std::size_t> position;
+    for (std::size_t index = 0; index < old.size(); index++) {
+        position.emplace(board_key(old[index]), index);
+    }
+    const std::size_t estimate = std::visit(
+        [&](auto heuristic) {
+            heuristic.init(board);
+            return static_cast<std::size_t>(heuristic.value());
+        },
+        choose_heuristic(board, options.solve));
+
+    // Layer by layer from the board, with the move every board was first reached by, until the
+    // best join is within the slack of the lower bound or the window is searched.
+    constexpr auto unseen = std::numeric_limits<std::size_t>::max();
+    SolveStats stats;
+    std::unordered_map<uint64_t, Move> reached{{board_key(board), Move::up}};
+    std::vector<std::size_t> distance(old.size(), unseen);
+    std::vector<Board> layer{board};
+    std::optional<Board> join;
+    std::size_t joined = unseen;
+    std::size_t index  = 0;
+    std::size_t lower  = estimate;
+    bool close_enough  = false;
+    for (std::size_t depth = 0; not layer.empty(); depth++) {
+        for (const auto& current : layer) {
+            const auto on = position.find(board_key(current));
+            if (on != position.end() && distance[on->second] == unseen) {
+                distance[on->second] = depth;
+                if (depth + length - on->second < joined) {
+                    joined = depth + length - on->second;
+                    index  = on->second;
+                    join   = current;
+                }
+            }
+        }
+        for (std::size_t at = 0; at < old.size() && optimal; at++) {
+            if (distance[at] != unseen && length - at > distance[at]) {
+                lower = std::max(lower, length - at - distance[at]);
+            }
+        }
+        close_enough = join && (joined <= lower || joined - lower <= options.slack);
+        if (close_enough || depth == options.window) {
+            break;
+        }
+
+        std::vector<Board> next;
+        for (const auto& current : layer) {
+            stats.expanded++;
+            for (auto move : {Move::up, Move::down, Move::left, Move::right}) {
+                auto child = current.moved(move);
+                if (not child) {
+                    continue;
+                }
+                stats.generated++;
+                if (reached.try_emplace(board_key(*child), move).second) {
+                    next.push_back(std::move(*child));
+                }
+            }
+        }
+        layer = std::move(next);
+    }
+
+    if (close_enough) {
+        std::vector<Board> path{*join};
+        while (path.back() != board) {
+            const auto move = reached.find(board_key(path.back()))->second;
+            path.push_back(*path.back().moved(opposite(move)));
+        }
+        std::reverse(path.begin(), path.end());
+        path.insert(path.end(), old.begin() + static_cast<std::ptrdiff_t>(index) + 1, old.end());
+        stats.repaired    = true;
+        stats.lower_bound = lower;
+        return {path, stats};
+    }
+
+    // The old path gives the search exact costs to stop at. They are only as good as `previous`, so
+    // they go in a cache of the repair's own: the caller's is answered from, and only given a
+    // solution the heuristic proves optimal.
+    auto solve_options   = options.solve;
+    SolutionCache* cache = options.solve.cache;
+    std::optional<SolutionCache> seeded;
+    if (optimal && SolutionCache::supports(board)) {
+        if (auto cached = cache != nullptr ? cache->solution(board) : std::nullopt) {
+            return {*cached, stats};
+        }
+        seeded.emplace(std::size_t{1} << 16);
+        seeded->insert(old);
+        solve_options.cache = &*seeded;
+    }
+    const auto solved = solve(board, solve_options);
+    if (seeded && cache != nullptr && solved.begin() != solved.end() && solved.moves() <= estimate) {
+        cache->insert(std::vector<Board>(solved.begin(), solved.end()));
+    }
+    auto searched     = solved.stats();
+    searched.expanded += stats.expanded;
+    searched.generated += stats.generated;
+    return {std::vector<Board>(solved.begin(), solved.end()), searched};
+}
+
+Solver::Solution Solver::repair(const Solution& previous, const Board& board) noexcept {
+    return repair(previous, board, RepairOptions{});
+}
+
+namespace {
+
+// Share of random boards of a size whose Manhattan distance is at most v, by v. Sampled from a
+// fixed seed on first use of the size by a thread, from fewer boards the more tiles they have,
+// whose distances spread less. Every thread samples the same shares, and keeping its own needs
+// no lock.
+const std::vector<double>& manhattan_distribution(unsigned size) noexcept {
+    thread_local std::map<unsigned, std::vector<double>> distributions;
+    auto& shares = distributions[size];
+    if (shares.empty()) {
+        const std::size_t samples = std::clamp<std::size_t>((std::size_t{1} << 20) / (size * size), 256, 4096);
+        Generator generator(size);
+        std::vector<std::size_t> counts;
+        for (std::size_t i = 0; i < samples; i++) {
+            ManhattanHeuristic heuristic;
+            heuristic.init(generator.solvable(size));
+            counts.resize(std::max<std::size_t>(counts.size(), heuristic.value() + 1));
+            counts[heuristic.value()]++;
+        }
+        std::size_t below = 0;
+        for (auto count : counts) {
+            below += count;
+            shares.push_back(static_cast<double>(below) / samples);
+        }
+    }
+    return shares;
+}
+
+}  // anonymous namespace
+
+double Solver::estimate(const Board& board) noexcept {
+    if (not board.validate() || board.size() < 2 || not board.is_solvable() || board.is_goal()) {
+        return 0;
+    }
+    ManhattanHeuristic heuristic;
+    heuristic.init(board);
+    const auto& shares = manhattan_distribution(static_cast<unsigned>(board.size()));
+    double mean        = 0;
+    for (std::size_t value = 1; value < shares.size(); value++) {
+        mean += static_cast<double>(value) * (shares[value] - shares[value - 1]);
+    }
+    // Optimal solutions of random boards run about half again their Manhattan distance (22
+    // against 14 moves for the 8-puzzle, 53 against 37 for the 15-puzzle). The board's is guessed
+    // halfway between its own distance and that, when that is more.
+    const unsigned first   = heuristic.value();
+    const unsigned typical = static_cast<unsigned>(std::lround(1.5 * mean));
+    unsigned last          = first + (typical > first ? (typical - first) / 2 : 0);
+    last += (last - first) % 2;
+
+    // Only paths that leave some random board's estimate under a bound count, and no budget can
+    // tell counts past the largest node budget apart: they saturate there.
+    const auto lowest = static_cast<std::size_t>(
+        std::find_if(shares.begin(), shares.end(), [](double share) { return share > 0; }) - shares.begin());
+    if (last < lowest) {
+        return 0;
+    }
+    const std::size_t horizon = last - lowest;
+    constexpr auto most       = static_cast<double>(std::numeric_limits<std::size_t>::max());
+
+    // Paths of every length from the board that never undo a move, counted by the cell the blank
+    // ends in and its last move.
+    const std::size_t side = board.size();
+    std::vector<double> paths(std::max<std::size_t>(horizon, 1) + 1);
+    std::vector<std::array<double, 4>> ending(side * side);
+    paths[0] = 1;
+    for (auto move : {Move::up, Move::down, Move::left, Move::right}) {
+        if (const auto to = next_blank(board.blank(), side, move)) {
+            ending[*to][static_cast<std::size_t>(move)] = 1;
+            paths[1] += 1;
+        }
+    }
+    for (std::size_t length = 2; length <= horizon; length++) {
+        if (paths[length - 1] >= most) {
+            std::fill(paths.begin() + static_cast<std::ptrdiff_t>(length), paths.end(), most);
+            break;
+        }
+        std::vector<std::array<double, 4>> next(side * side);
+        for (std::size_t cell = 0; cell < ending.size(); cell++) {
+            for (auto last_move : {Move::up, Move::down, Move::left, Move::right}) {
+                const double count = ending[cell][static_cast<std::size_t>(last_move)];
+                for (auto move : {Move::up, Move::down, Move::left, Move::right}) {
+                    const auto to = next_blank(cell, side, move);
+                    if (count != 0 && move != opposite(last_move) && to) {
+                        next[*to][static_cast<std::size_t>(move)] += count;
+                        paths[length] += count;
+                    }
+                }
+            }
+        }
+        ending = std::move(next);
+    }
+
+    // Korf-Reid-Edelkamp: of the paths of i moves, an iteration under bound t expands the share
+    // whose estimate is at most t - i.
+    double expanded = 0;
+    for (std::size_t bound = first; bound <= last; bound += 2) {
+        for (std::size_t length = 0; length <= horizon && length + lowest <= bound; length++) {
+            const std::size_t left = bound - length;
+            expanded += paths[length] * (left < shares.size() ? shares[left] : 1.0);
+        }
+        if (expanded >= most) {
+            return most;
+        }
+    }
+    return expanded;
 }
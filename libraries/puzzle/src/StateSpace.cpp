@@ -0,0 +1,332 @@
+#include "puzzle/StateSpace.hpp"
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <filesystem>
+#include <queue>
+#include <utility>
+
+#include "puzzle/Board.hpp"
+
+namespace {
+
+constexpr std::size_t visit_chunk = 4096;
+constexpr std::size_t io_buffer   = 1 << 16;
+
+// Collects the ranks of a level for the visitor.
+class Reporter {
+public:
+    explicit Reporter(const StateSpace::Visitor& visit) noexcept : visit(visit) {}
+
+    void add(unsigned depth, uint64_t rank) {
+        if (not visit) {
+            return;
+        }
+        ranks.push_back(rank);
+        if (ranks.size() == visit_chunk) {
+            flush(depth);
+        }
+    }
+
+    void flush(unsigned depth) {
+        if (not ranks.empty()) {
+            visit(depth, ranks);
+            ranks.clear();
+        }
+    }
+
+private:
+    const StateSpace::Visitor& visit;
+    std::vector<uint64_t> ranks;
+};
+
+// Calls `emit` with the rank of every neighbour of the board in `tiles`, which is left as it was.
+template <typename Emit>
+void for_each_neighbour(std::size_t side, std::span<uint16_t> tiles, Emit&& emit) {
+    const std::size_t blank = std::find(tiles.begin(), tiles.end(), 0) - tiles.begin();
+    const auto swapped      = [&](std::size_t cell) {
+        std::swap(tiles[blank], tiles[cell]);
+        emit(Board::rank(tiles));
+        std::swap(tiles[blank], tiles[cell]);
+    };
+    if (blank >= side) {
+        swapped(blank - side);
+    }
+    if (blank + side < tiles.size()) {
+        swapped(blank + side);
+    }
+    if (blank % side > 0) {
+        swapped(blank - 1);
+    }
+    if (blank % side + 1 < side) {
+        swapped(blank + 1);
+    }
+}
+
+std::vector<uint64_t> in_memory(unsigned size, uint64_t states, const StateSpace::Visitor& visit) {
+    // Two bits per rank: the depth modulo 3, or `unseen`. Neighbours of a level-d state are at
+    // d - 1 or d + 1, which the modulus tells apart.
+    constexpr uint64_t unseen = 3;
+    constexpr uint64_t fields = 0x5555555555555555;
+    std::vector<uint64_t> words((states + 31) / 32, ~uint64_t{0});
+    const auto mark = [&](uint64_t rank, uint64_t value) {
+        const unsigned shift = rank % 32 * 2;
+        auto& word           = words[rank / 32];
+        if ((word >> shift & 3) != unseen) {
+            return false;
+        }
+        word ^= (unseen ^ value) << shift;
+        return true;
+    };
+
+    Reporter reporter(visit);
+    const uint64_t goal = Board::create_goal(size).rank();
+    mark(goal, 0);
+    reporter.add(0, goal);
+    reporter.flush(0);
+
+    std::vector<uint64_t> counts{1};
+    std::vector<uint16_t> tiles(static_cast<std::size_t>(size) * size);
+    for (unsigned depth = 0; counts.back() > 0; depth++) {
+        const uint64_t current = fields * (depth % 3);
+        const uint64_t next    = (depth + 1) % 3;
+        uint64_t found         = 0;
+        for (std::size_t index = 0; index < words.size(); index++) {
+            // A low bit for every field that equals the current depth.
+            const uint64_t difference = words[index] ^ current;
+            uint64_t matches          = ~(difference | difference >> 1) & fields;
+            for (; matches != 0; matches &= matches - 1) {
+                Board::unrank(size, index * 32 + std::countr_zero(matches) / 2, tiles);
+                for_each_neighbour(size, tiles, [&](uint64_t rank) {
+                    if (mark(rank, next)) {
+                        reporter.add(depth + 1, rank);
+                        found++;
+                    }
+                });
+            }
+        }
+        reporter.flush(depth + 1);
+        counts.push_back(found);
+    }
+    counts.pop_back();
+    return counts;
+}
+
+class RankWriter {
+public:
+    explicit RankWriter(const std::filesystem::path& path) noexcept : file(std::fopen(path.c_str(), "wb")) {
+        buffer.reserve(io_buffer);
+    }
+    RankWriter(const RankWriter&)            = delete;
+    RankWriter& operator=(const RankWriter&) = delete;
+    ~RankWriter() {
+        close();
+    }
+
+    void write(uint64_t rank) noexcept {
+        buffer.push_back(rank);
+        if (buffer.size() == io_buffer) {
+            flush();
+        }
+    }
+
+    // Whether everything was written.
+    bool close() noexcept {
+        if (file != nullptr) {
+            flush();
+            good = std::fclose(file) == 0 && good;
+            file = nullptr;
+        }
+        return good;
+    }
+
+private:
+    void flush() noexcept {
+        good = good && std::fwrite(buffer.data(), sizeof(uint64_t), buffer.size(), file) == buffer.size();
+        buffer.clear();
+    }
+
+    std::FILE* file;
+    bool good = file != nullptr;
+    std::vector<uint64_t> buffer;
+};
+
+class RankReader {
+public:
+    // A path that cannot be opened reads as empty.
+    explicit RankReader(const std::filesystem::path& path) noexcept : file(std::fopen(path.c_str(), "rb")) {}
+    RankReader(const RankReader&)            = delete;
+    RankReader& operator=(const RankReader&) = delete;
+    RankReader(RankReader&& other) noexcept
+        : file(std::exchange(other.file, nullptr)), buffer(std::move(other.buffer)), position(other.position) {}
+    ~RankReader() {
+        if (file != nullptr) {
+            std::fclose(file);
+        }
+    }
+
+    [[nodiscard]] bool is_open() const noexcept {
+        return file != nullptr;
+    }
+
+    std::optional<uint64_t> next() noexcept {
+        if (position == buffer.size()) {
+            buffer.resize(io_buffer);
+            buffer.resize(file == nullptr ? 0 : std::fread(buffer.data(), sizeof(uint64_t), io_buffer, file));
+            position = 0;
+            if (buffer.empty()) {
+                return {};
+            }
+        }
+        return buffer[position++];
+    }
+
+private:
+    std::FILE* file;
+    std::vector<uint64_t> buffer;
+    std::size_t position = 0;
+};
+
+// Levels live in `directory` as level-<depth>; the children of one level are sorted into runs
+// run-<n> before they are merged into the next.
+std::optional<std::vector<uint64_t>> on_disk(unsigned size, std::size_t memory_bytes,
+                                             const std::filesystem::path& directory,
+                                             const StateSpace::Visitor& visit) {
+    const auto level = [&](unsigned depth) { return directory / ("level-" + std::to_string(depth)); };
+    const auto run   = [&](std::size_t index) { return directory / ("run-" + std::to_string(index)); };
+    const std::size_t run_states = std::max<std::size_t>(memory_bytes / sizeof(uint64_t), visit_chunk);
+
+    Reporter reporter(visit);
+    const uint64_t goal = Board::create_goal(size).rank();
+    RankWriter first(level(0));
+    first.write(goal);
+    if (not first.close()) {
+        return {};
+    }
+    reporter.add(0, goal);
+    reporter.flush(0);
+
+    std::vector<uint64_t> counts{1};
+    std::vector<uint16_t> tiles(static_cast<std::size_t>(size) * size);
+    std::vector<uint64_t> children;
+    for (unsigned depth = 0;; depth++) {
+        // Expand the level into sorted runs.
+        std::size_t runs = 0;
+        const auto spill = [&]() {
+            std::sort(children.begin(), children.end());
+            children.erase(std::unique(children.begin(), children.end()), children.end());
+            RankWriter writer(run(runs++));
+            for (auto rank : children) {
+                writer.write(rank);
+            }
+            children.clear();
+            return writer.close();
+        };
+        RankReader parents(level(depth));
+        if (not parents.is_open()) {
+            return {};
+        }
+        while (const auto rank = parents.next()) {
+            Board::unrank(size, *rank, tiles);
+            for_each_neighbour(size, tiles, [&](uint64_t child) { children.push_back(child); });
+            if (children.size() + 4 > run_states && not spill()) {
+                return {};
+            }
+        }
+        if (not children.empty() && not spill()) {
+            return {};
+        }
+
+        // Merge the runs, dropping duplicates and the boards of the level before.
+        std::vector<RankReader> readers;
+        using Head = std::pair<uint64_t, std::size_t>;
+        std::priority_queue<Head, std::vector<Head>, std::greater<>> heads;
+        for (std::size_t index = 0; index < runs; index++) {
+            readers.emplace_back(run(index));
+            if (const auto rank = readers.back().next()) {
+                heads.emplace(*rank, index);
+            }
+        }
+        RankReader previous(depth == 0 ? std::filesystem::path() : level(depth - 1));
+        auto seen = previous.next();
+        RankWriter writer(level(depth + 1));
+        std::optional<uint64_t> last;
+        uint64_t found = 0;
+        while (not heads.empty()) {
+            const auto [rank, index] = heads.top();
+            heads.pop();
+            if (const auto following = readers[index].next()) {
+                heads.emplace(*following, index);
+            }
+            if (rank == last) {
+                continue;
+            }
+            last = rank;
+            while (seen && *seen < rank) {
+                seen = previous.next();
+            }
+            if (seen == rank) {
+                continue;
+            }
+            writer.write(rank);
+            reporter.add(depth + 1, rank);
+            found++;
+        }
+        reporter.flush(depth + 1);
+        readers.clear();
+        if (not writer.close()) {
+            return {};
+        }
+
+        std::error_code ignored;
+        for (std::size_t index = 0; index < runs; index++) {
+            std::filesystem::remove(run(index), ignored);
+        }
+        if (depth > 0) {
+            std::filesystem::remove(level(depth - 1), ignored);
+        }
+        if (found == 0) {
+            return counts;
+        }
+        counts.push_back(found);
+    }
+}
+
+}  // anonymous namespace
+
+uint64_t StateSpace::ranks(unsigned size) noexcept {
+    uint64_t result = 1;
+    for (uint64_t i = 2; i <= static_cast<uint64_t>(size) * size; i++) {
+        result *= i;
+    }
+    return result;
+}
+
+std::optional<std::vector<uint64_t>> StateSpace::enumerate(unsigned size, const Options& options,
+                                                           const Visitor& visit) noexcept {
+    if (size < 2 || size > Board::max_ranked_size) {
+        return {};
+    }
+    const uint64_t states = ranks(size);
+    if (states / 4 <= options.memory_bytes) {
+        return in_memory(size, states, visit);
+    }
+
+    std::error_code error;
+    const auto parent = options.scratch.empty() ? std::filesystem::temp_directory_path(error)
+                                                : std::filesystem::path(options.scratch);
+    std::string directory = (parent / "puzzle-states-XXXXXX").string();
+    if (error || mkdtemp(directory.data()) == nullptr) {
+        return {};
+    }
+    auto counts = on_disk(size, options.memory_bytes, directory, visit);
+    std::filesystem::remove_all(directory, error);
+    return counts;
+}
+
+std::optional<std::vector<uint64_t>> StateSpace::enumerate(unsigned size) noexcept {
+    return enumerate(size, Options{}, {});
+}
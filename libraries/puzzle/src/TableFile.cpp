@@ -0,0 +1,157 @@
+#include "puzzle/TableFile.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+constexpr uint32_t magic             = TableFile::tag('P', 'Z', 'L', 'T');
+constexpr uint16_t format_version    = 1;
+constexpr uint16_t byte_order        = 0x0102;
+constexpr std::size_t payload_offset = 4096;
+
+struct Header {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t byte_order;
+    uint32_t kind;
+    uint32_t reserved;
+    TableFile::Parameters parameters;
+    uint64_t payload_bytes;
+    uint64_t checksum;
+};
+static_assert(sizeof(Header) == 64);
+
+uint64_t mix(uint64_t value) noexcept {
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ULL;
+    return value ^ (value >> 33);
+}
+
+// Four independent lanes over 8-byte words keep the multiplier busy; tables are hundreds of
+// megabytes at most, so this runs at memory speed.
+uint64_t checksum(std::span<const uint8_t> bytes) noexcept {
+    uint64_t lanes[4]      = {1, 2, 3, 4};
+    const std::size_t full = bytes.size() / 32 * 32;
+    for (std::size_t i = 0; i < full; i += 32) {
+        for (std::size_t lane = 0; lane < 4; lane++) {
+            uint64_t word = 0;
+            std::memcpy(&word, bytes.data() + i + lane * 8, 8);
+            lanes[lane] = (lanes[lane] ^ word) * 0x9e3779b97f4a7c15ULL;
+            lanes[lane] ^= lanes[lane] >> 29;
+        }
+    }
+    uint64_t result = bytes.size();
+    for (auto lane : lanes) {
+        result = mix(result ^ lane);
+    }
+    for (std::size_t i = full; i < bytes.size(); i++) {
+        result = mix(result ^ bytes[i]);
+    }
+    return result;
+}
+
+}  // anonymous namespace
+
+bool TableFile::write(const std::string& path, uint32_t kind, const Parameters& parameters,
+                      std::span<const uint8_t> payload) noexcept {
+    Header header{magic, format_version, byte_order, kind, 0, parameters, payload.size(), checksum(payload)};
+    uint8_t head[payload_offset] = {};
+    std::memcpy(head, &header, sizeof(header));
+
+    const std::string temporary = path + ".tmp" + std::to_string(::getpid());
+    std::FILE* file             = std::fopen(temporary.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    const bool written = std::fwrite(head, 1, sizeof(head), file) == sizeof(head) &&
+                         std::fwrite(payload.data(), 1, payload.size(), file) == payload.size();
+    MapOptions verified;
+    verified.verify = true;
+    if (std::fclose(file) != 0 || not written || not open(temporary, kind, verified) ||
+        std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+std::optional<TableFile> TableFile::open(const std::string& path, uint32_t kind, const MapOptions& options) noexcept {
+    const int descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (descriptor < 0) {
+        return {};
+    }
+    struct stat status {};
+    if (::fstat(descriptor, &status) != 0 || static_cast<std::size_t>(status.st_size) < payload_offset) {
+        ::close(descriptor);
+        return {};
+    }
+    const auto length = static_cast<std::size_t>(status.st_size);
+    const int flags   = MAP_SHARED | (options.populate ? MAP_POPULATE : 0);
+    void* mapping     = ::mmap(nullptr, length, PROT_READ, flags, descriptor, 0);
+    ::close(descriptor);
+    if (mapping == MAP_FAILED) {
+        return {};
+    }
+    if (options.huge_pages) {
+        ::madvise(mapping, length, MADV_HUGEPAGE);
+    }
+
+    TableFile table;
+    table.mapping = static_cast<const uint8_t*>(mapping);
+    table.length  = length;
+
+    Header header{};
+    std::memcpy(&header, table.mapping, sizeof(header));
+    if (header.magic != magic || header.version != format_version || header.byte_order != byte_order ||
+        header.kind != kind || header.payload_bytes != length - payload_offset) {
+        return {};
+    }
+    if (options.verify && checksum(table.payload()) != header.checksum) {
+        return {};
+    }
+    table.table_parameters = header.parameters;
+    return table;
+}
+
+std::optional<TableFile> TableFile::open(const std::string& path, uint32_t kind) noexcept {
+    return open(path, kind, MapOptions{});
+}
+
+TableFile::TableFile(TableFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+TableFile& TableFile::operator=(TableFile&& other) noexcept {
+    if (this != &other) {
+        if (mapping != nullptr) {
+            ::munmap(const_cast<uint8_t*>(mapping), length);
+        }
+        mapping          = std::exchange(other.mapping, nullptr);
+        length           = std::exchange(other.length, 0);
+        table_parameters = other.table_parameters;
+    }
+    return *this;
+}
+
+TableFile::~TableFile() {
+    if (mapping != nullptr) {
+        ::munmap(const_cast<uint8_t*>(mapping), length);
+    }
+}
+
+const TableFile::Parameters& TableFile::parameters() const noexcept {
+    return table_parameters;
+}
+
+std::span<const uint8_t> TableFile::payload() const noexcept {
+    return {mapping + payload_offset, length - payload_offset};
+}
@@ -0,0 +1,97 @@
+#include "puzzle/TextFormat.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+Board TextFormat::parse_board(std::string_view line) noexcept {
+    std::vector<uint16_t> tiles;
+    const char* cursor = line.data();
+    const char* end    = line.data() + line.size();
+    while (true) {
+        while (cursor != end && (*cursor == ' ' || *cursor == '\t' || *cursor == '\r')) {
+            cursor++;
+        }
+        if (cursor == end) {
+            break;
+        }
+        uint16_t value    = 0;
+        const auto parsed = std::from_chars(cursor, end, value);
+        if (parsed.ec != std::errc()) {
+            return {1, {}};
+        }
+        tiles.push_back(value);
+        cursor = parsed.ptr;
+    }
+
+    const auto side = static_cast<std::size_t>(std::lround(std::sqrt(static_cast<double>(tiles.size()))));
+    if (side * side != tiles.size()) {
+        return {1, {}};
+    }
+    return {side, tiles};
+}
+
+bool TextFormat::parse_engine(std::string_view name, unsigned threads, SolveOptions& options) noexcept {
+    const unsigned count        = std::max(threads, 1u);
+    options.partial_expansion   = name == "epea";
+    options.breadth_first       = name == "bfhs";
+    options.deepening_threads   = name == "ida" ? count : 0;
+    options.distributed_workers = name == "distributed" ? count : 0;
+    return name == "astar" || name == "epea" || name == "bfhs" || name == "ida" || name == "distributed";
+}
+
+std::optional<SolveOptions::Lookups> TextFormat::parse_lookups(std::string_view name) noexcept {
+    using Lookups = SolveOptions::Lookups;
+    constexpr std::pair<std::string_view, Lookups> names[] = {{"regular", Lookups::regular},
+                                                             {"reflected", Lookups::reflected},
+                                                             {"dual", Lookups::dual},
+                                                             {"both", Lookups::both},
+                                                             {"random", Lookups::random}};
+    for (const auto& [known, lookups] : names) {
+        if (name == known) {
+            return lookups;
+        }
+    }
+    return {};
+}
+
+void TextFormat::append_tiles(std::string& out, const Board& board) noexcept {
+    bool first = true;
+    for (auto tile : board.tiles()) {
+        if (not first) {
+            out += ' ';
+        }
+        first = false;
+        out += std::to_string(tile);
+    }
+    out += '\n';
+}
+
+std::string TextFormat::format_result(std::string_view label, const Board& board,
+                                      const BatchSolver::Solution& solution, Detail detail) noexcept {
+    std::string out(label);
+    out += ' ';
+    if (not board.validate()) {
+        return out + "invalid\n";
+    }
+    if (solution.begin() == solution.end()) {
+        return out + (solution.stats().budget_exhausted ? "budget\n" : "unsolvable\n");
+    }
+
+    out += std::to_string(solution.moves());
+    if (detail == Detail::moves) {
+        out += ' ';
+        for (auto move : solution.path()) {
+            out += "UDLR"[static_cast<unsigned>(move)];
+        }
+    }
+    out += '\n';
+    if (detail == Detail::boards) {
+        for (const auto& step : solution) {
+            append_tiles(out, step);
+        }
+    }
+    return out;
+}
@@ -0,0 +1,103 @@
+#include "puzzle/TranspositionTable.hpp"
+
+#include "Mix.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace {
+
+// Entry layout, low to high: 45 bits of rank (16! < 2^45), 2 bits of side - 1, 8 bits of moves
+// from the start and 8 bits of bound. A zero word is an empty slot, since side - 1 is never 0.
+constexpr unsigned size_shift      = 45;
+constexpr unsigned moves_shift     = 47;
+constexpr unsigned bound_shift     = 55;
+constexpr uint64_t key_mask        = (uint64_t{1} << moves_shift) - 1;
+constexpr unsigned max_value       = 255;
+constexpr std::size_t bucket_bytes = 64;
+
+unsigned moves_of(uint64_t word) noexcept {
+    return static_cast<unsigned>(word >> moves_shift & max_value);
+}
+
+unsigned bound_of(uint64_t word) noexcept {
+    return static_cast<unsigned>(word >> bound_shift & max_value);
+}
+
+// How much an entry is worth keeping under `bound`: nothing for an empty slot, little for an
+// entry of an earlier bound, and otherwise more the more of the bound was left.
+unsigned worth(uint64_t word, unsigned bound) noexcept {
+    if (word == 0) {
+        return 0;
+    }
+    if (bound_of(word) != bound) {
+        return 1;
+    }
+    return 2 + bound - std::min(bound, moves_of(word));
+}
+
+}  // anonymous namespace
+
+TranspositionTable::TranspositionTable(std::size_t memory_bytes) noexcept {
+    const std::size_t count = std::bit_floor(std::max<std::size_t>(memory_bytes / bucket_bytes, 1));
+    bucket_mask             = count - 1;
+    buckets                 = std::make_unique<Bucket[]>(count);
+}
+
+bool TranspositionTable::supports(const Board& board) noexcept {
+    return board.size() >= 2 && board.size() <= Board::max_ranked_size;
+}
+
+bool TranspositionTable::visit(const Board& board, unsigned moves, unsigned bound, bool equal_again) noexcept {
+    if (not supports(board) || bound > max_value) {
+        return true;
+    }
+    const uint64_t key  = board.rank() | static_cast<uint64_t>(board.size() - 1) << size_shift;
+    const uint64_t word =
+        key | static_cast<uint64_t>(moves) << moves_shift | static_cast<uint64_t>(bound) << bound_shift;
+    auto& slots = buckets[mix(key) & bucket_mask].slots;
+
+    for (auto& slot : slots) {
+        uint64_t seen = slot.load(std::memory_order_relaxed);
+        while ((seen & key_mask) == key) {
+            if (bound_of(seen) == bound && moves_of(seen) + (equal_again ? 1 : 0) <= moves) {
+                return false;
+            }
+            if (slot.compare_exchange_weak(seen, word, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+
+    // The board is new: it replaces the entry least worth keeping, unless that one is worth more.
+    // Losing a race only leaves the board unrecorded, which costs another search of it later.
+    std::atomic<uint64_t>* victim = nullptr;
+    uint64_t victim_word          = 0;
+    for (auto& slot : slots) {
+        const uint64_t seen = slot.load(std::memory_order_relaxed);
+        if (victim == nullptr || worth(seen, bound) < worth(victim_word, bound)) {
+            victim      = &slot;
+            victim_word = seen;
+        }
+    }
+    if (worth(victim_word, bound) <= worth(word, bound)) {
+        victim->compare_exchange_strong(victim_word, word, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+void TranspositionTable::clear() noexcept {
+    for (std::size_t index = 0; index <= bucket_mask; index++) {
+        for (auto& slot : buckets[index].slots) {
+            slot.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+std::size_t TranspositionTable::capacity() const noexcept {
+    return (bucket_mask + 1) * bucket_slots;
+}
+
+std::size_t TranspositionTable::memory() const noexcept {
+    return (bucket_mask + 1) * sizeof(Bucket);
+}
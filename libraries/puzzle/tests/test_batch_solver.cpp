@@ -0,0 +1,182 @@
+#include <cmath>
+#include <set>
+
+#include "gtest/gtest.h"
+#include "puzzle/BatchSolver.hpp"
+#include "puzzle/Generator.hpp"
+
+namespace {
+
+std::vector<Board> make_boards(std::size_t count) {
+    Generator generator(21);
+    std::vector<Board> boards;
+    for (std::size_t i = 0; i < count; ++i) {
+        boards.push_back(*generator.at_least(3, 4 + i % 10));
+    }
+    return boards;
+}
+
+}  // anonymous namespace
+
+TEST(BatchSolverTest, input_order) {
+    const auto boards = make_boards(50);
+    BatchSolver::Options options;
+    options.threads = 4;
+    options.window  = 3;
+
+    std::size_t next = 0;
+    std::vector<std::size_t> indices;
+    BatchSolver::run(
+        [&]() -> std::optional<Board> {
+            if (next == boards.size()) {
+                return {};
+            }
+            return boards[next++];
+        },
+        [&](std::size_t index, const Board& board, const BatchSolver::Solution& solution) {
+            EXPECT_EQ(boards[index], board);
+            EXPECT_EQ(Solver::solve(board).moves(), solution.moves());
+            indices.push_back(index);
+        },
+        options);
+
+    ASSERT_EQ(boards.size(), indices.size());
+    for (std::size_t i = 0; i < indices.size(); ++i) {
+        EXPECT_EQ(i, indices[i]);
+    }
+}
+
+TEST(BatchSolverTest, completion_order) {
+    const auto boards = make_boards(40);
+    BatchSolver::Options options;
+    options.threads = 3;
+    options.order   = BatchSolver::Order::completion;
+
+    std::size_t next = 0;
+    std::set<std::size_t> indices;
+    BatchSolver::run(
+        [&]() -> std::optional<Board> {
+            if (next == boards.size()) {
+                return {};
+            }
+            return boards[next++];
+        },
+        [&](std::size_t index, const Board& board, const BatchSolver::Solution&) {
+            EXPECT_EQ(boards[index], board);
+            EXPECT_TRUE(indices.insert(index).second);
+        },
+        options);
+    EXPECT_EQ(boards.size(), indices.size());
+}
+
+TEST(BatchSolverTest, solve) {
+    auto boards = make_boards(20);
+    boards.push_back(Board(std::vector<std::vector<unsigned>>{{1, 2}, {2, 0}}));
+    boards.push_back(Board(std::vector<std::vector<unsigned>>{{2, 1}, {3, 0}}));
+
+    BatchSolver::Options options;
+    options.threads      = 2;
+    const auto solutions = BatchSolver::solve(boards, options);
+    ASSERT_EQ(boards.size(), solutions.size());
+    for (std::size_t i = 0; i + 2 < boards.size(); ++i) {
+        EXPECT_EQ(boards[i], *solutions[i].begin());
+        EXPECT_TRUE(std::prev(solutions[i].end())->is_goal());
+    }
+    EXPECT_EQ(solutions[20].begin(), solutions[20].end());
+    EXPECT_EQ(solutions[21].begin(), solutions[21].end());
+    EXPECT_FALSE(solutions[21].stats().budget_exhausted);
+}
+
+TEST(BatchSolverTest, budget) {
+    const auto board = *Generator(22).exact(3, 20);
+    SolveOptions options;
+    options.node_budget = 10;
+    const auto limited  = Solver::solve(board, options);
+    EXPECT_EQ(limited.begin(), limited.end());
+    EXPECT_TRUE(limited.stats().budget_exhausted);
+    EXPECT_EQ(10, limited.stats().expanded);
+
+    const auto solution = Solver::solve(board, SolveOptions{});
+    EXPECT_EQ(20, solution.moves());
+    EXPECT_FALSE(solution.stats().budget_exhausted);
+    EXPECT_GT(solution.stats().expanded, 10);
+    EXPECT_GE(solution.stats().generated, solution.stats().expanded);
+}
+
+TEST(BatchSolverTest, estimate) {
+    EXPECT_EQ(0.0, Solver::estimate(Board::create_goal(4)));
+    EXPECT_EQ(0.0, Solver::estimate(Board(std::vector<std::vector<unsigned>>{{2, 1}, {3, 0}})));
+
+    // Boards farther from the goal are predicted to take longer.
+    Generator generator(47);
+    for (int i = 0; i < 10; ++i) {
+        const auto easy = generator.walk(4, 10);
+        const auto hard = *generator.at_least(4, 40);
+        EXPECT_LT(Solver::estimate(easy), Solver::estimate(hard)) << easy << hard;
+    }
+
+    // Large boards count far more paths than a double holds; the estimate stays finite and only
+    // refuses those a search cannot manage.
+    for (unsigned side : {10u, 12u, 20u}) {
+        const auto random = generator.solvable(side);
+        const auto near   = generator.walk(side, 20);
+        EXPECT_TRUE(std::isfinite(Solver::estimate(random))) << random;
+        EXPECT_TRUE(std::isfinite(Solver::estimate(near))) << near;
+        EXPECT_LT(Solver::estimate(near), Solver::estimate(random));
+    }
+    BatchSolver::Options options;
+    options.threads           = 1;
+    options.over_budget       = BatchSolver::OverBudget::refuse;
+    options.solve.node_budget = 100'000;
+    const std::vector<Board> large{generator.walk(12, 20), generator.solvable(12)};
+    const auto solved = BatchSolver::solve(large, options);
+    EXPECT_FALSE(solved[0].stats().budget_exhausted);
+    EXPECT_TRUE(std::prev(solved[0].end())->is_goal());
+    EXPECT_TRUE(solved[1].stats().budget_exhausted);
+    EXPECT_EQ(0u, solved[1].stats().expanded);
+}
+
+TEST(BatchSolverTest, over_budget) {
+    Generator generator(48);
+    std::vector<Board> boards;
+    for (int i = 0; i < 6; ++i) {
+        boards.push_back(generator.walk(4, 8));
+        boards.push_back(*generator.at_least(4, 44));
+    }
+    BatchSolver::Options options;
+    options.threads           = 2;
+    options.longest_first     = true;
+    options.solve.node_budget = 20'000;
+    const auto solved         = BatchSolver::solve(boards, options);
+
+    // Boards predicted over budget are not searched at all, or solved without a search.
+    options.over_budget  = BatchSolver::OverBudget::refuse;
+    const auto refused   = BatchSolver::solve(boards, options);
+    options.over_budget  = BatchSolver::OverBudget::approximate;
+    const auto estimated = BatchSolver::solve(boards, options);
+    for (std::size_t i = 0; i < boards.size(); ++i) {
+        const bool over = Solver::estimate(boards[i]) > options.solve.node_budget;
+        EXPECT_EQ(i % 2 == 1, over) << boards[i];
+        if (not over) {
+            EXPECT_EQ(solved[i].moves(), refused[i].moves());
+            EXPECT_EQ(solved[i].moves(), estimated[i].moves());
+            continue;
+        }
+        EXPECT_TRUE(refused[i].stats().budget_exhausted);
+        EXPECT_EQ(0u, refused[i].stats().expanded);
+        EXPECT_EQ(refused[i].begin(), refused[i].end());
+        EXPECT_EQ(boards[i], *estimated[i].begin());
+        EXPECT_TRUE(std::prev(estimated[i].end())->is_goal());
+    }
+
+    // Longest first hands the boards out in another order but keeps the results in place.
+    options.over_budget       = BatchSolver::OverBudget::attempt;
+    options.solve.node_budget = 0;
+    options.threads           = 1;
+    const auto easy           = make_boards(12);
+    const auto reordered      = BatchSolver::solve(easy, options);
+    for (std::size_t i = 0; i < easy.size(); ++i) {
+        EXPECT_EQ(easy[i], *reordered[i].begin());
+        EXPECT_EQ(Solver::solve(easy[i]).moves(), reordered[i].moves());
+    }
+}
@@ -1040,6 +1040,20 @@ unsigned calc_hamming(const Board &b) {
     return hamming;
 }
 
+unsigned calc_manhattan(const Board &b) {
+    unsigned manhattan = 0;
+    const unsigned n   = b.size();
+    for (unsigned x = 0; x < n; ++x) {
+        for (unsigned y = 0; y < n; ++y) {
+            if (b[x][y] != 0) {
+                const unsigned gx = (b[x][y] - 1) / n, gy = (b[x][y] - 1) % n;
+                manhattan += (gx > x ? gx - x : x - gx) + (gy > y ? gy - y : y - gy);
+            }
+        }
+    }
+    return manhattan;
+}
+
 }  // anonymous namespace
 
 TEST(BoardTest, empty) {
@@ -1274,3 +1288,121 @@ TEST(BoardTest, parallel_access) {
         EXPECT_EQ(res.is_goal, res.manhattan == 0);
     }
 }
+
+TEST(BoardTest, manhattan_batch) {
+    for (unsigned n = 0; n < 23; ++n) {
+        std::vector<Board> boards;
+        for (unsigned k = 0; k < 11; ++k) {
+            boards.push_back(Board::create_random(n));
+        }
+        std::vector<unsigned> expected;
+        for (const auto &b : boards) {
+            expected.push_back(calc_manhattan(b));
+            EXPECT_EQ(expected.back(), b.manhattan()) << " for " << n;
+        }
+        std::vector<unsigned> actual(boards.size(), 0);
+        Board::manhattan(boards, actual);
+        EXPECT_EQ(expected, actual) << " for " << n;
+    }
+}
+
+TEST(BoardTest, validate) {
+    EXPECT_TRUE(Board().validate());
+    EXPECT_TRUE(Board::create_goal(4).validate());
+    EXPECT_TRUE(make_board(threes[0]).validate());
+
+    const std::vector<Board> invalid = {
+        Board(std::vector<std::vector<unsigned>>{{1, 2}, {2, 0}}),
+        Board(std::vector<std::vector<unsigned>>{{1, 2}, {4, 0}}),
+        Board(std::vector<std::vector<unsigned>>{{1, 2, 3}, {4, 5, 6}, {7, 8}}),
+        Board(std::vector<std::vector<unsigned>>{{1, 2, 3}, {4, 5, 6}, {7, 8, 9}}),
+        Board(std::vector<std::vector<unsigned>>{{7}}),
+    };
+    for (const auto &b : invalid) {
+        EXPECT_FALSE(b.validate()) << b;
+        if (b.size() > 1) {
+            EXPECT_FALSE(b.is_solvable()) << b;
+        }
+    }
+    for (auto valid : Board::validate(invalid)) {
+        EXPECT_FALSE(valid);
+    }
+
+    // Tiles past the board count nothing towards the distance, on every kernel.
+    for (unsigned n : {2u, 3u, 4u, 5u, 9u}) {
+        const auto goal = Board::create_goal(n);
+        std::vector<uint16_t> tiles(goal.tiles().begin(), goal.tiles().end());
+        tiles.front() = 60000;
+        tiles[n]      = static_cast<uint16_t>(n * n);
+        const std::vector<Board> outside(2, Board(n, tiles));
+        EXPECT_FALSE(outside[0].validate());
+        EXPECT_EQ(0u, outside[0].manhattan()) << n;
+        std::vector<unsigned> batch(outside.size(), 1);
+        Board::manhattan(outside, batch);
+        EXPECT_EQ(std::vector<unsigned>(outside.size(), 0), batch) << n;
+    }
+}
+
+TEST(BoardTest, solvable_batch) {
+    std::vector<Board> boards;
+    std::vector<bool> expected;
+    for (const auto &c : fours) {
+        boards.push_back(make_board(c));
+        expected.push_back(c.solvable);
+    }
+    for (const auto &c : tens) {
+        boards.push_back(make_board(c));
+        expected.push_back(c.solvable);
+    }
+    EXPECT_EQ(expected, Board::is_solvable(boards));
+    EXPECT_EQ(std::vector<bool>(boards.size(), true), Board::validate(boards));
+}
+
+TEST(BoardTest, moves) {
+    const auto goal = Board::create_goal(3);
+    EXPECT_FALSE(goal.moved(Move::down).has_value());
+    EXPECT_FALSE(goal.moved(Move::right).has_value());
+    const auto up = goal.moved(Move::up);
+    ASSERT_TRUE(up.has_value());
+    EXPECT_EQ(5, up->blank());
+    EXPECT_EQ(6, (*up)[2][2]);
+    EXPECT_EQ(Move::up, goal.move_to(*up));
+    EXPECT_EQ(Move::down, up->move_to(goal));
+    EXPECT_EQ(goal, up->moved(opposite(Move::up)));
+    EXPECT_FALSE(goal.move_to(goal).has_value());
+}
+
+TEST(BoardTest, rank) {
+    for (unsigned n = 0; n <= Board::max_ranked_size; ++n) {
+        for (int k = 0; k < 50; ++k) {
+            const auto b = Board::create_random(n);
+            EXPECT_EQ(b, Board::unrank(n, b.rank()));
+        }
+    }
+    EXPECT_EQ(0, make_board(twos[0]).rank());
+    EXPECT_EQ(23, make_board(twos[23]).rank());
+    EXPECT_EQ(20922789887999ULL, Board(std::vector<std::vector<unsigned>>{
+                                           {15, 14, 13, 12}, {11, 10, 9, 8}, {7, 6, 5, 4}, {3, 2, 1, 0}})
+                                     .rank());
+}
+
+TEST(BoardTest, transposed) {
+    for (unsigned n = 0; n < 8; ++n) {
+        EXPECT_EQ(Board::create_goal(std::max(n, 1u)), Board::create_goal(std::max(n, 1u)).transposed());
+        for (int k = 0; k < 20; ++k) {
+            const auto b = Board::create_random(n);
+            const auto t = b.transposed();
+            EXPECT_EQ(b, t.transposed());
+            EXPECT_TRUE(t.validate());
+            EXPECT_EQ(b.manhattan(), t.manhattan());
+            EXPECT_EQ(b.is_solvable(), t.is_solvable());
+            for (auto move : {Move::up, Move::down, Move::left, Move::right}) {
+                const auto next = b.moved(move);
+                ASSERT_EQ(next.has_value(), t.moved(transposed(move)).has_value());
+                if (next) {
+                    EXPECT_EQ(next->transposed(), t.moved(transposed(move)));
+                }
+            }
+        }
+    }
+}
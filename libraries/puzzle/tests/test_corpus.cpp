@@ -0,0 +1,242 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#include "gtest/gtest.h"
+#include "puzzle/BatchSolver.hpp"
+#include "puzzle/Corpus.hpp"
+#include "puzzle/Generator.hpp"
+
+namespace {
+
+std::string temporary_path(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / ("puzzle_" + name)).string();
+}
+
+}  // anonymous namespace
+
+TEST(CorpusTest, boards) {
+    for (unsigned side : {2u, 3u, 4u, 5u, 7u}) {
+        const auto path = temporary_path("boards_" + std::to_string(side));
+        Generator generator(side);
+        std::vector<Board> boards;
+        for (int i = 0; i < 20; ++i) {
+            boards.push_back(generator.walk(side, 30));
+        }
+        {
+            auto writer = CorpusWriter::open(path, side, false);
+            ASSERT_TRUE(writer.has_value());
+            for (const auto& board : boards) {
+                EXPECT_TRUE(writer->write(board));
+            }
+            EXPECT_FALSE(writer->write(Board::create_goal(side + 1)));
+        }
+
+        ASSERT_TRUE(CorpusReader::is_corpus(path));
+        auto reader = CorpusReader::open(path);
+        ASSERT_TRUE(reader.has_value());
+        EXPECT_EQ(side, reader->side());
+        EXPECT_FALSE(reader->has_solutions());
+        ASSERT_EQ(boards.size(), reader->size());
+        EXPECT_EQ(boards[7], reader->board(7));
+
+        CorpusRecord record;
+        for (const auto& board : boards) {
+            ASSERT_TRUE(reader->next(record));
+            EXPECT_EQ(board, record.board);
+        }
+        EXPECT_FALSE(reader->next(record));
+        reader->rewind();
+        ASSERT_TRUE(reader->next(record));
+        EXPECT_EQ(boards[0], record.board);
+        std::remove(path.c_str());
+    }
+}
+
+TEST(CorpusTest, rank_size) {
+    const auto path = temporary_path("rank_size");
+    {
+        auto writer = CorpusWriter::open(path, 4, false);
+        ASSERT_TRUE(writer.has_value());
+        for (int i = 0; i < 10; ++i) {
+            writer->write(Board::create_goal(4));
+        }
+    }
+    // A 32-byte header and 6 bytes per 4x4 board.
+    EXPECT_EQ(32u + 10 * 6, std::filesystem::file_size(path));
+    std::remove(path.c_str());
+}
+
+TEST(CorpusTest, solutions) {
+    const auto path = temporary_path("solutions");
+    Generator generator(5);
+    std::vector<CorpusRecord> records(3);
+    records[0].board = *generator.exact(3, 9);
+    records[0].moves = Solver::solve(records[0].board).path();
+    records[1].board  = Board(std::vector<std::vector<unsigned>>{{2, 1, 3}, {4, 5, 6}, {7, 8, 0}});
+    records[1].status = CorpusRecord::Status::unsolvable;
+    records[2].board  = Board::create_goal(3);
+    records[2].status = CorpusRecord::Status::budget;
+    {
+        auto writer = CorpusWriter::open(path, 3, true);
+        ASSERT_TRUE(writer.has_value());
+        EXPECT_FALSE(writer->write(records[0].board));
+        for (const auto& record : records) {
+            EXPECT_TRUE(writer->write(record));
+        }
+    }
+
+    auto reader = CorpusReader::open(path);
+    ASSERT_TRUE(reader.has_value());
+    EXPECT_TRUE(reader->has_solutions());
+    CorpusRecord read;
+    for (const auto& record : records) {
+        ASSERT_TRUE(reader->next(read));
+        EXPECT_EQ(record.board, read.board);
+        EXPECT_EQ(record.status, read.status);
+        EXPECT_EQ(record.moves, read.moves);
+    }
+    EXPECT_FALSE(reader->next(read));
+    std::remove(path.c_str());
+}
+
+TEST(CorpusTest, append) {
+    const auto path = temporary_path("append");
+    {
+        auto writer = CorpusWriter::open(path, 3, false);
+        ASSERT_TRUE(writer.has_value());
+        writer->write(Board::create_goal(3));
+    }
+    EXPECT_FALSE(CorpusWriter::open(path, 4, false, true).has_value());
+    EXPECT_FALSE(CorpusWriter::open(path, 3, true, true).has_value());
+    {
+        auto writer = CorpusWriter::open(path, 3, false, true);
+        ASSERT_TRUE(writer.has_value());
+        writer->write(Board::create_goal(3));
+    }
+    auto reader = CorpusReader::open(path);
+    ASSERT_TRUE(reader.has_value());
+    EXPECT_EQ(2u, reader->size());
+    std::remove(path.c_str());
+}
+
+TEST(CorpusTest, rejects) {
+    const auto path = temporary_path("rejects");
+    std::ofstream(path) << "1 2 3 4 5 6 7 8 0\n";
+    EXPECT_FALSE(CorpusReader::is_corpus(path));
+    EXPECT_FALSE(CorpusReader::open(path).has_value());
+    EXPECT_FALSE(CorpusReader::open(temporary_path("missing")).has_value());
+    std::remove(path.c_str());
+}
+
+TEST(CorpusTest, batch) {
+    const auto input_path  = temporary_path("batch_input");
+    const auto output_path = temporary_path("batch_output");
+    Generator generator(8);
+    std::vector<Board> boards;
+    for (int i = 0; i < 30; ++i) {
+        boards.push_back(*generator.at_least(3, 5 + i % 8));
+    }
+    {
+        auto writer = CorpusWriter::open(input_path, 3, false);
+        ASSERT_TRUE(writer.has_value());
+        for (const auto& board : boards) {
+            writer->write(board);
+        }
+    }
+
+    auto reader = CorpusReader::open(input_path);
+    auto writer = CorpusWriter::open(output_path, 3, true);
+    ASSERT_TRUE(reader.has_value() && writer.has_value());
+    BatchSolver::Options options;
+    options.threads = 4;
+    EXPECT_EQ(boards.size(), BatchSolver::solve(*reader, *writer, options));
+    writer.reset();
+
+    auto solved = CorpusReader::open(output_path);
+    ASSERT_TRUE(solved.has_value());
+    CorpusRecord record;
+    for (const auto& board : boards) {
+        ASSERT_TRUE(solved->next(record));
+        EXPECT_EQ(board, record.board);
+        EXPECT_EQ(Solver::solve(board).moves(), record.moves.size());
+    }
+    std::remove(input_path.c_str());
+    std::remove(output_path.c_str());
+}
+
+TEST(CorpusTest, chunks) {
+    for (bool with_solutions : {false, true}) {
+        const auto path = temporary_path("chunks");
+        Generator generator(13);
+        std::vector<CorpusRecord> records(1000);
+        {
+            auto writer = CorpusWriter::open(path, 4, with_solutions);
+            ASSERT_TRUE(writer.has_value());
+            for (std::size_t i = 0; i < records.size(); ++i) {
+                records[i].board = generator.walk(4, 20);
+                if (with_solutions) {
+                    records[i].moves.assign(i % 11, static_cast<Move>(i % 4));
+                }
+                ASSERT_TRUE(writer->write(records[i]));
+            }
+        }
+
+        auto reader = CorpusReader::open(path);
+        ASSERT_TRUE(reader.has_value());
+        std::vector<CorpusChunk> chunks;
+        std::size_t total = 0;
+        while (auto chunk = reader->next_chunk(64)) {
+            EXPECT_EQ(total, chunk->first());
+            total += chunk->size();
+            chunks.push_back(*chunk);
+        }
+        ASSERT_EQ(records.size(), total);
+        EXPECT_EQ(64u, chunks.front().size());
+
+        // Chunks decode independently, in any order.
+        for (auto it = chunks.rbegin(); it != chunks.rend(); ++it) {
+            CorpusRecord record;
+            for (std::size_t i = it->first(); it->next(record); ++i) {
+                EXPECT_EQ(records[i].board, record.board);
+                EXPECT_EQ(records[i].moves, record.moves);
+            }
+        }
+        std::remove(path.c_str());
+    }
+}
+
+TEST(CorpusTest, batch_chunks) {
+    const auto path = temporary_path("batch_chunks");
+    Generator generator(17);
+    std::vector<Board> boards;
+    {
+        auto writer = CorpusWriter::open(path, 3, false);
+        ASSERT_TRUE(writer.has_value());
+        for (int i = 0; i < 100; ++i) {
+            boards.push_back(*generator.at_least(3, 4 + i % 6));
+            writer->write(boards.back());
+        }
+    }
+
+    auto reader = CorpusReader::open(path);
+    ASSERT_TRUE(reader.has_value());
+    BatchSolver::Options options;
+    options.threads = 4;
+    options.chunk   = 7;
+    options.window  = 10;
+    std::vector<std::size_t> indices;
+    BatchSolver::run(
+        *reader,
+        [&](std::size_t index, const Board& board, const BatchSolver::Solution& solution) {
+            EXPECT_EQ(boards[index], board);
+            EXPECT_EQ(Solver::solve(board).moves(), solution.moves());
+            indices.push_back(index);
+        },
+        options);
+    ASSERT_EQ(boards.size(), indices.size());
+    for (std::size_t i = 0; i < indices.size(); ++i) {
+        EXPECT_EQ(i, indices[i]);
+    }
+    std::remove(path.c_str());
+}
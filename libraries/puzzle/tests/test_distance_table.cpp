@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#include "gtest/gtest.h"
+#include "puzzle/DistanceTable.hpp"
+#include "puzzle/Generator.hpp"
+#include "puzzle/Solver.hpp"
+
+namespace {
+
+std::string temporary_path(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / ("puzzle_" + name)).string();
+}
+
+}  // anonymous namespace
+
+TEST(DistanceTableTest, build) {
+    EXPECT_FALSE(DistanceTable::build(1).has_value());
+    EXPECT_FALSE(DistanceTable::build(4).has_value());
+
+    const auto table = DistanceTable::build(3);
+    ASSERT_TRUE(table.has_value());
+    EXPECT_EQ(0u, table->distance(Board::create_goal(3)));
+    EXPECT_EQ(31u, table->distance(Board(std::vector<std::vector<unsigned>>{{8, 6, 7}, {2, 5, 4}, {3, 0, 1}})));
+    EXPECT_FALSE(table->distance(Board(std::vector<std::vector<unsigned>>{{2, 1, 3}, {4, 5, 6}, {7, 8, 0}})));
+    EXPECT_FALSE(table->distance(Board::create_goal(2)));
+
+    Generator generator(4);
+    for (int i = 0; i < 30; ++i) {
+        const auto board = generator.solvable(3);
+        const auto path  = table->path(board);
+        ASSERT_FALSE(path.empty());
+        EXPECT_EQ(Solver::solve(board).moves(), path.size() - 1);
+        EXPECT_EQ(table->distance(board), path.size() - 1);
+        EXPECT_EQ(board, path.front());
+        EXPECT_TRUE(path.back().is_goal());
+        for (std::size_t j = 1; j < path.size(); ++j) {
+            EXPECT_TRUE(path[j - 1].move_to(path[j]).has_value());
+        }
+    }
+}
+
+TEST(DistanceTableTest, solver) {
+    const auto table = DistanceTable::build(3);
+    ASSERT_TRUE(table.has_value());
+    SolveOptions options;
+    options.distances = &*table;
+
+    Generator generator(6);
+    for (int i = 0; i < 20; ++i) {
+        const auto board = generator.solvable(3);
+        EXPECT_EQ(Solver::solve(board).moves(), Solver::solve(board, options).moves());
+    }
+    const auto larger = *generator.at_least(4, 6);
+    EXPECT_EQ(Solver::solve(larger).moves(), Solver::solve(larger, options).moves());
+}
+
+TEST(DistanceTableTest, file) {
+    const auto path  = temporary_path("distances");
+    const auto built = DistanceTable::build(2);
+    ASSERT_TRUE(built.has_value());
+    ASSERT_TRUE(built->save(path));
+
+    const auto loaded = DistanceTable::load(path);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(2u, loaded->size());
+    Generator generator(2);
+    for (int i = 0; i < 10; ++i) {
+        const auto board = generator.solvable(2);
+        EXPECT_EQ(built->distance(board), loaded->distance(board));
+    }
+
+    // A table is only found under its own kind.
+    EXPECT_FALSE(TableFile::open(path, TableFile::tag('X', 'X', 'X', 'X')).has_value());
+    EXPECT_TRUE(TableFile::open(path, DistanceTable::kind).has_value());
+
+    // Damage one byte of the payload.
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(4096 + 3);
+        file.put('\x7f');
+    }
+    // Only a load that asks for the checksum reads every page and notices.
+    TableFile::MapOptions checked;
+    checked.verify = true;
+    EXPECT_FALSE(DistanceTable::load(path, checked).has_value());
+    EXPECT_TRUE(DistanceTable::load(path).has_value());
+    TableFile::MapOptions unchecked;
+    unchecked.populate = true;
+    EXPECT_TRUE(DistanceTable::load(path, unchecked).has_value());
+
+    // Truncated files never map.
+    std::filesystem::resize_file(path, 4096 + 5);
+    EXPECT_FALSE(DistanceTable::load(path, unchecked).has_value());
+    std::remove(path.c_str());
+}
+
+TEST(DistanceTableTest, load_or_build) {
+    const auto path = temporary_path("distances_cached");
+    std::remove(path.c_str());
+    const auto first = DistanceTable::load_or_build(path, 3);
+    ASSERT_TRUE(first.has_value());
+    ASSERT_TRUE(std::filesystem::exists(path));
+    EXPECT_EQ(4096u + 362880u, std::filesystem::file_size(path));
+
+    const auto second = DistanceTable::load_or_build(path, 3);
+    ASSERT_TRUE(second.has_value());
+    const auto board = Board(std::vector<std::vector<unsigned>>{{4, 1, 3}, {7, 2, 6}, {0, 5, 8}});
+    EXPECT_EQ(first->distance(board), second->distance(board));
+    std::remove(path.c_str());
+}
@@ -0,0 +1,77 @@
+#include <unistd.h>
+
+#include <filesystem>
+#include <future>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "puzzle/Generator.hpp"
+#include "puzzle/Solver.hpp"
+
+TEST(DistributedTest, solve) {
+    Generator generator(49);
+    for (unsigned workers : {1u, 3u}) {
+        for (bool unix_sockets : {false, true}) {
+            SolveOptions options;
+            options.distributed_workers = workers;
+            options.distributed_batch   = 16;
+            if (unix_sockets) {
+                options.distributed_socket_dir = std::filesystem::temp_directory_path().string();
+            }
+            for (int i = 0; i < 4; ++i) {
+                const auto board    = *generator.at_least(i < 2 ? 3 : 4, 20);
+                const auto solution = Solver::solve(board, options);
+                ASSERT_EQ(Solver::solve(board).moves(), solution.moves()) << board;
+                EXPECT_EQ(board, *solution.begin());
+                EXPECT_TRUE((solution.end() - 1)->is_goal());
+                EXPECT_EQ(solution.moves(), solution.path().size());
+                EXPECT_GT(solution.stats().expanded, 0u);
+            }
+        }
+    }
+
+    // Sockets of the search are gone with it.
+    for (const auto& entry : std::filesystem::directory_iterator(std::filesystem::temp_directory_path())) {
+        EXPECT_FALSE(entry.path().filename().string().starts_with("puzzle-" + std::to_string(::getpid())));
+    }
+
+    SolveOptions options;
+    options.distributed_workers = 2;
+    options.linear_conflict     = true;
+    const auto five             = generator.walk(5, 30);
+    EXPECT_EQ(Solver::solve(five).moves(), Solver::solve(five, options).moves());
+    const auto solved = Solver::solve(Board::create_goal(4), options);
+    EXPECT_EQ(0u, solved.moves());
+    EXPECT_EQ(1, solved.end() - solved.begin());
+}
+
+TEST(DistributedTest, budget) {
+    Generator generator(50);
+    SolveOptions options;
+    options.distributed_workers = 2;
+    options.node_budget         = 1000;
+    const auto hard             = *generator.at_least(4, 40);
+    const auto stopped          = Solver::solve(hard, options);
+    EXPECT_TRUE(stopped.stats().budget_exhausted);
+    EXPECT_GE(stopped.stats().expanded, 1000u);
+    EXPECT_EQ(stopped.begin(), stopped.end());
+}
+
+TEST(DistributedTest, threaded_caller) {
+    // A process running other threads cannot fork safely; the search runs in it instead.
+    std::promise<void> finished;
+    std::thread idle([waiting = finished.get_future()]() { waiting.wait(); });
+    Generator generator(51);
+    SolveOptions options;
+    options.distributed_workers = 3;
+    for (int i = 0; i < 3; ++i) {
+        const auto board    = *generator.at_least(4, 20);
+        const auto solution = Solver::solve(board, options);
+        ASSERT_EQ(Solver::solve(board).moves(), solution.moves()) << board;
+        EXPECT_EQ(board, *solution.begin());
+        EXPECT_TRUE((solution.end() - 1)->is_goal());
+        EXPECT_GT(solution.stats().expanded, 0u);
+    }
+    finished.set_value();
+    idle.join();
+}
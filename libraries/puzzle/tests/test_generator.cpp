@@ -0,0 +1,106 @@
+#include <map>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "puzzle/Generator.hpp"
+#include "puzzle/Solver.hpp"
+
+TEST(GeneratorTest, reproducible) {
+    Generator first(42), second(42), other(43);
+    bool differs = false;
+    for (unsigned n = 0; n < 12; ++n) {
+        const auto board = first.solvable(n);
+        EXPECT_EQ(board, second.solvable(n));
+        differs = differs || board != other.solvable(n);
+        EXPECT_EQ(first.walk(n, 50), second.walk(n, 50));
+    }
+    EXPECT_TRUE(differs);
+
+    first.seed(7);
+    const auto board = first.solvable(5);
+    first.seed(7);
+    EXPECT_EQ(board, first.solvable(5));
+}
+
+TEST(GeneratorTest, solvable) {
+    Generator generator(1);
+    for (unsigned n = 0; n < 30; ++n) {
+        for (int k = 0; k < 20; ++k) {
+            const auto board = generator.solvable(n);
+            EXPECT_EQ(n, board.size());
+            EXPECT_TRUE(board.validate()) << board;
+            EXPECT_TRUE(board.is_solvable()) << board;
+        }
+    }
+}
+
+TEST(GeneratorTest, uniform) {
+    // All 12 solvable 2x2 boards should show up about equally often.
+    Generator generator(2);
+    std::map<std::string, unsigned> counts;
+    const unsigned total = 12'000;
+    for (unsigned i = 0; i < total; ++i) {
+        counts[generator.solvable(2).to_string()]++;
+    }
+    EXPECT_EQ(12, counts.size());
+    for (const auto& [board, count] : counts) {
+        EXPECT_NEAR(total / 12, count, total / 60) << board;
+    }
+}
+
+TEST(GeneratorTest, walk) {
+    Generator generator(3);
+    EXPECT_TRUE(generator.walk(4, 0).is_goal());
+    for (unsigned n = 2; n < 12; ++n) {
+        const auto board = generator.walk(n, 100);
+        EXPECT_TRUE(board.validate());
+        EXPECT_TRUE(board.is_solvable());
+        EXPECT_LE(board.manhattan(), 100);
+    }
+}
+
+TEST(GeneratorTest, at_least) {
+    Generator generator(4);
+    for (unsigned depth : {0u, 5u, 20u, 40u}) {
+        const auto board = generator.at_least(4, depth);
+        ASSERT_TRUE(board.has_value());
+        EXPECT_GE(board->manhattan(), depth);
+        EXPECT_TRUE(board->is_solvable());
+    }
+    EXPECT_FALSE(generator.at_least(2, 100).has_value());
+}
+
+TEST(GeneratorTest, exact) {
+    Generator generator(5);
+    for (unsigned depth : {0u, 1u, 7u, 14u}) {
+        const auto board = generator.exact(3, depth);
+        ASSERT_TRUE(board.has_value()) << depth;
+        EXPECT_EQ(depth, Solver::solve(*board).moves());
+    }
+}
+
+TEST(GeneratorTest, fill) {
+    std::vector<Board> boards(100, Board::create_goal(3));
+    Generator(6).fill(4, boards);
+    std::vector<uint16_t> tiles(100 * 16);
+    Generator(6).fill(4, tiles);
+    for (std::size_t i = 0; i < boards.size(); ++i) {
+        EXPECT_EQ(4, boards[i].size());
+        EXPECT_TRUE(boards[i].is_solvable());
+        EXPECT_EQ(boards[i], Board(4, std::span<const uint16_t>(tiles).subspan(i * 16, 16)));
+    }
+}
+
+TEST(GeneratorTest, local) {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([]() {
+            for (int k = 0; k < 100; ++k) {
+                EXPECT_TRUE(Generator::local().solvable(6).is_solvable());
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+}
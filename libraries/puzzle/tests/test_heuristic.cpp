@@ -0,0 +1,227 @@
+#include <cstdio>
+#include <filesystem>
+#include <random>
+
+#include "gtest/gtest.h"
+#include "puzzle/DistanceTable.hpp"
+#include "puzzle/Generator.hpp"
+#include "puzzle/Heuristic.hpp"
+#include "puzzle/Solver.hpp"
+
+namespace {
+
+// Walks randomly from `board` and checks that updating the heuristic after every move gives the
+// same value as evaluating the new board from scratch.
+template <Heuristic H>
+void check_incremental(H heuristic, Board board, std::size_t moves, uint64_t seed) {
+    std::mt19937_64 engine(seed);
+    heuristic.init(board);
+    for (std::size_t i = 0; i < moves; ++i) {
+        const auto move = static_cast<Move>(engine() % 4);
+        auto next       = board.moved(move);
+        if (not next) {
+            continue;
+        }
+        board = std::move(*next);
+        heuristic.update(board, move);
+        H fresh = heuristic;
+        fresh.init(board);
+        ASSERT_EQ(fresh.value(), heuristic.value());
+    }
+}
+
+}  // anonymous namespace
+
+TEST(HeuristicTest, manhattan) {
+    ManhattanHeuristic heuristic;
+    const auto board = Board(std::vector<std::vector<unsigned>>{{4, 1, 3}, {7, 2, 6}, {0, 5, 8}});
+    heuristic.init(board);
+    EXPECT_EQ(board.manhattan(), heuristic.value());
+    for (unsigned side : {2u, 3u, 4u, 6u}) {
+        check_incremental(ManhattanHeuristic(), Generator(side).solvable(side), 300, side);
+    }
+}
+
+TEST(HeuristicTest, linear_conflict) {
+    LinearConflictHeuristic heuristic;
+    // 2 and 1 are in conflict in the first row, 7 and 4 in the first column.
+    heuristic.init(Board(std::vector<std::vector<unsigned>>{{2, 1, 3}, {7, 5, 6}, {4, 8, 0}}));
+    EXPECT_EQ(2u + 2u + 2u + 2u, heuristic.value());
+    heuristic.init(Board::create_goal(4));
+    EXPECT_EQ(0u, heuristic.value());
+    for (unsigned side : {2u, 3u, 4u, 5u}) {
+        check_incremental(LinearConflictHeuristic(), Generator(side + 10).solvable(side), 300, side);
+    }
+}
+
+TEST(HeuristicTest, admissible) {
+    const auto table = DistanceTable::build(3);
+    ASSERT_TRUE(table.has_value());
+    const auto patterns = PatternDatabase::build(3, {{1, 2, 3, 4}, {5, 6, 7, 8}});
+    ASSERT_TRUE(patterns.has_value());
+
+    ManhattanHeuristic manhattan;
+    LinearConflictHeuristic conflicts;
+    PatternHeuristic database(*patterns);
+    MaxHeuristic combined{LinearConflictHeuristic(), PatternHeuristic(*patterns)};
+    Generator generator(9);
+    for (int i = 0; i < 2000; ++i) {
+        const auto board    = generator.solvable(3);
+        const auto distance = *table->distance(board);
+        manhattan.init(board);
+        conflicts.init(board);
+        database.init(board);
+        combined.init(board);
+        EXPECT_LE(manhattan.value(), conflicts.value());
+        EXPECT_LE(conflicts.value(), distance);
+        EXPECT_LE(database.value(), distance);
+        EXPECT_EQ(std::max(conflicts.value(), database.value()), combined.value());
+        EXPECT_EQ(patterns->estimate(board), database.value());
+        EXPECT_EQ(distance % 2, manhattan.value() % 2);
+    }
+    check_incremental(combined, generator.solvable(3), 300, 5);
+}
+
+TEST(HeuristicTest, reflected) {
+    // Rows only, so that the transpose sees the columns.
+    const auto rows = PatternDatabase::build(4, {{1, 2, 3, 4}, {5, 6, 7, 8}, {9, 10, 11, 12}, {13, 14, 15}});
+    ASSERT_TRUE(rows.has_value());
+    const auto mod3 = rows->compress({PatternDatabase::Encoding::mod3, 1});
+    ASSERT_TRUE(mod3.has_value());
+
+    PatternHeuristic reflected(*rows, true);
+    Generator generator(36);
+    bool raised = false;
+    for (int i = 0; i < 200; ++i) {
+        const auto board = generator.solvable(4);
+        reflected.init(board);
+        EXPECT_EQ(std::max(rows->estimate(board), rows->estimate(board.transposed())), reflected.value());
+        raised = raised || reflected.value() > rows->estimate(board);
+    }
+    EXPECT_TRUE(raised);
+    check_incremental(PatternHeuristic(*rows, true), generator.solvable(4), 300, 10);
+    check_incremental(PatternHeuristic(*mod3, true), generator.solvable(4), 300, 11);
+
+    // The solver takes the reflected lookup with every engine.
+    for (int i = 0; i < 3; ++i) {
+        const auto board = *generator.at_least(4, 20);
+        SolveOptions options;
+        options.patterns  = {&*rows};
+        const auto plain  = Solver::solve(board, {}, PatternHeuristic(*rows));
+        const auto solved = Solver::solve(board, options);
+        EXPECT_EQ(plain.moves(), solved.moves());
+        EXPECT_LE(solved.stats().expanded, plain.stats().expanded);
+    }
+}
+
+TEST(HeuristicTest, pattern_database) {
+    EXPECT_FALSE(PatternDatabase::build(3, {{1, 2}, {2, 3}}).has_value());
+    EXPECT_FALSE(PatternDatabase::build(3, {{0, 1}}).has_value());
+    EXPECT_FALSE(PatternDatabase::build(3, {{9}}).has_value());
+    EXPECT_FALSE(PatternDatabase::build(3, {}).has_value());
+
+    const auto built = PatternDatabase::build(4, {{1, 2, 3}, {4, 5, 6, 7}});
+    ASSERT_TRUE(built.has_value());
+    EXPECT_EQ(2u, built->patterns());
+    EXPECT_EQ(1u, built->pattern_of(5));
+    EXPECT_EQ(2u, built->pattern_of(9));
+    EXPECT_EQ(0u, built->estimate(Board::create_goal(4)));
+
+    const auto path = (std::filesystem::temp_directory_path() / "puzzle_patterns").string();
+    ASSERT_TRUE(built->save(path));
+    const auto loaded = PatternDatabase::load(path);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(4u, loaded->size());
+    Generator generator(12);
+    for (int i = 0; i < 50; ++i) {
+        const auto board = generator.solvable(4);
+        EXPECT_EQ(built->estimate(board), loaded->estimate(board));
+        // Each pattern needs at least the Manhattan distance of its tiles.
+        EXPECT_LE(built->estimate(board), board.manhattan());
+    }
+    check_incremental(PatternHeuristic(*loaded), generator.solvable(4), 300, 7);
+    std::remove(path.c_str());
+}
+
+TEST(HeuristicTest, solver) {
+    const auto patterns  = PatternDatabase::build(3, {{1, 2, 3, 4}, {5, 6, 7, 8}});
+    const auto reflected = PatternDatabase::build(3, {{1, 4, 7, 2}, {5, 8, 3, 6}});
+    ASSERT_TRUE(patterns.has_value() && reflected.has_value());
+
+    SolveOptions conflicts;
+    conflicts.linear_conflict = true;
+    SolveOptions databases;
+    databases.patterns = {&*patterns, &*reflected};
+
+    Generator generator(21);
+    for (int i = 0; i < 15; ++i) {
+        const auto board          = generator.solvable(3);
+        const auto expected       = Solver::solve(board);
+        const auto with_conflicts = Solver::solve(board, conflicts);
+        const auto with_databases = Solver::solve(board, databases);
+        EXPECT_EQ(expected.moves(), with_conflicts.moves());
+        EXPECT_EQ(expected.moves(), with_databases.moves());
+        EXPECT_LE(with_conflicts.stats().expanded, expected.stats().expanded);
+        EXPECT_EQ(expected.moves(), Solver::solve(board, {}, PatternHeuristic(*patterns)).moves());
+    }
+
+    // Databases of another size are ignored.
+    const auto larger = *generator.at_least(4, 8);
+    EXPECT_EQ(Solver::solve(larger).moves(), Solver::solve(larger, databases).moves());
+}
+
+TEST(HeuristicTest, compressed) {
+    using Encoding = PatternDatabase::Encoding;
+    const auto exact = PatternDatabase::build(4, {{1, 2, 3, 4}, {5, 6, 7, 8}, {9, 10, 11, 12}, {13, 14, 15}});
+    ASSERT_TRUE(exact.has_value());
+    // 16 * 15 * 14 * 13 placements for each of the first three patterns, 16 * 15 * 14 for the last.
+    EXPECT_EQ(3u * 43680 + 3360, exact->memory());
+
+    const auto nibbles = exact->compress({Encoding::nibbles, 1});
+    const auto folded  = exact->compress({Encoding::bytes, 4});
+    const auto both    = exact->compress({Encoding::nibbles, 8});
+    const auto mod3    = exact->compress({Encoding::mod3, 1});
+    ASSERT_TRUE(nibbles && folded && both && mod3);
+    EXPECT_EQ(3u * 21840 + 1680, nibbles->memory());
+    EXPECT_EQ(3u * 10920 + 840, folded->memory());
+    EXPECT_EQ(3u * 2730 + 210, both->memory());
+    EXPECT_EQ(3u * 8736 + 672, mod3->memory());
+    EXPECT_FALSE(exact->compress({Encoding::bytes, 3}).has_value());
+    EXPECT_FALSE(exact->compress({Encoding::mod3, 2}).has_value());
+    EXPECT_FALSE(nibbles->compress({Encoding::mod3, 1}).has_value());
+
+    Generator generator(42);
+    unsigned exact_total = 0;
+    unsigned mod3_total  = 0;
+    for (int i = 0; i < 200; ++i) {
+        const auto board    = generator.solvable(4);
+        const auto estimate = exact->estimate(board);
+        EXPECT_LE(nibbles->estimate(board), estimate);
+        EXPECT_LE(folded->estimate(board), estimate);
+        EXPECT_LE(both->estimate(board), std::min(nibbles->estimate(board), folded->estimate(board)));
+        EXPECT_LE(mod3->estimate(board), estimate);
+        exact_total += estimate;
+        mod3_total += mod3->estimate(board);
+    }
+    // Rows wall the blank in often, which mod 3 pays for with a little strength.
+    EXPECT_GE(mod3_total * 10, exact_total * 9);
+    check_incremental(PatternHeuristic(*mod3), generator.solvable(4), 300, 8);
+    check_incremental(PatternHeuristic(*both), generator.solvable(4), 300, 9);
+
+    // The storage is kept in the file.
+    const auto path = (std::filesystem::temp_directory_path() / "puzzle_patterns_mod3").string();
+    ASSERT_TRUE(mod3->save(path));
+    const auto loaded = PatternDatabase::load(path);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(Encoding::mod3, loaded->storage().encoding);
+    EXPECT_EQ(mod3->memory(), loaded->memory());
+    std::remove(path.c_str());
+
+    SolveOptions options;
+    options.patterns = {&*loaded};
+    for (int i = 0; i < 5; ++i) {
+        const auto board = *generator.at_least(4, 20);
+        EXPECT_EQ(Solver::solve(board).moves(), Solver::solve(board, options).moves());
+        EXPECT_LE(mod3->estimate(board), Solver::solve(board).moves());
+    }
+}
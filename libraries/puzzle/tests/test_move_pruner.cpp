@@ -0,0 +1,147 @@
+#include <filesystem>
+#include <map>
+#include <queue>
+
+#include "gtest/gtest.h"
+#include "puzzle/Generator.hpp"
+#include "puzzle/MovePruner.hpp"
+#include "puzzle/Solver.hpp"
+
+namespace {
+
+constexpr Move moves[] = {Move::up, Move::down, Move::left, Move::right};
+
+// Fewest moves to every board within `depth` of `start`, by permutation rank.
+std::map<uint64_t, unsigned> neighbourhood(const Board& start, unsigned depth) {
+    std::map<uint64_t, unsigned> distances{{start.rank(), 0}};
+    std::queue<std::pair<Board, unsigned>> queue;
+    queue.emplace(start, 0);
+    while (not queue.empty()) {
+        auto [board, distance] = queue.front();
+        queue.pop();
+        for (auto move : moves) {
+            auto next = board.moved(move);
+            if (distance < depth && next && distances.emplace(next->rank(), distance + 1).second) {
+                queue.emplace(std::move(*next), distance + 1);
+            }
+        }
+    }
+    return distances;
+}
+
+// Same by depth-first search of the paths the machine lets through, also counting them.
+std::size_t walk(const MovePruner& pruner, const Board& board, MovePruner::State state, unsigned length,
+                 unsigned depth, std::map<uint64_t, unsigned>& distances) {
+    auto known        = distances.emplace(board.rank(), length).first;
+    known->second     = std::min(known->second, length);
+    std::size_t paths = 1;
+    for (auto move : moves) {
+        const auto next_state = pruner.next(state, move);
+        auto next             = board.moved(move);
+        if (length < depth && next_state != MovePruner::pruned && next) {
+            paths += walk(pruner, *next, next_state, length + 1, depth, distances);
+        }
+    }
+    return paths;
+}
+
+}  // anonymous namespace
+
+TEST(MovePrunerTest, learn) {
+    EXPECT_FALSE(MovePruner::learn(0).has_value());
+    EXPECT_FALSE(MovePruner::learn(MovePruner::max_depth + 1).has_value());
+
+    // Up to depth 5 the only twins are a move and its undoing, and the empty path.
+    const auto undo = MovePruner::learn(2);
+    ASSERT_TRUE(undo.has_value());
+    EXPECT_EQ(4u, undo->sequences());
+    EXPECT_EQ(4u, MovePruner::learn(5)->sequences());
+    for (auto first : moves) {
+        const auto state = undo->next(MovePruner::start, first);
+        ASSERT_NE(MovePruner::pruned, state);
+        for (auto second : moves) {
+            EXPECT_EQ(second == opposite(first), undo->next(state, second) == MovePruner::pruned);
+        }
+    }
+
+    // A lap and a half around a 2x2 block does what a lap and a half the other way does, which
+    // starts with an earlier move; a full lap has no twin.
+    const auto pruner = MovePruner::learn(8);
+    ASSERT_TRUE(pruner.has_value());
+    EXPECT_EQ(8u, MovePruner::learn(6)->sequences());
+    EXPECT_GT(pruner->sequences(), 8u);
+    auto state = MovePruner::start;
+    for (auto move : {Move::right, Move::down, Move::left, Move::up, Move::right}) {
+        state = pruner->next(state, move);
+        ASSERT_NE(MovePruner::pruned, state);
+    }
+    EXPECT_EQ(MovePruner::pruned, pruner->next(state, Move::down));
+    state = MovePruner::start;
+    for (auto move : {Move::down, Move::right, Move::up, Move::left, Move::down, Move::right}) {
+        state = pruner->next(state, move);
+        ASSERT_NE(MovePruner::pruned, state);
+    }
+}
+
+TEST(MovePrunerTest, complete) {
+    // Every board stays reachable by a shortest path, near the edges as well as in the middle,
+    // through fewer paths than without the machine.
+    const auto undo   = MovePruner::learn(2);
+    const auto pruner = MovePruner::learn(10);
+    ASSERT_TRUE(pruner.has_value());
+    Generator generator(44);
+    for (unsigned size : {3u, 4u}) {
+        for (int i = 0; i < 4; ++i) {
+            const auto start = generator.solvable(size);
+            const auto depth = size == 3 ? 14u : 12u;
+            std::map<uint64_t, unsigned> all;
+            std::map<uint64_t, unsigned> kept;
+            const auto unpruned = walk(*undo, start, MovePruner::start, 0, depth, all);
+            const auto pruned   = walk(*pruner, start, MovePruner::start, 0, depth, kept);
+            EXPECT_EQ(neighbourhood(start, depth), kept) << start;
+            EXPECT_LT(pruned, unpruned);
+        }
+    }
+}
+
+TEST(MovePrunerTest, save) {
+    const auto path = std::filesystem::temp_directory_path() / "puzzle_move_pruner_test.bin";
+    std::filesystem::remove(path);
+    EXPECT_FALSE(MovePruner::load(path.string()).has_value());
+
+    const auto learned = MovePruner::load_or_learn(path.string(), 8);
+    ASSERT_TRUE(learned.has_value());
+    const auto loaded = MovePruner::load(path.string());
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(8u, loaded->depth());
+    EXPECT_EQ(learned->sequences(), loaded->sequences());
+    ASSERT_EQ(learned->states(), loaded->states());
+    for (MovePruner::State state = 0; state < loaded->states(); ++state) {
+        for (auto move : moves) {
+            EXPECT_EQ(learned->next(state, move), loaded->next(state, move));
+        }
+    }
+    EXPECT_EQ(learned->states(), MovePruner::load_or_learn(path.string(), 8)->states());
+    std::filesystem::remove(path);
+}
+
+TEST(MovePrunerTest, solver) {
+    const auto pruner = MovePruner::learn(10);
+    ASSERT_TRUE(pruner.has_value());
+    Generator generator(45);
+    for (unsigned threads : {1u, 3u}) {
+        for (int i = 0; i < 6; ++i) {
+            const auto board = *generator.at_least(i < 2 ? 3 : 4, 20);
+            SolveOptions options;
+            options.deepening_threads = threads;
+            const auto plain          = Solver::solve(board, options);
+            options.move_pruner       = &*pruner;
+            const auto solution       = Solver::solve(board, options);
+            ASSERT_EQ(Solver::solve(board).moves(), solution.moves()) << board;
+            EXPECT_TRUE((solution.end() - 1)->is_goal());
+            if (threads == 1) {
+                EXPECT_LE(solution.stats().generated, plain.stats().generated) << board;
+            }
+        }
+    }
+}
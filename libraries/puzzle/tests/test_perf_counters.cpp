@@ -0,0 +1,72 @@
+#include "gtest/gtest.h"
+#include "puzzle/Generator.hpp"
+#include "puzzle/PerfCounters.hpp"
+#include "puzzle/Solver.hpp"
+
+TEST(PerfCountersTest, scope) {
+    PerfReport report;
+    {
+        // Without counters a scope leaves the report alone.
+        const PerfScope scope(nullptr, report, Phase::heuristic);
+    }
+    EXPECT_EQ(0u, report[Phase::heuristic].scopes);
+
+    // Kernels that refuse the counters, as in most containers and virtual machines, leave nothing
+    // more to check.
+    auto counters = PerfCounters::open();
+    if (not counters) {
+        return;
+    }
+    EXPECT_TRUE(PerfCounters::compiled);
+    const auto moved = std::move(counters);
+    volatile uint64_t sum = 0;
+    for (int round = 0; round < 2; ++round) {
+        const PerfScope scope(&*moved, report, Phase::successors);
+        for (uint64_t i = 0; i < 100'000; ++i) {
+            sum = sum + i;
+        }
+    }
+    const auto& counted = report[Phase::successors];
+    EXPECT_EQ(2u, counted.scopes);
+    EXPECT_GT(counted.instructions, 200'000u);
+    EXPECT_GT(counted.cycles, 0u);
+    EXPECT_EQ(0u, report[Phase::path].instructions);
+
+    PerfReport total;
+    total += report;
+    total += report;
+    EXPECT_EQ(2 * counted.instructions, total[Phase::successors].instructions);
+    EXPECT_EQ(4u, total[Phase::successors].scopes);
+}
+
+TEST(PerfCountersTest, solver) {
+    const bool supported = PerfCounters::open().has_value();
+    Generator generator(48);
+    const auto board = *generator.at_least(3, 16);
+    for (int engine = 0; engine < 3; ++engine) {
+        SolveOptions options;
+        options.breadth_first     = engine == 1;
+        options.deepening_threads = engine == 2 ? 2 : 0;
+        const auto plain          = Solver::solve(board, options);
+        EXPECT_FALSE(plain.stats().perf.available);
+        EXPECT_EQ(0u, plain.stats().perf[Phase::successors].scopes);
+
+        // Counting changes nothing about the search, and reports each phase it goes through.
+        options.perf_counters = true;
+        const auto counted    = Solver::solve(board, options);
+        ASSERT_EQ(plain.moves(), counted.moves()) << engine;
+        const auto& perf = counted.stats().perf;
+        EXPECT_EQ(supported, perf.available) << engine;
+        if (not supported) {
+            continue;
+        }
+        for (auto phase : {Phase::successors, Phase::heuristic, Phase::closed_set, Phase::path}) {
+            EXPECT_GT(perf[phase].scopes, 0u) << engine;
+            EXPECT_GT(perf[phase].instructions, 0u) << engine;
+        }
+        EXPECT_GE(perf[Phase::successors].scopes, counted.stats().generated) << engine;
+        if (engine == 0) {
+            EXPECT_GE(perf[Phase::open_list].scopes, counted.stats().expanded) << engine;
+        }
+    }
+}
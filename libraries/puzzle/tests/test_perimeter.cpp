@@ -0,0 +1,80 @@
+#include "gtest/gtest.h"
+#include "puzzle/DistanceTable.hpp"
+#include "puzzle/Generator.hpp"
+#include "puzzle/Perimeter.hpp"
+#include "puzzle/Solver.hpp"
+
+TEST(PerimeterTest, build) {
+    EXPECT_FALSE(Perimeter::build(1, 5).has_value());
+    EXPECT_FALSE(Perimeter::build(5, 5).has_value());
+    EXPECT_FALSE(Perimeter::build(4, Perimeter::max_depth + 1).has_value());
+
+    // Boards of the 8-puzzle within 10 moves: 1 + 2 + 4 + 8 + 16 + 20 + 39 + 62 + 116 + 152 + 286.
+    const auto perimeter = Perimeter::build(3, 10);
+    ASSERT_TRUE(perimeter.has_value());
+    EXPECT_EQ(706u, perimeter->boards());
+    EXPECT_EQ(10u, perimeter->depth());
+
+    const auto table = DistanceTable::build(3);
+    Generator generator(38);
+    for (int i = 0; i < 200; ++i) {
+        const auto board    = generator.walk(3, 12);
+        const auto expected = *table->distance(board);
+        EXPECT_EQ(expected <= 10 ? std::optional<unsigned>(expected) : std::nullopt, perimeter->distance(board));
+    }
+    EXPECT_FALSE(perimeter->distance(Board::create_goal(4)).has_value());
+
+    // The whole 2x2 space is six moves deep.
+    EXPECT_EQ(12u, Perimeter::build(2, 20)->boards());
+}
+
+TEST(PerimeterTest, path) {
+    const auto perimeter = Perimeter::build(4, 8);
+    ASSERT_TRUE(perimeter.has_value());
+    Generator generator(8);
+    for (int i = 0; i < 20; ++i) {
+        const auto board = generator.walk(4, 10);
+        const auto path  = perimeter->path(board);
+        if (not perimeter->distance(board)) {
+            EXPECT_TRUE(path.empty());
+            continue;
+        }
+        ASSERT_EQ(*perimeter->distance(board) + 1, path.size());
+        EXPECT_EQ(board, path.front());
+        EXPECT_TRUE(path.back().is_goal());
+        for (std::size_t j = 1; j < path.size(); ++j) {
+            EXPECT_TRUE(path[j - 1].move_to(path[j]).has_value());
+        }
+    }
+}
+
+TEST(PerimeterTest, solver) {
+    const auto perimeter = Perimeter::build(4, 10);
+    ASSERT_TRUE(perimeter.has_value());
+    SolveOptions options;
+    options.perimeter = &*perimeter;
+
+    Generator generator(41);
+    std::size_t plain    = 0;
+    std::size_t bordered = 0;
+    for (int i = 0; i < 10; ++i) {
+        const auto board    = *generator.at_least(4, 18);
+        const auto expected = Solver::solve(board);
+        const auto solution = Solver::solve(board, options);
+        ASSERT_EQ(expected.moves(), solution.moves());
+        EXPECT_EQ(board, *solution.begin());
+        EXPECT_TRUE((solution.end() - 1)->is_goal());
+        const auto path = solution.path();
+        EXPECT_EQ(solution.moves(), path.size());
+        plain += expected.stats().expanded;
+        bordered += solution.stats().expanded;
+    }
+    EXPECT_LT(bordered, plain);
+
+    // Boards inside are answered without search, boards of other sizes are searched as usual.
+    const auto near = generator.walk(4, 6);
+    EXPECT_EQ(*perimeter->distance(near), Solver::solve(near, options).moves());
+    EXPECT_EQ(0u, Solver::solve(near, options).stats().expanded);
+    const auto small = generator.solvable(3);
+    EXPECT_EQ(Solver::solve(small).moves(), Solver::solve(small, options).moves());
+}
@@ -0,0 +1,296 @@
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <sstream>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "puzzle/Generator.hpp"
+#include "puzzle/Server.hpp"
+#include "puzzle/TextFormat.hpp"
+
+namespace {
+
+int connect_tcp(uint16_t port) {
+    const int socket = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family      = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port        = htons(port);
+    EXPECT_EQ(0, ::connect(socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)));
+    return socket;
+}
+
+int connect_unix(const std::string& path) {
+    const int socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    EXPECT_EQ(0, ::connect(socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)));
+    return socket;
+}
+
+void send_all(int socket, const std::string& text) {
+    std::size_t sent = 0;
+    while (sent < text.size()) {
+        const auto written = ::send(socket, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+        ASSERT_GT(written, 0);
+        sent += static_cast<std::size_t>(written);
+    }
+}
+
+// Reads `count` answer lines and maps them from their id to the rest of the line.
+std::map<std::string, std::string> receive(int socket, std::size_t count) {
+    std::map<std::string, std::string> answers;
+    std::string buffer;
+    char chunk[4096];
+    while (answers.size() < count) {
+        const auto received = ::recv(socket, chunk, sizeof(chunk), 0);
+        if (received <= 0) {
+            break;
+        }
+        buffer.append(chunk, static_cast<std::size_t>(received));
+        for (auto newline = buffer.find('\n'); newline != std::string::npos; newline = buffer.find('\n')) {
+            const auto line  = buffer.substr(0, newline);
+            const auto space = line.find(' ');
+            answers[line.substr(0, space)] = line.substr(space + 1);
+            buffer.erase(0, newline + 1);
+        }
+    }
+    return answers;
+}
+
+std::string tiles(const Board& board) {
+    std::string out;
+    TextFormat::append_tiles(out, board);
+    out.pop_back();
+    return out;
+}
+
+}  // anonymous namespace
+
+TEST(ServerTest, pipelined) {
+    Server::Options options;
+    options.threads     = 3;
+    options.queue       = 2;
+    options.cache_bytes = 1 << 20;
+    Server server(options);
+    ASSERT_TRUE(server.listen());
+    ASSERT_NE(0, server.port());
+    std::thread serving([&]() { server.serve(); });
+
+    Generator generator(3);
+    std::vector<Board> boards;
+    std::vector<std::string> ids;
+    std::string requests;
+    for (int i = 0; i < 40; ++i) {
+        boards.push_back(*generator.at_least(3, 4 + i % 8));
+        ids.push_back(std::string("b").append(std::to_string(i)));
+        requests += ids.back() + ' ' + tiles(boards.back()) + '\n';
+    }
+    requests += "bad 1 2 3\n";
+    requests += "odd 2 1 3 4 5 6 7 8 0\n";
+    requests += "budget nodes=1 8 6 7 2 5 4 3 0 1\n";
+    requests += "typo nodes=x 1 2 3 4 5 6 7 8 0\n";
+    requests += "\n";
+
+    const int socket = connect_tcp(server.port());
+    // Sent in pieces that split lines, from another thread so that back-pressure cannot block us.
+    std::thread sender([&]() {
+        for (std::size_t i = 0; i < requests.size(); i += 7) {
+            send_all(socket, requests.substr(i, 7));
+        }
+    });
+    const auto answers = receive(socket, boards.size() + 4);
+    sender.join();
+
+    ASSERT_EQ(boards.size() + 4, answers.size());
+    for (std::size_t i = 0; i < boards.size(); ++i) {
+        // With the shared cache another path of the same length may come back.
+        std::istringstream answer(answers.at(ids[i]));
+        std::size_t moves = 0;
+        std::string path;
+        answer >> moves >> path;
+        EXPECT_EQ(Solver::solve(boards[i]).moves(), moves);
+        ASSERT_EQ(moves, path.size());
+        std::optional<Board> board = boards[i];
+        for (char move : path) {
+            board = board->moved(static_cast<Move>(std::string_view("UDLR").find(move)));
+            ASSERT_TRUE(board.has_value());
+        }
+        EXPECT_TRUE(board->is_goal());
+    }
+    EXPECT_EQ("invalid", answers.at("bad"));
+    EXPECT_EQ("unsolvable", answers.at("odd"));
+    EXPECT_EQ("budget", answers.at("budget"));
+    EXPECT_EQ("invalid", answers.at("typo"));
+
+    ::close(socket);
+    server.stop();
+    serving.join();
+}
+
+TEST(ServerTest, unix_socket) {
+    const auto path = (std::filesystem::temp_directory_path() / "puzzle_server_test.sock").string();
+    Server::Options options;
+    options.socket_path = path;
+    options.threads     = 2;
+    auto server         = std::make_unique<Server>(options);
+    ASSERT_TRUE(server->listen());
+    std::thread serving([&]() { server->serve(); });
+
+    const int first  = connect_unix(path);
+    const int second = connect_unix(path);
+    send_all(first, "a 1 2 3 4 5 6 7 0 8\n");
+    send_all(second, "b 1 2 3 4 5 6 7 8 0\n");
+    EXPECT_EQ("1 R", receive(first, 1).at("a"));
+    EXPECT_EQ("0 ", receive(second, 1).at("b"));
+
+    // Stopping closes the connections for reading; clients see the end of the stream.
+    server->stop();
+    serving.join();
+    char byte = 0;
+    EXPECT_EQ(0, ::recv(first, &byte, 1, 0));
+    ::close(first);
+    ::close(second);
+    server.reset();
+    EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+TEST(ServerTest, budgets) {
+    Server::Options options;
+    options.threads           = 1;
+    options.solve.node_budget = 1000;
+    Server server(options);
+    ASSERT_TRUE(server.listen());
+    std::thread serving([&]() { server.serve(); });
+
+    // Requests can lower the server's budget but never lift it.
+    const int socket = connect_tcp(server.port());
+    send_all(socket,
+             "unlimited nodes=0 8 6 7 2 5 4 3 0 1\n"
+             "larger nodes=100000000 ms=0 8 6 7 2 5 4 3 0 1\n"
+             "lower nodes=1 0 1 2 4 5 3 7 8 6\n"
+             "default 0 1 2 4 5 3 7 8 6\n"
+             "easy nodes=100 1 2 3 4 5 6 7 0 8\n");
+    const auto answers = receive(socket, 5);
+    EXPECT_EQ("budget", answers.at("unlimited"));
+    EXPECT_EQ("budget", answers.at("larger"));
+    EXPECT_EQ("budget", answers.at("lower"));
+    EXPECT_EQ("4 RRDD", answers.at("default"));
+    EXPECT_EQ("1 R", answers.at("easy"));
+
+    ::close(socket);
+    server.stop();
+    serving.join();
+}
+
+TEST(ServerTest, slow_client) {
+    const auto path = (std::filesystem::temp_directory_path() / "puzzle_server_slow.sock").string();
+    Server::Options options;
+    options.socket_path  = path;
+    options.threads      = 1;
+    options.output_limit = 4096;
+    Server server(options);
+    ASSERT_TRUE(server.listen());
+    std::thread serving([&]() { server.serve(); });
+
+    // A client that pipelines far more answers than the sockets buffer and never reads them.
+    const int slow = connect_unix(path);
+    std::thread flooding([&]() {
+        std::string requests;
+        for (int i = 0; i < 100'000; ++i) {
+            requests += std::to_string(i) + " 1 2 3 4 5 6 7 0 8\n";
+        }
+        std::size_t sent = 0;
+        while (sent < requests.size()) {
+            const auto written = ::send(slow, requests.data() + sent, requests.size() - sent, MSG_NOSIGNAL);
+            if (written <= 0) {
+                break;
+            }
+            sent += static_cast<std::size_t>(written);
+        }
+    });
+
+    // Stalls only itself: the single worker still answers another client.
+    const int other = connect_unix(path);
+    const timeval timeout{10, 0};
+    ::setsockopt(other, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    for (int round = 0; round < 3; ++round) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        const auto id = std::string("x").append(std::to_string(round));
+        send_all(other, id + " 1 2 3 4 5 6 0 7 8\n");
+        EXPECT_EQ("2 RR", receive(other, 1)[id]);
+    }
+
+    ::shutdown(slow, SHUT_RDWR);
+    flooding.join();
+    ::close(slow);
+    ::close(other);
+    server.stop();
+    serving.join();
+}
+
+TEST(ServerTest, stop_unread) {
+    const auto path = (std::filesystem::temp_directory_path() / "puzzle_server_unread.sock").string();
+    Server::Options options;
+    options.socket_path   = path;
+    options.threads       = 1;
+    options.output_limit  = 4096;
+    options.drain_timeout = std::chrono::milliseconds(100);
+    Server server(options);
+    ASSERT_TRUE(server.listen());
+    std::thread serving([&]() { server.serve(); });
+
+    // A client that stays connected and never reads its answers does not keep the server up.
+    const int client = connect_unix(path);
+    std::thread flooding([&]() {
+        std::string requests;
+        for (int i = 0; i < 100'000; ++i) {
+            requests += std::to_string(i) + " 1 2 3 4 5 6 7 0 8\n";
+        }
+        std::size_t sent = 0;
+        while (sent < requests.size()) {
+            const auto written = ::send(client, requests.data() + sent, requests.size() - sent, MSG_NOSIGNAL);
+            if (written <= 0) {
+                break;
+            }
+            sent += static_cast<std::size_t>(written);
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    server.stop();
+    serving.join();
+
+    ::shutdown(client, SHUT_RDWR);
+    flooding.join();
+    ::close(client);
+}
+
+TEST(ServerTest, engines) {
+    SolveOptions options;
+    EXPECT_TRUE(TextFormat::parse_engine("ida", 3, options));
+    EXPECT_EQ(3u, options.deepening_threads);
+    EXPECT_TRUE(TextFormat::parse_engine("distributed", 0, options));
+    EXPECT_EQ(0u, options.deepening_threads);
+    EXPECT_EQ(1u, options.distributed_workers);
+    EXPECT_TRUE(TextFormat::parse_engine("epea", 2, options));
+    EXPECT_TRUE(options.partial_expansion);
+    EXPECT_EQ(0u, options.distributed_workers);
+    EXPECT_TRUE(TextFormat::parse_engine("bfhs", 1, options));
+    EXPECT_TRUE(options.breadth_first);
+    EXPECT_FALSE(options.partial_expansion);
+    EXPECT_TRUE(TextFormat::parse_engine("astar", 1, options));
+    EXPECT_FALSE(options.breadth_first);
+    EXPECT_FALSE(TextFormat::parse_engine("dfs", 1, options));
+
+    EXPECT_EQ(SolveOptions::Lookups::both, TextFormat::parse_lookups("both"));
+    EXPECT_EQ(SolveOptions::Lookups::regular, TextFormat::parse_lookups("regular"));
+    EXPECT_FALSE(TextFormat::parse_lookups("all"));
+}
@@ -0,0 +1,138 @@
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "puzzle/Generator.hpp"
+#include "puzzle/Solver.hpp"
+#include "puzzle/SolutionCache.hpp"
+
+namespace {
+
+std::vector<Board> to_vector(const auto& solution) {
+    return {solution.begin(), solution.end()};
+}
+
+}  // anonymous namespace
+
+TEST(SolutionCacheTest, supports) {
+    EXPECT_FALSE(SolutionCache::supports(Board()));
+    EXPECT_FALSE(SolutionCache::supports(Board::create_goal(1)));
+    EXPECT_TRUE(SolutionCache::supports(Board::create_goal(2)));
+    EXPECT_TRUE(SolutionCache::supports(Board::create_goal(4)));
+    EXPECT_FALSE(SolutionCache::supports(Board::create_goal(5)));
+
+    SolutionCache cache(1 << 16);
+    const auto big = Board::create_goal(5);
+    cache.insert(big, {0, Move::up});
+    EXPECT_FALSE(cache.find(big).has_value());
+}
+
+TEST(SolutionCacheTest, path) {
+    SolutionCache cache(1 << 20);
+    Generator generator(11);
+    const auto board = *generator.exact(3, 12);
+    EXPECT_FALSE(cache.find(board).has_value());
+
+    const auto solution = Solver::solve(board, cache);
+    ASSERT_EQ(12, solution.moves());
+    const auto path = to_vector(solution);
+    for (std::size_t i = 0; i < path.size(); ++i) {
+        const auto entry = cache.find(path[i]);
+        ASSERT_TRUE(entry.has_value());
+        EXPECT_EQ(path.size() - 1 - i, entry->distance);
+        const auto rest = cache.solution(path[i]);
+        ASSERT_TRUE(rest.has_value());
+        EXPECT_EQ(std::vector<Board>(path.begin() + i, path.end()), *rest);
+    }
+
+    const auto again = Solver::solve(path[3], cache);
+    EXPECT_EQ(9, again.moves());
+    EXPECT_EQ(std::vector<Board>(path.begin() + 3, path.end()), to_vector(again));
+}
+
+TEST(SolutionCacheTest, same_moves) {
+    // Searches that run into cached states must stay optimal.
+    SolutionCache cache(1 << 22);
+    Generator generator(12);
+    for (int i = 0; i < 40; ++i) {
+        const auto board = *generator.at_least(3, 8);
+        const auto cold  = Solver::solve(board);
+        const auto warm  = Solver::solve(board, cache);
+        EXPECT_EQ(cold.moves(), warm.moves()) << board;
+        const auto path = to_vector(warm);
+        ASSERT_FALSE(path.empty());
+        EXPECT_EQ(board, path.front());
+        EXPECT_TRUE(path.back().is_goal());
+        for (std::size_t k = 1; k < path.size(); ++k) {
+            EXPECT_TRUE(path[k - 1].move_to(path[k]).has_value());
+        }
+    }
+}
+
+TEST(SolutionCacheTest, bounded) {
+    SolutionCache cache(1024);
+    EXPECT_EQ(1024, cache.memory());
+    EXPECT_EQ(128, cache.capacity());
+
+    Generator generator(13);
+    std::vector<Board> boards;
+    for (int i = 0; i < 1000; ++i) {
+        boards.push_back(generator.solvable(4));
+        cache.insert(boards.back(), {42, Move::left});
+    }
+    std::size_t found = 0;
+    for (const auto& board : boards) {
+        if (const auto entry = cache.find(board)) {
+            EXPECT_EQ(42, entry->distance);
+            EXPECT_EQ(Move::left, entry->next);
+            ++found;
+        }
+    }
+    EXPECT_GT(found, 0);
+    EXPECT_LE(found, cache.capacity());
+    // Recently inserted entries survive eviction.
+    EXPECT_TRUE(cache.find(boards.back()).has_value());
+}
+
+TEST(SolutionCacheTest, parallel) {
+    SolutionCache cache(1 << 20);
+    Generator generator(14);
+    std::vector<Board> boards;
+    for (int i = 0; i < 16; ++i) {
+        boards.push_back(*generator.at_least(3, 10));
+    }
+    std::vector<std::size_t> expected;
+    for (const auto& board : boards) {
+        expected.push_back(Solver::solve(board).moves());
+    }
+
+    std::vector<std::thread> threads;
+    std::vector<std::size_t> moves(boards.size() * 4);
+    for (std::size_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t]() {
+            for (std::size_t i = 0; i < boards.size(); ++i) {
+                moves[t * boards.size() + i] = Solver::solve(boards[i], cache).moves();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (std::size_t i = 0; i < moves.size(); ++i) {
+        EXPECT_EQ(expected[i % boards.size()], moves[i]);
+    }
+}
+
+TEST(SolutionCacheTest, transposed) {
+    SolutionCache cache(1 << 20);
+    Generator generator(15);
+    const auto board    = *generator.exact(3, 14);
+    const auto solution = to_vector(Solver::solve(board, cache));
+
+    // The transposed board is answered from the same entries, with every move transposed.
+    const auto flipped = cache.solution(board.transposed());
+    ASSERT_TRUE(flipped.has_value());
+    ASSERT_EQ(solution.size(), flipped->size());
+    for (std::size_t i = 0; i < solution.size(); ++i) {
+        EXPECT_EQ(solution[i].transposed(), (*flipped)[i]);
+    }
+}
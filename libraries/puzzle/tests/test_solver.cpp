@@ -1,11 +1,15 @@
+#include <algorithm>
 #include <array>
 #include <list>
 #include <mutex>
+#include <random>
 #include <thread>
 #include <type_traits>
 #include <utility>
 
 #include "gtest/gtest.h"
+#include "puzzle/Generator.hpp"
+#include "puzzle/PatternDatabase.hpp"
 #include "puzzle/Solver.hpp"
 
 namespace {
@@ -331,3 +335,289 @@ TEST(SolverTest, zero_step) {
         EXPECT_EQ(0, solution.moves());
     }
 }
+
+TEST(SolverTest, invalid) {
+    const std::vector<Board> boards = {make_board(2, {1, 1, 2, 0}), make_board(3, {1, 2, 3, 4, 5, 6, 7, 8, 9}),
+                                       Board(std::vector<std::vector<unsigned>>{{3}})};
+    for (const auto& board : boards) {
+        const auto solution = Solver::solve(board);
+        EXPECT_EQ(0, solution.moves());
+        EXPECT_EQ(solution.begin(), solution.end());
+    }
+}
+
+TEST(SolverTest, partial_expansion) {
+    SolveOptions partial;
+    partial.partial_expansion = true;
+    SolveOptions conflicts    = partial;
+    conflicts.linear_conflict = true;
+
+    Generator generator(39);
+    std::size_t full_generated    = 0;
+    std::size_t partial_generated = 0;
+    for (int i = 0; i < 10; ++i) {
+        const auto board    = *generator.at_least(4, 20);
+        const auto expected = Solver::solve(board);
+        const auto solution = Solver::solve(board, partial);
+        ASSERT_EQ(expected.moves(), solution.moves());
+        EXPECT_EQ(board, *solution.begin());
+        EXPECT_EQ(make_goal(4), *(solution.end() - 1));
+        EXPECT_EQ(solution.moves(), solution.path().size());
+        EXPECT_EQ(expected.moves(), Solver::solve(board, conflicts).moves());
+        full_generated += expected.stats().generated;
+        partial_generated += solution.stats().generated;
+    }
+    EXPECT_LT(partial_generated, full_generated);
+
+    for (const auto& c : threes) {
+        const auto solution = Solver::solve(make_board(c.data), partial);
+        EXPECT_EQ(Solver::solve(make_board(c.data)).moves(), solution.moves());
+    }
+}
+
+TEST(SolverTest, closed_set) {
+    // The closed set keeps a word per board up to 4x4 in a table at most three quarters full, and
+    // two bytes more above; every path rebuilt from it is a walk of single moves to the goal.
+    Generator generator(45);
+    for (unsigned size : {3u, 4u, 5u}) {
+        for (int i = 0; i < 5; ++i) {
+            const auto board    = size == 5 ? generator.walk(5, 25) : *generator.at_least(size, 18);
+            const auto solution = Solver::solve(board);
+            ASSERT_GT(solution.moves(), 0u);
+            EXPECT_EQ(board, *solution.begin());
+            EXPECT_EQ(make_goal(size), *(solution.end() - 1));
+            EXPECT_EQ(solution.moves(), solution.path().size());
+
+            const std::size_t word  = size == 5 ? 10 : 8;
+            const std::size_t slots = std::max<std::size_t>(1024, (solution.stats().generated + 1) * 8 / 3);
+            EXPECT_GE(solution.stats().closed_memory, word * 1024);
+            EXPECT_LE(solution.stats().closed_memory, word * slots);
+        }
+    }
+}
+
+TEST(SolverTest, breadth_first) {
+    SolveOptions options;
+    options.breadth_first = true;
+    Generator generator(46);
+    std::size_t held    = 0;
+    std::size_t reached = 0;
+    for (unsigned size : {2u, 3u, 4u}) {
+        for (int i = 0; i < 6; ++i) {
+            const auto board    = size == 2 ? generator.solvable(2) : *generator.at_least(size, 20);
+            const auto expected = Solver::solve(board);
+            const auto solution = Solver::solve(board, options);
+            ASSERT_EQ(expected.moves(), solution.moves()) << board;
+            EXPECT_EQ(board, *solution.begin());
+            EXPECT_EQ(make_goal(size), *(solution.end() - 1));
+            EXPECT_EQ(solution.moves(), solution.path().size());
+            held += solution.stats().frontier_peak;
+            reached += expected.stats().generated;
+        }
+    }
+    // Far fewer boards are held at once than A* keeps in its closed set.
+    EXPECT_LT(held * 2, reached);
+
+    options.linear_conflict = true;
+    for (const auto& c : threes) {
+        const auto solution = Solver::solve(make_board(c.data), options);
+        EXPECT_EQ(Solver::solve(make_board(c.data)).moves(), solution.moves());
+    }
+
+    options.node_budget = 100;
+    const auto stopped  = Solver::solve(*generator.at_least(4, 40), options);
+    EXPECT_TRUE(stopped.stats().budget_exhausted);
+    EXPECT_EQ(stopped.begin(), stopped.end());
+}
+
+TEST(SolverTest, lookups) {
+    using Lookups       = SolveOptions::Lookups;
+    const auto patterns = PatternDatabase::build(4, {{1, 2, 3, 4}, {5, 6, 7, 8}, {9, 10, 11, 12}, {13, 14, 15}});
+    ASSERT_TRUE(patterns.has_value());
+
+    // Every kind of lookup keeps the solutions optimal, with and without pathmax.
+    Generator generator(45);
+    std::size_t raised  = 0;
+    std::size_t cutoffs = 0;
+    for (int i = 0; i < 5; ++i) {
+        const auto board    = *generator.at_least(4, 30);
+        const auto expected = Solver::solve(board).moves();
+        for (auto lookups : {Lookups::regular, Lookups::reflected, Lookups::dual, Lookups::both, Lookups::random}) {
+            for (bool pathmax : {false, true}) {
+                SolveOptions options;
+                options.deepening_threads = 1;
+                options.patterns          = {&*patterns};
+                options.lookups           = lookups;
+                options.pathmax           = pathmax;
+                const auto solution       = Solver::solve(board, options);
+                ASSERT_EQ(expected, solution.moves()) << board;
+                if (lookups == Lookups::regular) {
+                    EXPECT_EQ(0u, solution.stats().lookups_raised);
+                }
+                if (not pathmax) {
+                    EXPECT_EQ(0u, solution.stats().pathmax_cutoffs);
+                }
+                raised += lookups == Lookups::dual ? solution.stats().lookups_raised : 0;
+                cutoffs += lookups == Lookups::random ? solution.stats().pathmax_cutoffs : 0;
+            }
+        }
+    }
+    EXPECT_GT(raised, 0u);
+    EXPECT_GT(cutoffs, 0u);
+
+    // Without databases of the board's size there is nothing further to look up.
+    SolveOptions options;
+    options.deepening_threads = 1;
+    options.patterns          = {&*patterns};
+    options.lookups           = Lookups::both;
+    const auto small          = *generator.at_least(3, 20);
+    const auto solution       = Solver::solve(small, options);
+    EXPECT_EQ(Solver::solve(small).moves(), solution.moves());
+    EXPECT_EQ(0u, solution.stats().lookups_raised);
+}
+
+TEST(SolverTest, approximate) {
+    // Plays the moves on the tiles directly, which large boards need.
+    const auto play = [](const Board& board, const std::vector<Move>& moves) {
+        const std::size_t side = board.size();
+        std::vector<uint16_t> tiles(board.tiles().begin(), board.tiles().end());
+        std::size_t blank = board.blank();
+        for (auto move : moves) {
+            const std::size_t row    = blank / side;
+            const std::size_t column = blank % side;
+            std::size_t next         = blank;
+            if (move == Move::up && row > 0) {
+                next = blank - side;
+            } else if (move == Move::down && row + 1 < side) {
+                next = blank + side;
+            } else if (move == Move::left && column > 0) {
+                next = blank - 1;
+            } else if (move == Move::right && column + 1 < side) {
+                next = blank + 1;
+            }
+            EXPECT_NE(blank, next) << "Move off the board";
+            std::swap(tiles[blank], tiles[next]);
+            blank = next;
+        }
+        return Board(side, tiles);
+    };
+
+    Generator generator(40);
+    for (unsigned side : {2u, 3u}) {
+        const auto board = generator.solvable(side);
+        EXPECT_EQ(Solver::solve(board).moves(), Solver::approximate(board)->size());
+    }
+    for (unsigned side : {4u, 5u, 6u, 7u, 10u, 31u}) {
+        for (int i = 0; i < 5; ++i) {
+            const auto board = generator.solvable(side);
+            const auto moves = Solver::approximate(board);
+            ASSERT_TRUE(moves.has_value());
+            EXPECT_TRUE(play(board, *moves).is_goal()) << board;
+            EXPECT_GE(moves->size(), board.manhattan());
+        }
+    }
+    const auto goal = Solver::approximate(make_goal(8));
+    ASSERT_TRUE(goal.has_value());
+    EXPECT_TRUE(goal->empty());
+
+    const auto large = generator.solvable(100);
+    const auto moves = Solver::approximate(large);
+    ASSERT_TRUE(moves.has_value());
+    EXPECT_TRUE(play(large, *moves).is_goal());
+
+    const auto easy = generator.walk(4, 20);
+    EXPECT_LE(Solver::solve(easy).moves(), Solver::approximate(easy)->size());
+
+    EXPECT_FALSE(Solver::approximate(make_board(4, {2, 1, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 0})));
+    EXPECT_FALSE(Solver::approximate(make_board(2, {1, 1, 2, 0})));
+}
+
+TEST(SolverTest, repair) {
+    // A board a few random moves away, as an interactive client would send after a solve.
+    std::mt19937 random(50);
+    const auto perturbed = [&](Board board, int moves) {
+        for (int i = 0; i < moves;) {
+            if (auto next = board.moved(static_cast<Move>(random() % 4))) {
+                board = std::move(*next);
+                ++i;
+            }
+        }
+        return board;
+    };
+
+    Generator generator(50);
+    std::size_t cold     = 0;
+    std::size_t repaired = 0;
+    for (int i = 0; i < 6; ++i) {
+        const auto start    = *generator.at_least(4, 30);
+        const auto previous = Solver::solve(start);
+        const auto board    = perturbed(start, 3);
+        const auto expected = Solver::solve(board);
+
+        // By default the nearest board of the old path is joined, which the lower bound it found
+        // keeps within twice the distance of the optimum.
+        const auto solution = Solver::repair(previous, board);
+        ASSERT_TRUE(solution.stats().repaired) << board;
+        EXPECT_EQ(board, *solution.begin());
+        EXPECT_TRUE((solution.end() - 1)->is_goal());
+        EXPECT_EQ(solution.moves(), solution.path().size());
+        EXPECT_LE(solution.stats().lower_bound, expected.moves());
+        EXPECT_GE(solution.moves(), expected.moves());
+        EXPECT_LE(solution.moves(), expected.moves() + 6);
+        cold += expected.stats().expanded;
+        repaired += solution.stats().expanded;
+
+        // Without slack the solution is optimal, searched or not, given a search that is: A* may
+        // have to cut its open list on boards this hard.
+        RepairOptions options;
+        options.slack                   = 0;
+        options.solve.deepening_threads = 1;
+        EXPECT_EQ(expected.moves(), Solver::repair(previous, board, options).moves()) << board;
+
+        // Boards of the old path need no search at all.
+        const auto on_path = *(previous.begin() + 5);
+        const auto rest    = Solver::repair(previous, on_path, options);
+        EXPECT_TRUE(rest.stats().repaired);
+        EXPECT_EQ(previous.moves() - 5, rest.moves());
+        EXPECT_EQ(0u, rest.stats().expanded);
+    }
+    EXPECT_LT(repaired * 100, cold);
+
+    // Nothing to reuse for a board of another size.
+    const auto small = *generator.at_least(3, 20);
+    const auto other = Solver::repair(Solver::solve(*generator.at_least(4, 20)), small);
+    EXPECT_FALSE(other.stats().repaired);
+    EXPECT_EQ(Solver::solve(small).moves(), other.moves());
+
+    // A previous solution that is not optimal never reaches a shared cache: one that comes to a
+    // board with two optimal first moves by the one its solution does not take.
+    std::vector<Board> path;
+    while (path.empty()) {
+        const auto rest = Solver::solve(*generator.at_least(4, 20));
+        for (auto move : {Move::up, Move::down, Move::left, Move::right}) {
+            const auto shortcut = rest.begin()->moved(move);
+            if (path.empty() && shortcut && *shortcut != *(rest.begin() + 1) &&
+                Solver::solve(*shortcut).moves() + 1 == rest.moves()) {
+                path.push_back(*shortcut);
+                path.insert(path.end(), rest.begin(), rest.end());
+            }
+        }
+    }
+    SolutionCache cache(1 << 20);
+    RepairOptions options;
+    options.window      = 0;
+    options.solve.cache = &cache;
+    auto board          = perturbed(path.front(), 3);
+    while (std::find(path.begin(), path.end(), board) != path.end()) {
+        board = perturbed(board, 1);
+    }
+    const auto searched = Solver::repair(decltype(Solver::solve(board))(path), board, options);
+    EXPECT_FALSE(searched.stats().repaired);
+    EXPECT_EQ(board, *searched.begin());
+    EXPECT_TRUE((searched.end() - 1)->is_goal());
+    for (const auto& on_path : path) {
+        if (const auto cached = cache.solution(on_path)) {
+            EXPECT_EQ(Solver::solve(on_path).moves() + 1, cached->size()) << on_path;
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#include <algorithm>
+#include <filesystem>
+#include <numeric>
+
+#include "gtest/gtest.h"
+#include "puzzle/Generator.hpp"
+#include "puzzle/Solver.hpp"
+#include "puzzle/StateSpace.hpp"
+
+namespace {
+
+// Boards of the 8-puzzle at each distance from the goal.
+const std::vector<uint64_t> eight_puzzle = {1,     2,     4,     8,     16,    20,    39,    62,    116,   152,   286,
+                                            396,   748,   1024,  1893,  2512,  4485,  5638,  9529,  10878, 16993, 17110,
+                                            23952, 20224, 24047, 15578, 14560, 6274,  3910,  760,   221,   2};
+
+}  // anonymous namespace
+
+TEST(StateSpaceTest, counts) {
+    EXPECT_EQ(std::vector<uint64_t>({1, 2, 2, 2, 2, 2, 1}), StateSpace::enumerate(2));
+    EXPECT_EQ(eight_puzzle, StateSpace::enumerate(3));
+    EXPECT_EQ(181440u, std::accumulate(eight_puzzle.begin(), eight_puzzle.end(), uint64_t{0}));
+    EXPECT_EQ(362880u, StateSpace::ranks(3));
+
+    EXPECT_FALSE(StateSpace::enumerate(1).has_value());
+    EXPECT_FALSE(StateSpace::enumerate(5).has_value());
+}
+
+TEST(StateSpaceTest, on_disk) {
+    // Far too little memory for the bitmap, so the levels go to disk in many runs each.
+    StateSpace::Options options;
+    options.memory_bytes = 1 << 16;
+    options.scratch      = std::filesystem::temp_directory_path().string();
+
+    std::vector<uint8_t> depths(StateSpace::ranks(3), 0xFF);
+    bool sorted          = true;
+    const auto collected = StateSpace::enumerate(3, options, [&](unsigned depth, std::span<const uint64_t> ranks) {
+        sorted = sorted && std::is_sorted(ranks.begin(), ranks.end());
+        for (auto rank : ranks) {
+            EXPECT_EQ(0xFF, depths[rank]);
+            depths[rank] = static_cast<uint8_t>(depth);
+        }
+    });
+    EXPECT_EQ(eight_puzzle, collected);
+    EXPECT_TRUE(sorted);
+
+    // The depths are optimal solution lengths.
+    Generator generator(37);
+    for (int i = 0; i < 20; ++i) {
+        const auto board = generator.solvable(3);
+        EXPECT_EQ(Solver::solve(board).moves(), depths[board.rank()]);
+    }
+    EXPECT_EQ(0xFF, depths[Board(std::vector<std::vector<unsigned>>{{2, 1, 3}, {4, 5, 6}, {7, 8, 0}}).rank()]);
+
+    options.scratch = "/nonexistent/directory";
+    EXPECT_FALSE(StateSpace::enumerate(3, options, {}).has_value());
+}
@@ -0,0 +1,122 @@
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "puzzle/Generator.hpp"
+#include "puzzle/Solver.hpp"
+#include "puzzle/TranspositionTable.hpp"
+
+TEST(TranspositionTableTest, visit) {
+    EXPECT_FALSE(TranspositionTable::supports(Board::create_goal(1)));
+    EXPECT_TRUE(TranspositionTable::supports(Board::create_goal(4)));
+    EXPECT_FALSE(TranspositionTable::supports(Board::create_goal(5)));
+
+    TranspositionTable table(1 << 16);
+    Generator generator(41);
+    const auto board = generator.solvable(4);
+    EXPECT_TRUE(table.visit(board, 10, 40));
+    EXPECT_FALSE(table.visit(board, 10, 40));
+    EXPECT_FALSE(table.visit(board, 12, 40));
+    // Fewer moves leave more of the bound to search with, and so does a new bound.
+    EXPECT_TRUE(table.visit(board, 8, 40));
+    EXPECT_FALSE(table.visit(board, 9, 40));
+    EXPECT_TRUE(table.visit(board, 9, 42));
+    EXPECT_TRUE(table.visit(board.transposed(), 9, 42));
+
+    // Boards too large to rank are never skipped.
+    const auto large = generator.solvable(5);
+    EXPECT_TRUE(table.visit(large, 1, 40));
+    EXPECT_TRUE(table.visit(large, 1, 40));
+
+    table.clear();
+    EXPECT_TRUE(table.visit(board, 10, 40));
+}
+
+TEST(TranspositionTableTest, bounded) {
+    TranspositionTable table(1024);
+    EXPECT_EQ(1024u, table.memory());
+    EXPECT_EQ(128u, table.capacity());
+
+    // Once the table is full, boards with little of the bound left no longer displace those
+    // with much left, which also makes visits with one move more a lookup that changes nothing.
+    Generator generator(42);
+    std::vector<Board> deep;
+    for (int i = 0; i < 1000; ++i) {
+        deep.push_back(generator.solvable(4));
+        EXPECT_TRUE(table.visit(deep.back(), 2, 50));
+    }
+    std::size_t kept = 0;
+    for (const auto& board : deep) {
+        kept += table.visit(board, 3, 50) ? 0 : 1;
+    }
+    for (int i = 0; i < 1000; ++i) {
+        const auto shallow = generator.solvable(4);
+        EXPECT_TRUE(table.visit(shallow, 48, 50));
+    }
+    std::size_t still = 0;
+    for (const auto& board : deep) {
+        still += table.visit(board, 3, 50) ? 0 : 1;
+    }
+    EXPECT_GT(kept, 0u);
+    EXPECT_LE(kept, table.capacity());
+    EXPECT_EQ(kept, still);
+}
+
+TEST(TranspositionTableTest, parallel) {
+    TranspositionTable table(1 << 20);
+    Generator generator(43);
+    std::vector<Board> boards;
+    for (int i = 0; i < 1000; ++i) {
+        boards.push_back(generator.solvable(4));
+    }
+
+    // Every board is let through exactly once, however the threads interleave.
+    std::vector<std::thread> threads;
+    std::vector<std::size_t> passed(4);
+    for (std::size_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t]() {
+            for (const auto& board : boards) {
+                passed[t] += table.visit(board, 20, 60) ? 1 : 0;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_GE(passed[0] + passed[1] + passed[2] + passed[3], boards.size());
+    for (const auto& board : boards) {
+        EXPECT_FALSE(table.visit(board, 20, 60));
+    }
+}
+
+TEST(TranspositionTableTest, solver) {
+    Generator generator(44);
+    for (unsigned threads : {1u, 4u}) {
+        SolveOptions options;
+        options.deepening_threads = threads;
+        for (int i = 0; i < 10; ++i) {
+            const auto board    = *generator.at_least(i < 5 ? 3 : 4, 20);
+            const auto expected = Solver::solve(board);
+            const auto solution = Solver::solve(board, options);
+            ASSERT_EQ(expected.moves(), solution.moves()) << board;
+            EXPECT_EQ(board, *solution.begin());
+            EXPECT_TRUE((solution.end() - 1)->is_goal());
+            const auto path = solution.path();
+            EXPECT_EQ(solution.moves(), path.size());
+            EXPECT_GT(solution.stats().expanded, 0u);
+        }
+    }
+
+    SolveOptions options;
+    options.deepening_threads = 2;
+    options.linear_conflict   = true;
+    const auto five           = generator.walk(5, 30);
+    EXPECT_EQ(Solver::solve(five).moves(), Solver::solve(five, options).moves());
+
+    // The threads count expanded boards in batches, so a budget is checked at the end of one.
+    options.linear_conflict = false;
+    options.node_budget     = 1000;
+    const auto hard         = *generator.at_least(4, 40);
+    const auto stopped      = Solver::solve(hard, options);
+    EXPECT_TRUE(stopped.stats().budget_exhausted);
+    EXPECT_EQ(stopped.begin(), stopped.end());
+}
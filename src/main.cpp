@@ -1,13 +1,258 @@
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
 
-#include "puzzle/Solver.hpp"
+#include "puzzle/BatchSolver.hpp"
+#include "puzzle/TextFormat.hpp"
 
-int main() {
-    std::cout << sizeof(unsigned) << " " << sizeof(uint16_t) << '\n';
-    const auto board    = Board::create_random(4);
-    const auto solution = Solver::solve(board);
-    std::cout << solution.moves() << std::endl;
-    for (const auto& move : solution) {
-        std::cout << move << std::endl;
+namespace {
+
+using Detail = TextFormat::Detail;
+
+struct Arguments {
+    std::string input;
+    std::string output;
+    bool binary_output          = false;
+    Detail detail               = Detail::moves;
+    std::size_t cache_megabytes = 0;
+    std::string table;
+    unsigned perimeter = 0;
+    std::vector<std::string> patterns;
+    std::string engine         = "astar";
+    unsigned threads_per_board = 1;
+    BatchSolver::Options batch;
+};
+
+const char* const usage =
+    "Usage: main [options]\n"
+    "Solves boards read one per line (tiles in row-major order, 0 for the blank), or from a\n"
+    "binary corpus file.\n"
+    "\n"
+    "  -i, --input FILE       read boards from FILE instead of stdin; corpus files are detected\n"
+    "  -o, --output FILE      write results to FILE instead of stdout\n"
+    "      --format FORMAT    'text' (default) or 'binary' for a corpus file with solutions,\n"
+    "                         which needs --output and boards of a single size\n"
+    "  -j, --threads N        worker threads (default: one per hardware thread)\n"
+    "      --order ORDER      'input' (default) or 'completion'\n"
+    "      --detail DETAIL    'count', 'moves' (default) or 'boards'\n"
+    "      --node-budget N    give up on a board after N expanded nodes\n"
+    "      --time-budget MS   give up on a board after MS milliseconds\n"
+    "      --over-budget WHAT 'attempt' (default), 'refuse' or 'approximate' boards predicted\n"
+    "                         to expand more than the node budget\n"
+    "      --cache MB         share a solution cache of MB megabytes between boards\n"
+    "      --table FILE       solve 3x3 boards from an exact distance table in FILE, built\n"
+    "                         and saved there on first use\n"
+    "      --perimeter DEPTH  stop 4x4 searches at the boards within DEPTH moves of the goal,\n"
+    "                         found on start\n"
+    "      --heuristic NAME   'manhattan' (default) or 'linear-conflict'\n"
+    "      --patterns FILE    also take the estimate of the pattern database in FILE, for\n"
+    "                         boards of its size; may be given twice\n"
+    "      --engine NAME      'astar' (default), 'epea' (partial expansion), 'bfhs'\n"
+    "                         (breadth-first), 'ida' (iterative deepening) or 'distributed'\n"
+    "      --threads-per-board N\n"
+    "                         threads of 'ida' or worker processes of 'distributed' (default 1);\n"
+    "                         'distributed' forks them only with '-j 1' and otherwise runs as 'ida'\n"
+    "      --lookups KIND     further pattern database lookups of 'ida': 'regular' (default),\n"
+    "                         'reflected', 'dual', 'both' or 'random'\n"
+    "      --pathmax          propagate estimates between boards in 'ida' (BPMX)\n"
+    "  -h, --help             show this help\n"
+    "\n"
+    "Each result line starts with the board index and the number of moves, or with 'invalid',\n"
+    "'unsolvable' or 'budget'. With 'moves' the blank moves follow as U/D/L/R; with 'boards'\n"
+    "every board of the solution follows on its own line.\n";
+
+bool parse_arguments(int argc, char** argv, Arguments& arguments) {
+    for (int i = 1; i < argc; i++) {
+        const std::string flag = argv[i];
+        if (flag == "-h" || flag == "--help") {
+            std::cout << usage;
+            std::exit(0);
+        }
+        if (flag == "--pathmax") {
+            arguments.batch.solve.pathmax = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value or unknown option: " << flag << '\n';
+            return false;
+        }
+        const std::string value = argv[++i];
+        try {
+            if (flag == "-i" || flag == "--input") {
+                arguments.input = value;
+            } else if (flag == "-o" || flag == "--output") {
+                arguments.output = value;
+            } else if (flag == "-j" || flag == "--threads") {
+                arguments.batch.threads = static_cast<unsigned>(std::stoul(value));
+            } else if (flag == "--format" && (value == "text" || value == "binary")) {
+                arguments.binary_output = value == "binary";
+            } else if (flag == "--order" && (value == "input" || value == "completion")) {
+                arguments.batch.order = value == "input" ? BatchSolver::Order::input : BatchSolver::Order::completion;
+            } else if (flag == "--detail" && value == "count") {
+                arguments.detail = Detail::count;
+            } else if (flag == "--detail" && value == "moves") {
+                arguments.detail = Detail::moves;
+            } else if (flag == "--detail" && value == "boards") {
+                arguments.detail = Detail::boards;
+            } else if (flag == "--node-budget") {
+                arguments.batch.solve.node_budget = std::stoull(value);
+            } else if (flag == "--over-budget" && value == "attempt") {
+                arguments.batch.over_budget = BatchSolver::OverBudget::attempt;
+            } else if (flag == "--over-budget" && value == "refuse") {
+                arguments.batch.over_budget = BatchSolver::OverBudget::refuse;
+            } else if (flag == "--over-budget" && value == "approximate") {
+                arguments.batch.over_budget = BatchSolver::OverBudget::approximate;
+            } else if (flag == "--time-budget") {
+                arguments.batch.solve.time_budget = std::chrono::milliseconds(std::stoull(value));
+            } else if (flag == "--cache") {
+                arguments.cache_megabytes = std::stoull(value);
+            } else if (flag == "--table") {
+                arguments.table = value;
+            } else if (flag == "--perimeter") {
+                arguments.perimeter = static_cast<unsigned>(std::stoul(value));
+            } else if (flag == "--heuristic" && (value == "manhattan" || value == "linear-conflict")) {
+                arguments.batch.solve.linear_conflict = value == "linear-conflict";
+            } else if (flag == "--patterns" && arguments.patterns.size() < 2) {
+                arguments.patterns.push_back(value);
+            } else if (flag == "--engine") {
+                arguments.engine = value;
+            } else if (flag == "--threads-per-board") {
+                arguments.threads_per_board = static_cast<unsigned>(std::stoul(value));
+            } else if (flag == "--lookups" && TextFormat::parse_lookups(value)) {
+                arguments.batch.solve.lookups = *TextFormat::parse_lookups(value);
+            } else {
+                std::cerr << "Unknown option or value: " << flag << ' ' << value << '\n';
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Bad value for " << flag << ": " << value << '\n';
+            return false;
+        }
+    }
+    if (not TextFormat::parse_engine(arguments.engine, arguments.threads_per_board, arguments.batch.solve)) {
+        std::cerr << "Unknown engine: " << arguments.engine << '\n';
+        return false;
+    }
+    return true;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv) {
+    Arguments arguments;
+    if (not parse_arguments(argc, argv, arguments)) {
+        std::cerr << usage;
+        return 2;
+    }
+
+    if (arguments.binary_output && arguments.output.empty()) {
+        std::cerr << "Binary output needs --output\n";
+        return 2;
+    }
+
+    std::ios::sync_with_stdio(false);
+    std::optional<CorpusReader> corpus;
+    if (not arguments.input.empty() && CorpusReader::is_corpus(arguments.input)) {
+        corpus = CorpusReader::open(arguments.input);
+        if (not corpus) {
+            std::cerr << "Cannot read corpus " << arguments.input << '\n';
+            return 1;
+        }
+    }
+    std::ifstream input_file;
+    if (not arguments.input.empty() && not corpus) {
+        input_file.open(arguments.input);
+        if (not input_file) {
+            std::cerr << "Cannot open " << arguments.input << '\n';
+            return 1;
+        }
+    }
+    std::ofstream output_file;
+    if (not arguments.output.empty() && not arguments.binary_output) {
+        output_file.open(arguments.output);
+        if (not output_file) {
+            std::cerr << "Cannot open " << arguments.output << '\n';
+            return 1;
+        }
+    }
+    std::istream& input  = arguments.input.empty() ? std::cin : input_file;
+    std::ostream& output = arguments.output.empty() ? std::cout : output_file;
+
+    std::unique_ptr<SolutionCache> cache;
+    if (arguments.cache_megabytes > 0) {
+        cache                       = std::make_unique<SolutionCache>(arguments.cache_megabytes << 20);
+        arguments.batch.solve.cache = cache.get();
+    }
+    std::optional<DistanceTable> table;
+    if (not arguments.table.empty()) {
+        table                           = DistanceTable::load_or_build(arguments.table, 3);
+        arguments.batch.solve.distances = table ? &*table : nullptr;
+    }
+    std::optional<Perimeter> perimeter;
+    if (arguments.perimeter > 0) {
+        perimeter                       = Perimeter::build(4, arguments.perimeter);
+        arguments.batch.solve.perimeter = perimeter ? &*perimeter : nullptr;
+    }
+    std::vector<PatternDatabase> databases;
+    for (const auto& path : arguments.patterns) {
+        auto database = PatternDatabase::load(path);
+        if (not database) {
+            std::cerr << "Cannot load pattern database " << path << '\n';
+            return EXIT_FAILURE;
+        }
+        databases.push_back(std::move(*database));
+    }
+    for (std::size_t i = 0; i < databases.size(); i++) {
+        arguments.batch.solve.patterns[i] = &databases[i];
+    }
+
+    // The corpus is created with the size of the first valid board, so text input can feed it too.
+    std::optional<CorpusWriter> writer;
+    bool written = true;
+    const auto write_record = [&](std::size_t index, const Board& board, const BatchSolver::Solution& solution) {
+        if (not board.validate()) {
+            std::cerr << "Skipping invalid board " << index << '\n';
+            return;
+        }
+        if (not writer) {
+            writer = CorpusWriter::open(arguments.output, static_cast<unsigned>(board.size()), true);
+        }
+        if (not writer || not writer->write(BatchSolver::record(board, solution))) {
+            std::cerr << "Cannot write board " << index << " to " << arguments.output << '\n';
+            written = false;
+        }
+    };
+
+    const auto sink = [&](std::size_t index, const Board& board, const BatchSolver::Solution& solution) {
+        if (arguments.binary_output) {
+            write_record(index, board, solution);
+        } else {
+            output << TextFormat::format_result(std::to_string(index), board, solution, arguments.detail);
+        }
+    };
+    std::string line;
+    if (corpus) {
+        BatchSolver::run(*corpus, sink, arguments.batch);
+    } else {
+        BatchSolver::run(
+            [&]() -> std::optional<Board> {
+                while (std::getline(input, line)) {
+                    if (line.find_first_not_of(" \t\r") != std::string::npos) {
+                        return TextFormat::parse_board(line);
+                    }
+                }
+                return {};
+            },
+            sink, arguments.batch);
+    }
+
+    if (arguments.binary_output) {
+        return written && (not writer || writer->flush()) ? 0 : 1;
     }
-}
\ No newline at end of file
+    output.flush();
+    return output ? 0 : 1;
+}
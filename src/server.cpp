@@ -0,0 +1,176 @@
+#include <pthread.h>
+
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "puzzle/Server.hpp"
+#include "puzzle/TextFormat.hpp"
+
+namespace {
+
+const char* const usage =
+    "Usage: server [options]\n"
+    "Answers solve requests on a Unix domain socket or a localhost TCP port until interrupted.\n"
+    "\n"
+    "      --socket PATH      listen on the Unix domain socket PATH\n"
+    "      --port N           listen on 127.0.0.1:N (default: a free port, printed on start)\n"
+    "  -j, --threads N        worker threads (default: one per hardware thread)\n"
+    "      --queue N          requests waiting for a worker before clients are throttled\n"
+    "      --node-budget N    default and largest limit of expanded nodes per request\n"
+    "      --time-budget MS   default and largest limit of milliseconds per request\n"
+    "      --cache MB         share a solution cache of MB megabytes between requests\n"
+    "      --table FILE       solve 3x3 boards from an exact distance table in FILE, built\n"
+    "                         and saved there on first use\n"
+    "      --perimeter DEPTH  stop 4x4 searches at the boards within DEPTH moves of the goal,\n"
+    "                         found on start\n"
+    "      --heuristic NAME   'manhattan' (default) or 'linear-conflict'\n"
+    "      --patterns FILE    also take the estimate of the pattern database in FILE, for\n"
+    "                         boards of its size; may be given twice\n"
+    "      --engine NAME      'astar' (default), 'epea' (partial expansion), 'bfhs'\n"
+    "                         (breadth-first), 'ida' (iterative deepening) or 'distributed'\n"
+    "      --threads-per-board N\n"
+    "                         threads of 'ida' or worker processes of 'distributed' (default 1);\n"
+    "                         'distributed' runs as 'ida' here, as workers cannot be forked\n"
+    "                         from the threads of the server\n"
+    "      --lookups KIND     further pattern database lookups of 'ida': 'regular' (default),\n"
+    "                         'reflected', 'dual', 'both' or 'random'\n"
+    "      --pathmax          propagate estimates between boards in 'ida' (BPMX)\n"
+    "  -h, --help             show this help\n"
+    "\n"
+    "A request is a line '<id> [nodes=N] [ms=N] <tiles>'; the answer is '<id> <moves> <UDLR...>',\n"
+    "or '<id>' followed by 'invalid', 'unsolvable' or 'budget'. Answers may come out of order.\n";
+
+bool parse_arguments(int argc, char** argv, Server::Options& options, std::string& table, unsigned& perimeter,
+                     std::vector<std::string>& patterns) {
+    std::string engine         = "astar";
+    unsigned threads_per_board = 1;
+    for (int i = 1; i < argc; i++) {
+        const std::string flag = argv[i];
+        if (flag == "-h" || flag == "--help") {
+            std::cout << usage;
+            std::exit(0);
+        }
+        if (flag == "--pathmax") {
+            options.solve.pathmax = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value or unknown option: " << flag << '\n';
+            return false;
+        }
+        const std::string value = argv[++i];
+        try {
+            if (flag == "--socket") {
+                options.socket_path = value;
+            } else if (flag == "--port") {
+                options.port = static_cast<uint16_t>(std::stoul(value));
+            } else if (flag == "-j" || flag == "--threads") {
+                options.threads = static_cast<unsigned>(std::stoul(value));
+            } else if (flag == "--queue") {
+                options.queue = std::max<std::size_t>(std::stoull(value), 1);
+            } else if (flag == "--node-budget") {
+                options.solve.node_budget = std::stoull(value);
+            } else if (flag == "--time-budget") {
+                options.solve.time_budget = std::chrono::milliseconds(std::stoull(value));
+            } else if (flag == "--cache") {
+                options.cache_bytes = std::stoull(value) << 20;
+            } else if (flag == "--table") {
+                table = value;
+            } else if (flag == "--perimeter") {
+                perimeter = static_cast<unsigned>(std::stoul(value));
+            } else if (flag == "--heuristic" && (value == "manhattan" || value == "linear-conflict")) {
+                options.solve.linear_conflict = value == "linear-conflict";
+            } else if (flag == "--patterns" && patterns.size() < 2) {
+                patterns.push_back(value);
+            } else if (flag == "--engine") {
+                engine = value;
+            } else if (flag == "--threads-per-board") {
+                threads_per_board = static_cast<unsigned>(std::stoul(value));
+            } else if (flag == "--lookups" && TextFormat::parse_lookups(value)) {
+                options.solve.lookups = *TextFormat::parse_lookups(value);
+            } else {
+                std::cerr << "Unknown option: " << flag << '\n';
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Bad value for " << flag << ": " << value << '\n';
+            return false;
+        }
+    }
+    if (not TextFormat::parse_engine(engine, threads_per_board, options.solve)) {
+        std::cerr << "Unknown engine: " << engine << '\n';
+        return false;
+    }
+    return true;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv) {
+    Server::Options options;
+    std::string table_path;
+    unsigned perimeter_depth = 0;
+    std::vector<std::string> pattern_paths;
+    if (not parse_arguments(argc, argv, options, table_path, perimeter_depth, pattern_paths)) {
+        std::cerr << usage;
+        return 2;
+    }
+    // Built once per deployment; later starts just map the file.
+    std::optional<DistanceTable> table;
+    if (not table_path.empty()) {
+        table                   = DistanceTable::load_or_build(table_path, 3);
+        options.solve.distances = table ? &*table : nullptr;
+    }
+    // Shared read-only by every request.
+    std::optional<Perimeter> perimeter;
+    if (perimeter_depth > 0) {
+        perimeter               = Perimeter::build(4, perimeter_depth);
+        options.solve.perimeter = perimeter ? &*perimeter : nullptr;
+    }
+    std::vector<PatternDatabase> databases;
+    for (const auto& path : pattern_paths) {
+        auto database = PatternDatabase::load(path);
+        if (not database) {
+            std::cerr << "Cannot load pattern database " << path << '\n';
+            return EXIT_FAILURE;
+        }
+        databases.push_back(std::move(*database));
+    }
+    for (std::size_t i = 0; i < databases.size(); i++) {
+        options.solve.patterns[i] = &databases[i];
+    }
+
+    // Every thread started from here on leaves SIGINT and SIGTERM to `sigwait` below.
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    Server server(options);
+    if (not server.listen()) {
+        std::cerr << "Cannot listen on "
+                  << (options.socket_path.empty() ? "port " + std::to_string(options.port) : options.socket_path)
+                  << '\n';
+        return 1;
+    }
+    std::cerr << "Listening on "
+              << (options.socket_path.empty() ? "127.0.0.1:" + std::to_string(server.port()) : options.socket_path)
+              << std::endl;
+
+    std::thread waiter([&]() {
+        int signal = 0;
+        sigwait(&signals, &signal);
+        server.stop();
+    });
+    server.serve();
+    // `serve` also returns when accepting fails; let the waiter go in that case.
+    pthread_kill(waiter.native_handle(), SIGTERM);
+    waiter.join();
+    return 0;
+}